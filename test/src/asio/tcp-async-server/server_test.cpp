@@ -64,6 +64,14 @@ main(int argc, char* argv[])
   #if defined(READ_HANDLER_FUNCTION)
     // Free function read handler -------------------------------
     utl::io::tcp::server server(13, read_handler);
+  #elif defined(READ_HANDLER_BUFFER)
+    // In-place read handler, no allocation per message -------
+    utl::io::tcp::server server(13, 4096,
+        [](asio::const_buffer const& buf, utl::io::tcp::connection_ptr con)
+        {
+          std::cout.write(asio::buffer_cast<char const*>(buf),
+                          asio::buffer_size(buf));
+        });
   #elif defined(READ_HANDLER_CLASS)
     // Class method read handler --------------------------------
     ReadHandler handler;
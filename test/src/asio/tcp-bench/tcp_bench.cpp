@@ -0,0 +1,483 @@
+//===========================================================================//
+//  Nathan Lucas
+//  2018
+//===========================================================================//
+//
+//  Loopback benchmark and soak test for utl::io::tcp.
+//
+//  Starts a server that echoes length-prefixed messages and a number of
+//  clients, each keeping a window of messages in flight.  Each message
+//  carries the time it was sent, so every echo yields a round trip time.
+//
+//  Benchmark:  for each message size and connection count, reports
+//  messages per second, payload MB/s, and round trip percentiles.
+//
+//  Soak test (--soak):  runs the first size and connection count for the
+//  given number of seconds, reporting the message rate and the resident
+//  set size of the process at each interval.  Exits with status 2 if the
+//  resident set grows by more than --max-rss-growth MB.
+//
+//    asio-tcp-bench [--sizes 64,1024,16384] [--connections 1,8,32]
+//                   [--seconds 2] [--window 16] [--threads 1]
+//                   [--soak seconds] [--interval 1] [--max-rss-growth mb]
+//                   [--csv file] [--json file]
+//
+//===========================================================================//
+
+#include <utl/asio/tcp/client.hpp>    // utl::io::tcp::client
+#include <utl/asio/tcp/framing.hpp>   // utl::io::tcp::framed,
+                                      // utl::io::tcp::length_framer
+#include <utl/asio/tcp/server.hpp>    // utl::io::tcp::server
+#include <utl/chrono/chrono_latency.hpp>  // utl::chrono::latency_histogram
+#include <utl/json.hpp>               // utl::json::json
+
+#include <asio.hpp>   // Asio library
+
+#include <atomic>     // std::atomic
+#include <chrono>     // std::chrono::steady_clock
+#include <cstdint>    // std::int64_t, std::uint32_t, std::uint64_t
+#include <cstdlib>    // std::atof, std::atoi, std::strtoul
+#include <cstring>    // std::memcpy
+#include <fstream>    // std::ifstream, std::ofstream
+#include <iomanip>    // std::setw
+#include <iostream>   // std::cout, std::cerr, std::endl
+#include <memory>     // std::unique_ptr
+#include <sstream>    // std::istringstream
+#include <string>     // std::string
+#include <thread>     // std::thread
+#include <vector>     // std::vector
+
+#if defined(__linux__)
+#include <unistd.h>   // sysconf
+#endif
+
+namespace {   //-------------------------------------------------------------
+
+namespace tcp = utl::io::tcp;
+
+using clock = std::chrono::steady_clock;
+using framer = tcp::length_framer<std::uint32_t>;
+using histogram = utl::chrono::latency_histogram<>;
+
+struct options
+{
+  std::vector<std::size_t> sizes        = { 64, 1024, 16384 };
+  std::vector<std::size_t> connections  = { 1, 8, 32 };
+  double      seconds         = 2.0;
+  unsigned    window          = 16;
+  std::size_t threads         = 1;
+  double      soak            = 0.0;
+  double      interval        = 1.0;
+  double      max_rss_growth  = 0.0;
+  std::string csv;
+  std::string json;
+};
+
+// Result of one benchmark run or soak interval.
+struct result
+{
+  std::string mode;
+  std::size_t size;
+  std::size_t connections;
+  double      seconds;
+  double      messages_per_s;
+  double      mb_per_s;
+  double      rss_mb;
+  histogram   latency;
+};
+
+// Returns the resident set size of this process in MB.
+double
+rss_mb()
+{
+#if defined(__linux__)
+  std::ifstream statm("/proc/self/statm");
+  double pages = 0;
+  double resident = 0;
+  statm >> pages >> resident;
+  return ((resident * ::sysconf(_SC_PAGESIZE)) / (1024.0 * 1024.0));
+#else
+  return 0.0;
+#endif
+}
+
+// One client:  echoes each reply with a new message, and records the
+// round trip time of each reply while measuring.
+class bench_client
+{
+public:
+  bench_client(unsigned short port, std::size_t size,
+               std::atomic<bool> const& running,
+               std::atomic<bool> const& measuring)
+  : size_(size)
+  , running_(running)
+  , measuring_(measuring)
+  , messages_(0)
+  , client_("127.0.0.1", std::to_string(port),
+        tcp::client::default_buffer_size,
+        tcp::framed(framer(size),
+            [this](asio::const_buffer const& frame) { on_reply(frame); }))
+  , thread_([this]() { client_.run(); })
+  {}
+
+  ~bench_client()
+  {
+    stop();
+  }
+
+  // Stops the client and waits for its thread.
+  void
+  stop()
+  {
+    if (thread_.joinable())
+    {
+      client_.stop();
+      thread_.join();
+    }
+  }
+
+  void
+  send()
+  {
+    std::string msg(framer::header_size + size_, '\0');
+    framer::put_header(&msg[0], static_cast<std::uint32_t>(size_));
+    std::int64_t const now = clock::now().time_since_epoch().count();
+    std::memcpy(&msg[framer::header_size], &now, sizeof(now));
+    client_.write(tcp::make_shared_buffer(std::move(msg)));
+  }
+
+  std::uint64_t messages() const  { return messages_.load(); }
+
+  // Valid once the client has been stopped.
+  histogram const& latency() const  { return latency_; }
+
+private:
+  void
+  on_reply(asio::const_buffer const& frame)
+  {
+    if (measuring_.load(std::memory_order_relaxed))
+    {
+      std::int64_t sent;
+      std::memcpy(&sent, asio::buffer_cast<char const*>(frame), sizeof(sent));
+      latency_.add(clock::now().time_since_epoch()
+                   - clock::duration(sent));
+      messages_.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (running_.load(std::memory_order_relaxed))
+    {
+      send();
+    }
+  }
+
+  std::size_t                 size_;
+  std::atomic<bool> const&    running_;
+  std::atomic<bool> const&    measuring_;
+  std::atomic<std::uint64_t>  messages_;
+  histogram                   latency_;
+  tcp::client                 client_;
+  std::thread                 thread_;
+};
+
+// Server and clients for one configuration.
+class bench
+{
+public:
+  bench(options const& opt, std::size_t size, std::size_t connections,
+        unsigned short port)
+  : running_(true)
+  , measuring_(false)
+  , server_(port, tcp::connection::default_buffer_size,
+        tcp::framed(framer(size),
+            [](asio::const_buffer const& frame, tcp::connection_ptr con)
+            {
+              std::size_t const n = asio::buffer_size(frame);
+              std::string reply(framer::header_size + n, '\0');
+              framer::put_header(&reply[0], static_cast<std::uint32_t>(n));
+              std::memcpy(&reply[framer::header_size],
+                          asio::buffer_cast<char const*>(frame), n);
+              con->write(tcp::make_shared_buffer(std::move(reply)));
+            }),
+        opt.threads)
+  , server_thread_([this]() { server_.run(); })
+  {
+    for (std::size_t i = 0; i != connections; ++i)
+    {
+      clients_.emplace_back(
+          new bench_client(port, size, running_, measuring_));
+    }
+    auto const deadline = clock::now() + std::chrono::seconds(5);
+    while ((server_.connection_count() != connections) &&
+           (clock::now() < deadline))
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    for (auto& c : clients_)
+    {
+      for (unsigned i = 0; i != opt.window; ++i) { c->send(); }
+    }
+    // Warm up before measuring.
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    measuring_.store(true);
+  }
+
+  ~bench()
+  {
+    finish();
+    server_.stop();
+    server_thread_.join();
+  }
+
+  // Returns messages received by all clients while measuring.
+  std::uint64_t
+  messages() const
+  {
+    std::uint64_t n = 0;
+    for (auto const& c : clients_) { n += c->messages(); }
+    return n;
+  }
+
+  // Stops the clients and returns their merged round trip times.
+  histogram
+  finish()
+  {
+    running_.store(false);
+    measuring_.store(false);
+    histogram h;
+    for (auto& c : clients_)
+    {
+      c->stop();
+      h.merge(c->latency());
+    }
+    return h;
+  }
+
+private:
+  std::atomic<bool>                         running_;
+  std::atomic<bool>                         measuring_;
+  tcp::server                               server_;
+  std::thread                               server_thread_;
+  std::vector<std::unique_ptr<bench_client>> clients_;
+};
+
+// Runs one configuration for opt.seconds.
+result
+run_bench(options const& opt, std::size_t size, std::size_t connections,
+          unsigned short port)
+{
+  bench b(opt, size, connections, port);
+  auto const start = clock::now();
+  std::uint64_t const first = b.messages();
+  std::this_thread::sleep_for(std::chrono::duration<double>(opt.seconds));
+  std::uint64_t const last = b.messages();
+  double const elapsed = std::chrono::duration<double>(
+      clock::now() - start).count();
+
+  result r;
+  r.mode = "bench";
+  r.size = size;
+  r.connections = connections;
+  r.seconds = elapsed;
+  r.messages_per_s = (last - first) / elapsed;
+  r.mb_per_s = (r.messages_per_s * size) / (1024.0 * 1024.0);
+  r.latency = b.finish();
+  r.rss_mb = rss_mb();
+  return r;
+}
+
+// Runs the first configuration for opt.soak seconds, with one result
+// per interval.  Each interval reports the round trip times of the
+// whole run so far.
+std::vector<result>
+run_soak(options const& opt, unsigned short port)
+{
+  std::vector<result> results;
+  std::size_t const size = opt.sizes.front();
+  std::size_t const connections = opt.connections.front();
+  bench b(opt, size, connections, port);
+
+  auto const start = clock::now();
+  auto last_time = start;
+  std::uint64_t last = b.messages();
+  while (std::chrono::duration<double>(last_time - start).count() < opt.soak)
+  {
+    std::this_thread::sleep_for(std::chrono::duration<double>(opt.interval));
+    auto const now = clock::now();
+    std::uint64_t const messages = b.messages();
+    double const elapsed = std::chrono::duration<double>(
+        now - last_time).count();
+
+    result r;
+    r.mode = "soak";
+    r.size = size;
+    r.connections = connections;
+    r.seconds = std::chrono::duration<double>(now - start).count();
+    r.messages_per_s = (messages - last) / elapsed;
+    r.mb_per_s = (r.messages_per_s * size) / (1024.0 * 1024.0);
+    r.rss_mb = rss_mb();
+    results.push_back(r);
+
+    std::cout << std::setw(8) << std::fixed << std::setprecision(0)
+              << r.seconds << " s"
+              << std::setw(12) << r.messages_per_s << " msg/s"
+              << std::setw(10) << std::setprecision(1) << r.rss_mb << " MB"
+              << std::endl;
+    last = messages;
+    last_time = now;
+  }
+  results.back().latency = b.finish();
+  return results;
+}
+
+void
+print(result const& r)
+{
+  std::cout << std::setw(7) << r.size
+            << std::setw(7) << r.connections
+            << std::setw(12) << std::fixed << std::setprecision(0)
+            << r.messages_per_s
+            << std::setw(10) << std::setprecision(1) << r.mb_per_s
+            << "   " << r.latency << std::endl;
+}
+
+void
+write_csv(std::string const& path, std::vector<result> const& results)
+{
+  std::ofstream os(path);
+  os << "mode,size,connections,seconds,msg_per_s,mb_per_s,rss_mb,"
+     << utl::chrono::csv_latency_header() << '\n';
+  for (auto const& r : results)
+  {
+    os << r.mode << ',' << r.size << ',' << r.connections << ','
+       << r.seconds << ',' << r.messages_per_s << ',' << r.mb_per_s << ','
+       << r.rss_mb << ',' << utl::chrono::csv(r.latency) << '\n';
+  }
+}
+
+void
+write_json(std::string const& path, std::vector<result> const& results)
+{
+  using utl::json::json;
+  auto us = [](histogram::duration d)
+  {
+    return std::chrono::duration<double, std::micro>(d).count();
+  };
+  json j = json::array();
+  for (auto const& r : results)
+  {
+    json latency = {
+      { "n",        r.latency.count() },
+      { "p50_us",   us(r.latency.quantile(0.5)) },
+      { "p90_us",   us(r.latency.quantile(0.9)) },
+      { "p99_us",   us(r.latency.quantile(0.99)) },
+      { "p999_us",  us(r.latency.quantile(0.999)) },
+      { "max_us",   us(r.latency.max()) }
+    };
+    j.push_back({
+      { "mode",         r.mode },
+      { "size",         r.size },
+      { "connections",  r.connections },
+      { "seconds",      r.seconds },
+      { "msg_per_s",    r.messages_per_s },
+      { "mb_per_s",     r.mb_per_s },
+      { "rss_mb",       r.rss_mb },
+      { "latency",      latency }
+    });
+  }
+  std::ofstream(path) << j.dump(2) << '\n';
+}
+
+// Parses a comma-separated list of sizes, each at least min_size.
+std::vector<std::size_t>
+parse_list(std::string const& str, std::size_t min_size = 1)
+{
+  std::vector<std::size_t> list;
+  std::istringstream is(str);
+  std::string item;
+  while (std::getline(is, item, ','))
+  {
+    std::size_t n = std::strtoul(item.c_str(), nullptr, 10);
+    list.push_back((n < min_size) ? min_size : n);
+  }
+  return list;
+}
+
+bool
+parse(int argc, char* argv[], options& opt)
+{
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string const arg = argv[i];
+    if (i + 1 == argc)
+    {
+      std::cerr << "missing value for " << arg << std::endl;
+      return false;
+    }
+    std::string const val = argv[++i];
+    if      (arg == "--sizes")          { opt.sizes = parse_list(val, sizeof(std::int64_t)); }
+    else if (arg == "--connections")    { opt.connections = parse_list(val); }
+    else if (arg == "--seconds")        { opt.seconds = std::atof(val.c_str()); }
+    else if (arg == "--window")         { opt.window = std::atoi(val.c_str()); }
+    else if (arg == "--threads")        { opt.threads = std::atoi(val.c_str()); }
+    else if (arg == "--soak")           { opt.soak = std::atof(val.c_str()); }
+    else if (arg == "--interval")       { opt.interval = std::atof(val.c_str()); }
+    else if (arg == "--max-rss-growth") { opt.max_rss_growth = std::atof(val.c_str()); }
+    else if (arg == "--csv")            { opt.csv = val; }
+    else if (arg == "--json")           { opt.json = val; }
+    else
+    {
+      std::cerr << "unknown option " << arg << std::endl;
+      return false;
+    }
+  }
+  return (!opt.sizes.empty() && !opt.connections.empty());
+}
+
+} // anonymous --------------------------------------------------------------
+
+int
+main(int argc, char* argv[])
+{
+  options opt;
+  if (!parse(argc, argv, opt))
+  {
+    return 1;
+  }
+
+  int status = 0;
+  std::vector<result> results;
+  unsigned short port = 15700;
+  if (opt.soak > 0)
+  {
+    std::cout << "soak:  " << opt.sizes.front() << " bytes, "
+              << opt.connections.front() << " connections, "
+              << opt.soak << " s\n" << std::endl;
+    results = run_soak(opt, port);
+    double const growth = results.back().rss_mb - results.front().rss_mb;
+    std::cout << "\nRSS growth:  " << growth << " MB\n"
+              << results.back().latency << std::endl;
+    if ((opt.max_rss_growth > 0) && (growth > opt.max_rss_growth))
+    {
+      std::cout << "FAIL:  RSS grew more than " << opt.max_rss_growth
+                << " MB" << std::endl;
+      status = 2;
+    }
+  }
+  else
+  {
+    std::cout << "   size  conns       msg/s      MB/s   round trip\n";
+    for (std::size_t size : opt.sizes)
+    {
+      for (std::size_t connections : opt.connections)
+      {
+        results.push_back(run_bench(opt, size, connections, port++));
+        print(results.back());
+      }
+    }
+  }
+
+  if (!opt.csv.empty())   { write_csv(opt.csv, results); }
+  if (!opt.json.empty())  { write_json(opt.json, results); }
+  return status;
+}
+
+//===========================================================================//
@@ -0,0 +1,105 @@
+//===========================================================================//
+//  Nathan Lucas
+//  2018
+//===========================================================================//
+
+#include <utl/asio/tcp/buffer.hpp>    // utl::io::tcp::write_queue
+
+#include <asio.hpp>   // Asio library
+
+#include <iostream>   // std::cout, std::endl
+#include <string>     // std::string
+
+#include "utl_test.hpp"  // utl_test::test_label
+
+namespace {   //-------------------------------------------------------------
+
+namespace tcp = utl::io::tcp;
+
+void
+print(tcp::write_queue const& q)
+{
+  tcp::write_stats s = q.stats();
+  std::cout << "  queued " << s.queued_messages << " msg " << s.queued_bytes
+            << " B,  peak " << s.peak_bytes
+            << " B,  dropped " << s.dropped_messages << " msg "
+            << s.dropped_bytes << " B,  "
+            << (s.congested ? "congested" : "clear") << '\n';
+}
+
+// Queues n 100-byte messages.
+bool
+fill(tcp::write_queue& q, unsigned n)
+{
+  bool ok = true;
+  for (unsigned i = 0; i != n; ++i)
+  {
+    ok = q.push(tcp::make_shared_buffer(std::string(100, 'a' + (i % 26))))
+         && ok;
+  }
+  return ok;
+}
+
+void
+test_policy(int& n, char const* name, tcp::slow_consumer policy)
+{
+  utl_test::test_label(n, name);
+  tcp::write_queue q(tcp::write_limits(1000, 500, policy));
+
+  // Two messages are being sent; they are never dropped.
+  fill(q, 2);
+  std::cout << "gathered " << q.gather().size() << " messages\n";
+  bool ok = fill(q, 12);
+  std::cout << "push 12 more:  " << (ok ? "accepted" : "refused") << '\n';
+  print(q);
+
+  if (policy == tcp::slow_consumer::keep_latest)
+  {
+    // While congested, each push replaces the unsent message.
+    std::size_t most = 0;
+    for (unsigned i = 0; i != 5; ++i)
+    {
+      fill(q, 1);
+      std::size_t const unsent = q.stats().queued_messages - 2;
+      if (unsent > most) { most = unsent; }
+    }
+    std::cout << "most unsent while congested:  " << most << " (expect 1)\n";
+  }
+
+  q.pop_sent();
+  std::cout << "after sending the gathered messages:\n";
+  print(q);
+  std::cout << "next write starts with '"
+            << *asio::buffer_cast<char const*>(q.gather()[0]) << "'\n";
+  q.pop_sent();
+  print(q);
+}
+
+void
+test_unbounded(int& n)
+{
+  utl_test::test_label(n, "utl::io::tcp::write_queue, no limits");
+  tcp::write_queue q;
+  fill(q, 100);
+  std::cout << "gathered " << q.gather().size() << " of 100 messages\n";
+  q.pop_sent();
+  print(q);
+}
+
+} // anonymous --------------------------------------------------------------
+
+int
+main()
+{
+  int n = 0;
+  test_unbounded(n);
+  test_policy(n, "utl::io::tcp::slow_consumer::drop_oldest",
+              tcp::slow_consumer::drop_oldest);
+  test_policy(n, "utl::io::tcp::slow_consumer::keep_latest",
+              tcp::slow_consumer::keep_latest);
+  test_policy(n, "utl::io::tcp::slow_consumer::disconnect",
+              tcp::slow_consumer::disconnect);
+  return 0;
+}
+
+//===========================================================================//
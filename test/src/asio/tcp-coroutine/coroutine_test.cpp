@@ -0,0 +1,301 @@
+//===========================================================================//
+//  Nathan Lucas
+//  2018
+//===========================================================================//
+//
+//  Tests utl::io::tcp::task and utl::io::tcp::co_connection.
+//  Requires C++20 coroutines.
+//
+//===========================================================================//
+
+#include <utl/asio/tcp/coroutine.hpp>   // utl::io::tcp::co_connection,
+                                        // utl::io::tcp::spawn,
+                                        // utl::io::tcp::task
+
+#include <asio.hpp>   // Asio library
+
+#include <atomic>     // std::atomic
+#include <cstddef>    // std::size_t
+#include <cstdint>    // std::uint32_t
+#include <cstdlib>    // std::free, std::malloc
+#include <cstring>    // std::memcpy
+#include <iostream>   // std::cout, std::endl
+#include <new>        // std::bad_alloc
+#include <stdexcept>  // std::length_error, std::runtime_error
+#include <string>     // std::string
+
+#include "utl_test.hpp"  // utl_test::test_label
+
+#if !defined(UTL_IO_HAS_COROUTINES)
+#error requires C++20 coroutines
+#endif
+
+// Counts heap allocations.
+std::atomic<std::size_t> allocations(0);
+
+#if defined(__GNUC__) && (__GNUC__ >= 11) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void*
+operator new(std::size_t size)
+{
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size ? size : 1)) { return p; }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept                { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept   { std::free(p); }
+
+namespace {   //-------------------------------------------------------------
+
+namespace tcp = utl::io::tcp;
+
+using framer = tcp::length_framer<std::uint32_t>;
+using connection = tcp::co_connection<framer>;
+
+constexpr unsigned short port = 15800;
+
+//---------------------------------------------------------------------------
+
+tcp::task<int>
+answer()
+{
+  co_return 21;
+}
+
+tcp::task<int>
+twice()
+{
+  int const a = co_await answer();
+  co_return (a * 2);
+}
+
+tcp::task<>
+fail()
+{
+  throw std::runtime_error("fail");
+  co_return;
+}
+
+tcp::task<>
+get_results(int& value, bool& caught)
+{
+  value = co_await twice();
+  try
+  {
+    co_await fail();
+  }
+  catch (std::runtime_error const&)
+  {
+    caught = true;
+  }
+}
+
+void
+test_task(int& n)
+{
+  utl_test::test_label(n, "utl::io::tcp::task");
+
+  asio::io_service ios;
+  int value = 0;
+  bool caught = false;
+  tcp::spawn(ios, get_results(value, caught));
+  ios.run();
+  std::cout << "value returned:             " << value << '\n'
+            << "exception rethrown:         " << (caught ? "pass" : "FAIL")
+            << '\n';
+
+  // An exception that escapes a spawned task leaves io_service::run().
+  ios.restart();
+  tcp::spawn(ios, fail());
+  bool escaped = false;
+  try
+  {
+    ios.run();
+  }
+  catch (std::runtime_error const&)
+  {
+    escaped = true;
+  }
+  std::cout << "exception out of run():     " << (escaped ? "pass" : "FAIL")
+            << std::endl;
+}
+
+//---------------------------------------------------------------------------
+
+// Echoes each frame back to the client until the client disconnects.
+tcp::task<>
+echo(connection con, std::string& error)
+{
+  std::string reply;
+  try
+  {
+    for (;;)
+    {
+      asio::const_buffer const frame = co_await con.read_frame();
+      std::size_t const size = asio::buffer_size(frame);
+      reply.resize(framer::header_size + size);
+      framer::put_header(&reply[0], static_cast<std::uint32_t>(size));
+      std::memcpy(&reply[framer::header_size],
+                  asio::buffer_cast<char const*>(frame), size);
+      co_await con.write(asio::buffer(reply));
+    }
+  }
+  catch (std::exception const& e)
+  {
+    error = e.what();
+  }
+}
+
+// Accepts clients and starts an echo session for each.
+tcp::task<>
+serve(asio::io_service& ios, asio::ip::tcp::acceptor& acceptor,
+      std::size_t clients, std::string& error)
+{
+  for (std::size_t i = 0; i != clients; ++i)
+  {
+    connection con(ios, framer(1024));
+    co_await con.accept(acceptor);
+    tcp::spawn(ios, echo(std::move(con), error));
+  }
+}
+
+struct client_result
+{
+  std::size_t round_trips = 0;
+  bool        in_order    = true;
+  std::size_t allocations = 0;    // after warmup
+};
+
+// Sends numbered messages one at a time and checks each echo.
+tcp::task<>
+ping(asio::io_service& ios, std::size_t count, std::size_t warmup,
+     client_result& result)
+{
+  connection con(ios, framer(1024));
+  co_await con.connect("127.0.0.1", std::to_string(port));
+
+  std::string msg(framer::header_size + 64, 'x');
+  framer::put_header(&msg[0], 64);
+  std::size_t start = 0;
+  for (std::size_t i = 0; i != (warmup + count); ++i)
+  {
+    if (i == warmup) { start = allocations.load(); }
+    std::memcpy(&msg[framer::header_size], &i, sizeof(i));
+    co_await con.write(asio::buffer(msg));
+    asio::const_buffer const frame = co_await con.read_frame();
+    std::size_t echoed;
+    std::memcpy(&echoed, asio::buffer_cast<char const*>(frame),
+                sizeof(echoed));
+    if ((echoed != i) || (asio::buffer_size(frame) != 64))
+    {
+      result.in_order = false;
+    }
+    ++result.round_trips;
+  }
+  result.allocations = allocations.load() - start;
+  con.close();
+}
+
+void
+test_echo(int& n)
+{
+  utl_test::test_label(n, "utl::io::tcp::co_connection");
+
+  asio::io_service ios;
+  asio::ip::tcp::acceptor acceptor(ios,
+      asio::ip::tcp::endpoint(asio::ip::tcp::v4(), port));
+
+  std::string server_error;
+  client_result a;
+  client_result b;
+  std::size_t const count = 10000;
+  tcp::spawn(ios, serve(ios, acceptor, 2, server_error));
+  tcp::spawn(ios, ping(ios, count, 1000, a));
+  tcp::spawn(ios, ping(ios, count, 1000, b));
+  ios.run();
+
+  std::cout << "round trips:                "
+            << (a.round_trips + b.round_trips) << '\n'
+            << "echoes in order:            "
+            << ((a.in_order && b.in_order) ? "pass" : "FAIL") << '\n'
+            << "allocations per round trip: "
+            << (double(a.allocations + b.allocations) / (2 * count)) << '\n'
+            << "server stopped by:          " << server_error << std::endl;
+}
+
+//---------------------------------------------------------------------------
+
+// Sends a frame over the server's maximum size.
+tcp::task<>
+oversize(asio::io_service& ios, unsigned short to)
+{
+  connection con(ios, framer());
+  co_await con.connect(asio::ip::tcp::endpoint(
+      asio::ip::address_v4::loopback(), to));
+  std::string msg(framer::header_size + 2048, 'y');
+  framer::put_header(&msg[0], 2048);
+  co_await con.write(msg);
+  try
+  {
+    co_await con.read_frame();
+  }
+  catch (asio::system_error const&)
+  {
+  }
+}
+
+tcp::task<>
+refuse(asio::io_service& ios, unsigned short to, bool& refused)
+{
+  connection con(ios);
+  try
+  {
+    co_await con.connect("127.0.0.1", std::to_string(to));
+  }
+  catch (asio::system_error const& e)
+  {
+    refused = (e.code() == asio::error::connection_refused);
+  }
+}
+
+void
+test_errors(int& n)
+{
+  utl_test::test_label(n, "utl::io::tcp::co_connection errors");
+
+  asio::io_service ios;
+  asio::ip::tcp::acceptor acceptor(ios,
+      asio::ip::tcp::endpoint(asio::ip::tcp::v4(), port + 1));
+
+  // A frame over the maximum size ends the session.
+  std::string server_error;
+  tcp::spawn(ios, serve(ios, acceptor, 1, server_error));
+  tcp::spawn(ios, oversize(ios, port + 1));
+
+  // Nothing listens on the next port.
+  bool refused = false;
+  tcp::spawn(ios, refuse(ios, port + 2, refused));
+  ios.run();
+
+  std::cout << "oversized frame:            "
+            << (server_error.empty() ? "FAIL" : server_error) << '\n'
+            << "connection refused:         " << (refused ? "pass" : "FAIL")
+            << std::endl;
+}
+
+} // anonymous --------------------------------------------------------------
+
+int
+main()
+{
+  int n = 0;
+  test_task(n);
+  test_echo(n);
+  test_errors(n);
+  return 0;
+}
+
+//===========================================================================//
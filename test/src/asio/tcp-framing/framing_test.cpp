@@ -0,0 +1,224 @@
+//===========================================================================//
+//  Nathan Lucas
+//  2018
+//===========================================================================//
+
+#include <utl/asio/tcp/framing.hpp>   // utl::io::tcp::frame_reader
+#include <utl/asio/tcp/message.hpp>   // utl::io::tcp::encode_frame,
+                                      // utl::io::tcp::decode_frame
+
+#include <asio.hpp>   // Asio library
+
+#include <cstdint>    // std::uint16_t, std::uint32_t
+#include <iostream>   // std::cout, std::endl
+#include <stdexcept>  // std::length_error
+#include <string>     // std::string
+#include <vector>     // std::vector
+
+#include "utl_test.hpp"  // utl_test::test_label
+
+namespace {   //-------------------------------------------------------------
+
+namespace tcp = utl::io::tcp;
+
+// Feeds stream to a reader in chunks of the specified size
+// and returns the frames received.
+template<typename Framer>
+std::vector<std::string>
+feed(tcp::frame_reader<Framer>& reader, std::string const& stream,
+     std::size_t chunk, bool& ok)
+{
+  std::vector<std::string> frames;
+  ok = true;
+  for (std::size_t i = 0; ok && (i < stream.size()); i += chunk)
+  {
+    std::size_t n = ((stream.size() - i) < chunk) ? (stream.size() - i) : chunk;
+    ok = reader.read(stream.data() + i, n,
+        [&frames](asio::const_buffer const& frame)
+        {
+          char const* p = asio::buffer_cast<char const*>(frame);
+          frames.push_back(std::string(p, p + asio::buffer_size(frame)));
+        });
+  }
+  return frames;
+}
+
+// Checks that every chunk size yields the expected frames.
+template<typename Framer>
+bool
+check(Framer const& framer, std::string const& stream,
+      std::vector<std::string> const& expected)
+{
+  bool pass = true;
+  for (std::size_t chunk = 1; chunk <= stream.size(); ++chunk)
+  {
+    tcp::frame_reader<Framer> reader(framer);
+    bool ok;
+    if ((feed(reader, stream, chunk, ok) != expected) || !ok ||
+        (reader.buffered() != 0))
+    {
+      pass = false;
+    }
+  }
+  return pass;
+}
+
+// Returns payloads preceded by length prefixes.
+template<typename Framer>
+std::string
+length_frames(std::vector<std::string> const& payloads)
+{
+  std::string stream;
+  for (auto const& p : payloads)
+  {
+    char header[Framer::header_size];
+    Framer::put_header(header,
+                       static_cast<typename Framer::length_type>(p.size()));
+    stream.append(header, Framer::header_size);
+    stream += p;
+  }
+  return stream;
+}
+
+void
+test_delimited(int& n)
+{
+  utl_test::test_label(n, "utl::io::tcp::delimited_framer");
+
+  std::vector<std::string> lines = { "alpha", "", "beta gamma", "delta" };
+  std::string stream;
+  for (auto const& s : lines) { stream += s + '\n'; }
+
+  std::cout << "frames, every chunk size:   "
+            << (check(tcp::delimited_framer(), stream, lines) ? "pass" : "FAIL")
+            << '\n';
+
+  tcp::frame_reader<tcp::delimited_framer> reader(tcp::delimited_framer(8));
+  bool ok;
+  feed(reader, "12345678\n", 4, ok);
+  std::cout << "frame at maximum size:      " << (ok ? "pass" : "FAIL") << '\n';
+  feed(reader, "123456789\n", 4, ok);
+  std::cout << "frame over maximum size:    " << (!ok ? "pass" : "FAIL") << '\n';
+  std::cout << "buffered after overflow:    " << reader.buffered() << '\n';
+
+  // Once a partial frame is finished, the rest of a read is not copied.
+  tcp::frame_reader<tcp::delimited_framer> split_reader;
+  std::string const first = "ab", second = "c\nde\nfg\nh";
+  std::size_t in_place = 0;
+  auto count = [&](asio::const_buffer const& frame)
+      {
+        char const* p = asio::buffer_cast<char const*>(frame);
+        if ((p >= second.data()) && (p < second.data() + second.size()))
+        {
+          ++in_place;
+        }
+      };
+  split_reader.read(first.data(), first.size(), count);
+  split_reader.read(second.data(), second.size(), count);
+  std::cout << "frames parsed in place:     " << in_place << " (expect 2)\n"
+            << "buffered after split:       " << split_reader.buffered()
+            << std::endl;
+}
+
+void
+test_length(int& n)
+{
+  utl_test::test_label(n, "utl::io::tcp::length_framer");
+
+  std::vector<std::string> payloads =
+      { "one", "", std::string(300, 'x'), "four" };
+
+  typedef tcp::length_framer<std::uint16_t>                         u16_be;
+  typedef tcp::length_framer<std::uint16_t, tcp::byte_order::little> u16_le;
+  typedef tcp::length_framer<std::uint32_t>                         u32_be;
+  typedef tcp::length_framer<std::uint32_t, tcp::byte_order::little> u32_le;
+
+  std::string s = length_frames<u16_be>(payloads);
+  std::cout << "u16 big endian header:      "
+            << std::hex << int(static_cast<unsigned char>(s[7])) << ' '
+            << int(static_cast<unsigned char>(s[8])) << std::dec << '\n';
+  std::cout << "u16 big endian:             "
+            << (check(u16_be(), s, payloads) ? "pass" : "FAIL") << '\n';
+  std::cout << "u16 little endian:          "
+            << (check(u16_le(), length_frames<u16_le>(payloads), payloads)
+                ? "pass" : "FAIL") << '\n';
+  std::cout << "u32 big endian:             "
+            << (check(u32_be(), length_frames<u32_be>(payloads), payloads)
+                ? "pass" : "FAIL") << '\n';
+  std::cout << "u32 little endian:          "
+            << (check(u32_le(), length_frames<u32_le>(payloads), payloads)
+                ? "pass" : "FAIL") << '\n';
+
+  // A length over the maximum is rejected as soon as the header arrives.
+  tcp::frame_reader<u32_be> reader(u32_be(256));
+  bool ok;
+  feed(reader, length_frames<u32_be>({ std::string(257, 'y') }).substr(0, 4),
+       1, ok);
+  std::cout << "frame over maximum size:    " << (!ok ? "pass" : "FAIL")
+            << std::endl;
+}
+
+void
+test_fixed(int& n)
+{
+  utl_test::test_label(n, "utl::io::tcp::fixed_framer");
+
+  std::cout << "frames, every chunk size:   "
+            << (check(tcp::fixed_framer(3), "abcdefghi",
+                      { "abc", "def", "ghi" }) ? "pass" : "FAIL") << '\n';
+
+  tcp::frame_reader<tcp::fixed_framer> reader(tcp::fixed_framer(4));
+  bool ok;
+  feed(reader, "abcdef", 6, ok);
+  std::cout << "partial frame buffered:     " << reader.buffered() << std::endl;
+}
+
+void
+test_message(int& n)
+{
+  utl_test::test_label(n, "utl::io::tcp::encode_frame");
+
+  typedef tcp::length_framer<std::uint16_t> u16_be;
+  std::vector<std::string> const message = { "alpha", std::string(200, 'b') };
+  tcp::shared_buffer const buf = tcp::encode_frame<u16_be>(message);
+
+  // The frame reader delivers the payload, which decodes in place.
+  tcp::frame_reader<u16_be> reader;
+  std::vector<std::string> decoded;
+  bool ok = false;
+  reader.read(buf->data(), buf->size(),
+      [&](asio::const_buffer const& frame)
+      {
+        ok = tcp::decode_frame(frame, decoded);
+      });
+  std::cout << "frame size:                 " << buf->size() << '\n'
+            << "decoded:                    "
+            << ((ok && (decoded == message)) ? "pass" : "FAIL") << '\n';
+
+  bool threw = false;
+  try
+  {
+    tcp::encode_frame<tcp::length_framer<std::uint8_t>>(std::string(300, 'c'));
+  }
+  catch (std::length_error const&)
+  {
+    threw = true;
+  }
+  std::cout << "oversized message throws:   " << (threw ? "pass" : "FAIL")
+            << std::endl;
+}
+
+} // anonymous --------------------------------------------------------------
+
+int
+main()
+{
+  int n = 0;
+  test_delimited(n);
+  test_length(n);
+  test_fixed(n);
+  test_message(n);
+  return 0;
+}
+
+//===========================================================================//
@@ -0,0 +1,138 @@
+//===========================================================================//
+//  Nathan Lucas
+//  2018
+//===========================================================================//
+//
+//  Loopback load test for utl::io::tcp::server.
+//
+//  Each client keeps a window of short messages in flight, and sends a
+//  new message for every echo it receives.  The server is run with an
+//  increasing number of threads and reports messages handled per second.
+//
+//    asio-tcp-load [clients] [seconds] [max_threads]
+//
+//===========================================================================//
+
+#include <utl/asio/tcp/client.hpp>    // utl::io::tcp::client
+#include <utl/asio/tcp/framing.hpp>   // utl::io::tcp::framed
+#include <utl/asio/tcp/server.hpp>    // utl::io::tcp::server
+
+#include <asio.hpp>   // Asio library
+
+#include <atomic>     // std::atomic
+#include <chrono>     // std::chrono::steady_clock
+#include <cstdint>    // std::uint64_t
+#include <cstdlib>    // std::atof, std::atoi
+#include <iomanip>    // std::setw
+#include <iostream>   // std::cout, std::endl
+#include <memory>     // std::unique_ptr
+#include <string>     // std::string
+#include <thread>     // std::thread
+#include <vector>     // std::vector
+
+namespace {   //-------------------------------------------------------------
+
+namespace tcp = utl::io::tcp;
+
+constexpr unsigned window = 16;   // messages in flight per client
+
+// Returns messages per second handled by a server with the specified
+// number of threads.
+double
+run_load(std::size_t threads, std::size_t clients, double seconds,
+         unsigned short port)
+{
+  std::atomic<std::uint64_t> handled(0);
+
+  // Echo each line back to its sender.
+  tcp::server server(port, tcp::connection::default_buffer_size,
+      tcp::framed(tcp::delimited_framer(),
+          [&handled](asio::const_buffer const& frame, tcp::connection_ptr con)
+          {
+            char const* p = asio::buffer_cast<char const*>(frame);
+            con->write(std::string(p, p + asio::buffer_size(frame)) + '\n');
+            handled.fetch_add(1, std::memory_order_relaxed);
+          }),
+      threads);
+  std::thread server_thread([&server]() { server.run(); });
+
+  // Reply to each echo with another message.
+  std::string const message = "0123456789abcdef\n";
+  tcp::shared_buffer const shared = tcp::make_shared_buffer(message);
+  std::vector<std::unique_ptr<tcp::client>> pool(clients);
+  std::vector<std::thread> client_threads;
+  for (auto& c : pool)
+  {
+    std::unique_ptr<tcp::client>* self = &c;
+    c.reset(new tcp::client("127.0.0.1", std::to_string(port),
+        tcp::client::default_buffer_size,
+        tcp::framed(tcp::delimited_framer(),
+            [self, shared](asio::const_buffer const&)
+            {
+              (*self)->write(shared);
+            })));
+    tcp::client* client = c.get();
+    client_threads.emplace_back([client]() { client->run(); });
+  }
+
+  // Wait for every client to connect, then start the windows.
+  auto const deadline = std::chrono::steady_clock::now()
+                      + std::chrono::seconds(5);
+  while ((server.connection_count() != clients) &&
+         (std::chrono::steady_clock::now() < deadline))
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  for (auto& c : pool)
+  {
+    for (unsigned i = 0; i != window; ++i) { c->write(shared); }
+  }
+
+  // Measure after a short warmup.
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  std::uint64_t const first = handled.load();
+  auto const start = std::chrono::steady_clock::now();
+  std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+  std::uint64_t const last = handled.load();
+  double const elapsed = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+
+  for (auto& c : pool) { c->stop(); }
+  for (auto& t : client_threads) { t.join(); }
+  server.stop();
+  server_thread.join();
+
+  return ((last - first) / elapsed);
+}
+
+} // anonymous --------------------------------------------------------------
+
+int
+main(int argc, char* argv[])
+{
+  std::size_t const clients = (argc > 1) ? std::atoi(argv[1]) : 32;
+  double const seconds = (argc > 2) ? std::atof(argv[2]) : 2.0;
+  unsigned const cores = std::thread::hardware_concurrency();
+  std::size_t const max_threads = (argc > 3) ? std::atoi(argv[3])
+                                             : ((cores < 1) ? 1 : cores);
+
+  std::cout << "clients:  " << clients << '\n'
+            << "window:   " << window << '\n'
+            << "cores:    " << cores << "\n\n"
+            << "threads      msg/s    speedup\n";
+
+  double base = 0;
+  unsigned short port = 15500;
+  for (std::size_t threads = 1; threads <= max_threads; threads *= 2)
+  {
+    double rate = run_load(threads, clients, seconds, port++);
+    if (threads == 1) { base = rate; }
+    std::cout << std::setw(7) << threads
+              << std::setw(11) << static_cast<long long>(rate)
+              << std::setw(10) << std::fixed << std::setprecision(2)
+              << (rate / base) << std::endl;
+  }
+  return 0;
+}
+
+//===========================================================================//
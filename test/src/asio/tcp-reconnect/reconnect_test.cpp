@@ -0,0 +1,146 @@
+//===========================================================================//
+//  Nathan Lucas
+//  2018
+//===========================================================================//
+//
+//  Reconnect schedule of utl::io::tcp::client against a loopback port
+//  that refuses connections, and against a server that accepts and then
+//  drops each connection.
+//
+//===========================================================================//
+
+#include <utl/asio/tcp/client.hpp>    // utl::io::tcp::client
+
+#include <asio.hpp>   // Asio library
+
+#include <chrono>     // std::chrono
+#include <iostream>   // std::cout, std::endl
+#include <thread>     // std::thread
+#include <vector>     // std::vector
+
+#include "utl_test.hpp"  // utl_test::test_label
+
+namespace {   //-------------------------------------------------------------
+
+namespace tcp = utl::io::tcp;
+
+using clock_type = std::chrono::steady_clock;
+
+// Returns milliseconds from a to b.
+long long
+ms(clock_type::time_point a, clock_type::time_point b)
+{
+  return std::chrono::duration_cast<std::chrono::milliseconds>(b - a).count();
+}
+
+char const*
+name(tcp::client_state state)
+{
+  switch (state)
+  {
+    case tcp::client_state::connecting:   return "connecting";
+    case tcp::client_state::connected:    return "connected";
+    case tcp::client_state::disconnected: return "disconnected";
+  }
+  return "?";
+}
+
+void
+print(tcp::client_counters const& c)
+{
+  std::cout << "connects " << c.connects << ",  reconnects " << c.reconnects
+            << ",  failed attempts " << c.failed_attempts << '\n';
+}
+
+void
+test_refused(int& n)
+{
+  utl_test::test_label(n, "utl::io::tcp::client, connection refused");
+
+  // Nothing listens on the port, so every attempt fails at once.
+  tcp::client client("127.0.0.1", "15605");
+  tcp::reconnect_policy const policy(std::chrono::milliseconds(20),
+                                     std::chrono::milliseconds(1000),
+                                     2.0, 0.0, 4);
+  client.policy(policy);
+  std::cout << "delays:  ";
+  for (std::size_t i = 1; i != policy.max_attempts; ++i)
+  {
+    std::cout << policy.delay(i, 0.5).count() << " ms  ";
+  }
+  std::cout << "(expect 20 40 80)\n";
+
+  auto const start = clock_type::now();
+  client.on_state([&](tcp::client_state state)
+      {
+        std::cout << "  " << ms(start, clock_type::now()) << " ms  "
+                  << name(state) << '\n';
+        if (state == tcp::client_state::disconnected) { client.stop(); }
+      });
+  client.run();
+
+  long long const elapsed = ms(start, clock_type::now());
+  std::cout << "gave up after " << client.counters().failed_attempts
+            << " failures (expect 4),  at least 140 ms:  "
+            << ((elapsed >= 140) ? "pass" : "FAIL") << '\n';
+  print(client.counters());
+  std::cout << std::flush;
+}
+
+void
+test_dropped(int& n)
+{
+  utl_test::test_label(n, "utl::io::tcp::client, connection dropped");
+
+  // The server closes each connection as soon as it is accepted.
+  asio::io_service ios;
+  asio::ip::tcp::acceptor acceptor(ios,
+      asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), 15606));
+  std::vector<clock_type::time_point> accepted;
+  std::thread server_thread([&]()
+      {
+        for (int i = 0; i != 4; ++i)
+        {
+          asio::ip::tcp::socket socket(ios);
+          acceptor.accept(socket);
+          accepted.push_back(clock_type::now());
+        }
+      });
+
+  tcp::client client("127.0.0.1", "15606");
+  client.policy(tcp::reconnect_policy(std::chrono::milliseconds(20),
+                                      std::chrono::milliseconds(1000),
+                                      2.0, 0.0));
+  std::thread client_thread([&client]() { client.run(); });
+  server_thread.join();
+  client.stop();
+  client_thread.join();
+
+  // Each gap is a backoff delay plus a connect.
+  bool pass = true;
+  long long expect = 20;
+  std::cout << "gaps between connections:  ";
+  for (std::size_t i = 1; i != accepted.size(); ++i, expect *= 2)
+  {
+    long long const gap = ms(accepted[i - 1], accepted[i]);
+    std::cout << gap << " ms  ";
+    pass = pass && (gap >= expect);
+  }
+  std::cout << "(expect at least 20 40 80):  " << (pass ? "pass" : "FAIL")
+            << '\n';
+  print(client.counters());
+  std::cout << std::flush;
+}
+
+} // anonymous --------------------------------------------------------------
+
+int
+main()
+{
+  int n = 0;
+  test_refused(n);
+  test_dropped(n);
+  return 0;
+}
+
+//===========================================================================//
@@ -0,0 +1,407 @@
+//===========================================================================//
+//  Nathan Lucas
+//  2018
+//===========================================================================//
+//
+//  Echo round trips over each transport:  TCP and Unix domain stream
+//  sockets, UDP and Unix domain datagram sockets, and UDP multicast.
+//  Prints the mean round trip time of each.
+//
+//    asio-transports [round_trips]
+//
+//===========================================================================//
+
+#include <utl/asio/local.hpp>         // utl::io::unix_stream,
+                                      // utl::io::unix_dgram
+#include <utl/asio/tcp/client.hpp>    // utl::io::tcp::client
+#include <utl/asio/tcp/framing.hpp>   // utl::io::tcp::framed
+#include <utl/asio/tcp/server.hpp>    // utl::io::tcp::server
+#include <utl/asio/udp.hpp>           // utl::io::udp
+
+#include <asio.hpp>   // Asio library
+
+#include <chrono>     // std::chrono
+#include <condition_variable>   // std::condition_variable
+#include <cstdio>     // std::remove
+#include <cstdlib>    // std::atoi
+#include <fstream>    // std::ifstream, std::ofstream
+#include <iomanip>    // std::setw
+#include <iostream>   // std::cout, std::endl
+#include <mutex>      // std::mutex, std::unique_lock
+#include <stdexcept>  // std::invalid_argument
+#include <string>     // std::string
+#include <thread>     // std::thread
+
+#include "utl_test.hpp"  // utl_test::test_label
+
+namespace {   //-------------------------------------------------------------
+
+namespace io = utl::io;
+namespace tcp = utl::io::tcp;
+
+// Counts replies and wakes the sender after each.
+class replies
+{
+public:
+  replies() : count_(0) {}
+
+  void
+  add()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++count_;
+    cv_.notify_one();
+  }
+
+  // Waits up to one second for at least n replies.
+  bool
+  wait(unsigned n)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cv_.wait_for(lock, std::chrono::seconds(1),
+                        [this, n]() { return count_ >= n; });
+  }
+
+private:
+  std::mutex              mutex_;
+  std::condition_variable cv_;
+  unsigned                count_;
+};
+
+// Runs a server and client, sends messages one at a time, waiting
+// for each reply, and prints the mean round trip time.
+template<typename Server, typename Client>
+void
+ping(char const* name, Server& server, Client& client, replies& r,
+     unsigned round_trips)
+{
+  std::thread server_thread([&server]() { server.run(); });
+  std::thread client_thread([&client]() { client.run(); });
+
+  // Retry the first message until the client has connected.
+  std::string const message = "0123456789abcdef\n";
+  bool ok = false;
+  for (int i = 0; !ok && (i != 5); ++i)
+  {
+    client.write(message);
+    ok = r.wait(1);
+  }
+
+  auto const start = std::chrono::steady_clock::now();
+  for (unsigned n = 2; ok && (n <= round_trips + 1); ++n)
+  {
+    client.write(message);
+    ok = r.wait(n);
+  }
+  double const us = std::chrono::duration<double, std::micro>(
+      std::chrono::steady_clock::now() - start).count();
+
+  std::cout << std::left << std::setw(28) << name << std::right;
+  if (ok)
+  {
+    std::cout << std::setw(8) << std::fixed << std::setprecision(1)
+              << (us / round_trips) << " us" << std::endl;
+  }
+  else
+  {
+    std::cout << "  FAIL" << std::endl;
+  }
+
+  client.stop();
+  client_thread.join();
+  server.stop();
+  server_thread.join();
+}
+
+// Returns a stream server handler that echoes each line.
+tcp::connection::buffer_handler
+echo_lines()
+{
+  return tcp::framed(tcp::delimited_framer(),
+      [](asio::const_buffer const& frame, tcp::connection_ptr con)
+      {
+        char const* p = asio::buffer_cast<char const*>(frame);
+        con->write(std::string(p, p + asio::buffer_size(frame)) + '\n');
+      });
+}
+
+// Returns a stream client handler that counts lines.
+tcp::client::buffer_handler
+count_lines(replies& r)
+{
+  return tcp::framed(tcp::delimited_framer(),
+      [&r](asio::const_buffer const&) { r.add(); });
+}
+
+void
+test_stream(int& n, unsigned round_trips)
+{
+  utl_test::test_label(n, "utl::io::tcp, utl::io::unix_stream");
+  {
+    tcp::server server(15600, tcp::connection::default_buffer_size,
+                       echo_lines());
+    replies r;
+    tcp::client client("127.0.0.1", "15600",
+                       tcp::client::default_buffer_size, count_lines(r));
+    ping("tcp loopback:", server, client, r, round_trips);
+  }
+#if defined(ASIO_HAS_LOCAL_SOCKETS)
+  {
+    io::unix_stream::endpoint ep("/tmp/utl-transport-stream.sock");
+    io::unix_stream::server server(ep, tcp::connection::default_buffer_size,
+                                   echo_lines());
+    replies r;
+    io::unix_stream::client client(ep, tcp::client::default_buffer_size,
+                                   count_lines(r));
+    ping("unix_stream:", server, client, r, round_trips);
+  }
+#endif
+}
+
+void
+test_datagram(int& n, unsigned round_trips)
+{
+  utl_test::test_label(n, "utl::io::udp, utl::io::unix_dgram");
+  {
+    // Echo each datagram to its sender.
+    io::udp::server* self = nullptr;
+    io::udp::server server(15601,
+        [&self](std::string const& msg, io::udp::endpoint const& from)
+        {
+          self->write(msg, from);
+        });
+    self = &server;
+    replies r;
+    io::udp::client client("127.0.0.1", "15601",
+                           [&r](std::string const&) { r.add(); });
+    ping("udp loopback:", server, client, r, round_trips);
+  }
+#if defined(ASIO_HAS_LOCAL_SOCKETS)
+  {
+    io::unix_dgram::server* self = nullptr;
+    io::unix_dgram::server server(
+        io::unix_dgram::endpoint("/tmp/utl-transport-dgram.sock"),
+        [&self](std::string const& msg, io::unix_dgram::endpoint const& from)
+        {
+          self->write(msg, from);
+        });
+    self = &server;
+    // A Unix domain client needs its own path to receive replies.
+    replies r;
+    io::unix_dgram::client client(
+        io::unix_dgram::endpoint("/tmp/utl-transport-dgram.sock"),
+        io::unix_dgram::endpoint("/tmp/utl-transport-dgram-client.sock"),
+        io::datagram::default_buffer_size,
+        [&r](asio::const_buffer const&) { r.add(); });
+    ping("unix_dgram:", server, client, r, round_trips);
+  }
+#endif
+}
+
+#if defined(ASIO_HAS_LOCAL_SOCKETS)
+// Returns true if constructing a server on the path throws.
+template<typename Server>
+bool
+refused(char const* path)
+{
+  try
+  {
+    Server s((typename Server::endpoint_type(path)));
+  }
+  catch (asio::system_error const&)
+  {
+    return true;
+  }
+  return false;
+}
+
+void
+test_socket_path(int& n)
+{
+  utl_test::test_label(n, "Unix domain socket path in use");
+
+  // A file that is not a socket is never removed.
+  char const* const file = "/tmp/utl-transport-file.sock";
+  std::ofstream(file) << "data\n";
+  bool const kept = refused<io::unix_stream::server>(file) &&
+                    refused<io::unix_dgram::server>(file) &&
+                    std::ifstream(file).good();
+  std::remove(file);
+  std::cout << "regular file kept:          " << (kept ? "pass" : "FAIL")
+            << '\n';
+
+  // A socket that is still bound is never removed.
+  char const* const path = "/tmp/utl-transport-live.sock";
+  {
+    io::unix_stream::server live((io::unix_stream::endpoint(path)));
+    std::cout << "live stream socket kept:    "
+              << (refused<io::unix_stream::server>(path) ? "pass" : "FAIL")
+              << '\n';
+  }
+  {
+    io::unix_dgram::server live((io::unix_dgram::endpoint(path)));
+    std::cout << "live datagram socket kept:  "
+              << (refused<io::unix_dgram::server>(path) ? "pass" : "FAIL")
+              << '\n';
+  }
+
+  // The datagram server above left its socket file behind.
+  std::cout << "stale socket replaced:      "
+            << (!refused<io::unix_stream::server>(path) ? "pass" : "FAIL")
+            << std::endl;
+  std::remove(path);
+}
+#endif
+
+void
+test_multicast(int& n, unsigned round_trips)
+{
+  utl_test::test_label(n, "utl::io::udp multicast");
+
+  // The subscriber replies to each publisher by unicast.
+  asio::ip::address const group = asio::ip::address::from_string("239.255.0.1");
+  io::udp::server* self = nullptr;
+  io::udp::server server(15602,
+      [&self](std::string const& msg, io::udp::endpoint const& from)
+      {
+        self->write(msg, from);
+      });
+  self = &server;
+  server.join(group);
+
+  replies r;
+  io::udp::client client(io::udp::endpoint(group, 15602),
+                         [&r](std::string const&) { r.add(); });
+  client.set_option(asio::ip::multicast::hops(0));  // stay on this host
+  ping("udp multicast 239.255.0.1:", server, client, r, round_trips);
+}
+
+void
+test_other_sender(int& n)
+{
+  utl_test::test_label(n, "utl::io::udp::client other senders");
+
+  // A datagram from another socket arrives before the server's reply.
+  asio::ip::address const lo = asio::ip::address_v4::loopback();
+  io::udp::endpoint const local(lo, 15605), remote(lo, 15606);
+  replies r;
+  bool other = false;
+  io::udp::client client(remote, local, io::datagram::default_buffer_size,
+      [&r, &other](asio::const_buffer const& buf)
+      {
+        other |= (asio::buffer_size(buf) != 5);   // not "reply"
+        r.add();
+      });
+  std::thread client_thread([&client]() { client.run(); });
+
+  asio::io_service ios;
+  asio::ip::udp::socket stranger(ios, io::udp::endpoint(lo, 0));
+  asio::ip::udp::socket server(ios, remote);
+  stranger.send_to(asio::buffer(std::string("stranger")), local);
+  server.send_to(asio::buffer(std::string("reply")), local);
+  bool const replied = r.wait(1);
+
+  client.stop();
+  client_thread.join();
+  std::cout << "server reply received:      " << (replied ? "pass" : "FAIL")
+            << '\n'
+            << "other sender dropped:       " << (!other ? "pass" : "FAIL")
+            << std::endl;
+}
+
+void
+test_arguments(int& n)
+{
+  utl_test::test_label(n, "read buffer size 0");
+
+  // An empty read buffer would make every read complete at once.
+  unsigned rejected = 0;
+  try
+  {
+    tcp::client c("127.0.0.1", "15603", 0,
+                  [](asio::const_buffer const&) {});
+  }
+  catch (std::invalid_argument const&) { ++rejected; }
+  try
+  {
+    tcp::server s(15603, 0,
+                  [](asio::const_buffer const&, tcp::connection_ptr) {});
+  }
+  catch (std::invalid_argument const&) { ++rejected; }
+  try
+  {
+    io::udp::server s(io::udp::endpoint(asio::ip::udp::v4(), 15603), 0,
+                      [](asio::const_buffer const&, io::udp::endpoint const&) {});
+  }
+  catch (std::invalid_argument const&) { ++rejected; }
+  std::cout << "rejected:  " << rejected << " of 3" << std::endl;
+}
+
+void
+test_stop(int& n)
+{
+  utl_test::test_label(n, "utl::io::tcp::server::stop");
+  {
+    tcp::server server(15604);
+    server.stop();
+    server.run();
+    std::cout << "run() after stop() returned" << '\n';
+  }
+
+  // Closes queued for connections on every thread are delivered.
+  tcp::server server(15604, tcp::connection::default_buffer_size,
+                     [](asio::const_buffer const&, tcp::connection_ptr) {}, 2);
+  std::thread server_thread([&server]() { server.run(); });
+  asio::io_service ios;
+  asio::ip::tcp::endpoint const ep(asio::ip::address_v4::loopback(), 15604);
+  asio::ip::tcp::socket a(ios), b(ios);
+  a.connect(ep);
+  b.connect(ep);
+  for (int i = 0; (server.connection_count() != 2) && (i != 100); ++i)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  std::cout << "connections before stop:    " << server.connection_count()
+            << '\n';
+  server.stop();
+  server_thread.join();
+
+  unsigned closed = 0;
+  char c;
+  asio::error_code ec;
+  a.read_some(asio::buffer(&c, 1), ec);
+  closed += (ec == asio::error::eof);
+  b.read_some(asio::buffer(&c, 1), ec);
+  closed += (ec == asio::error::eof);
+  std::cout << "connections after stop:     " << server.connection_count()
+            << '\n'
+            << "clients closed:             " << closed << " of 2" << std::endl;
+}
+
+} // anonymous --------------------------------------------------------------
+
+int
+main(int argc, char* argv[])
+{
+  unsigned const round_trips = (argc > 1) ? std::atoi(argv[1]) : 2000;
+  int n = 0;
+  test_arguments(n);
+  test_stop(n);
+#if defined(ASIO_HAS_LOCAL_SOCKETS)
+  test_socket_path(n);
+#endif
+  test_stream(n, round_trips);
+  test_datagram(n, round_trips);
+  test_other_sender(n);
+  try
+  {
+    test_multicast(n, round_trips);
+  }
+  catch (asio::system_error const& e)
+  {
+    std::cout << "multicast unavailable:  " << e.what() << std::endl;
+  }
+  return 0;
+}
+
+//===========================================================================//
@@ -24,9 +24,16 @@ main(int argc, char* argv[])
 
   // time_test_timer.cpp
   utl_test::test_timer(n);            // utl::timer
+  utl_test::test_tsc_timer(n);        // utl::chrono::tsc_timer
   utl_test::test_timer_chrono(n);     // <chrono> timer
   utl_test::test_timer_ctime(n);      // <ctime> timer
 
+  // test_latency.cpp
+  utl_test::test_latency(n);      // utl::chrono::latency_histogram
+
+  // test_pacer.cpp
+  utl_test::test_pacer(n);        // utl::chrono::pacer, rate_limiter
+
   // time_test_timestamp.cpp
   utl_test::test_timestamp(n);    // utl::timestamp::date, datetime, time
 }
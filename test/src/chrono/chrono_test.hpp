@@ -21,9 +21,16 @@ void test_datetime(int& n);     // extract components from time structure
 
 // test_timer.cpp
 void test_timer(int& n);            // utl::Timer
+void test_tsc_timer(int& n);        // utl::chrono::tsc_timer
 void test_timer_chrono(int& n);     // <chrono> timer
 void test_timer_ctime(int& n);      // <ctime> timer
 
+// test_latency.cpp
+void test_latency(int& n);          // utl::chrono::latency_histogram
+
+// test_pacer.cpp
+void test_pacer(int& n);            // utl::chrono::pacer, rate_limiter
+
 // test_timestamp.cpp
 void test_timestamp(int& n);        // utl::timestamp::date, datetime, time
 
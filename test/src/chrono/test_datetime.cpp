@@ -9,6 +9,8 @@
 #include "utl_test.hpp"                   // utl_test::test_label
 #include "chrono_test.hpp"
 
+#include <chrono>       // std::chrono::system_clock
+#include <cstdint>      // std::int64_t, std::uint64_t
 #include <ctime>        // std::tm
 #include <iostream>     // std::cout
 #include <string>       // std::string, std::to_string
@@ -39,6 +41,74 @@ test_datetime(int& n)
     << '\n' << ns << "sec         : " << std::to_string(C::sec(now))
     << '\n' << ns << "is_dst      : " << (C::is_dst(now) ? "true" : "false")
     << '\n' << '\n';
+
+  //-----------------------------------------------------------------
+
+  utl_test::test_label(n, "utl::chrono civil calendar");
+
+  static_assert(C::days_from_civil(1970, 1, 1) == 0, "epoch");
+  static_assert(C::days_from_civil(2000, 3, 1) == 11017, "leap year");
+  static_assert(C::civil_from_days(-1).year == 1969, "before epoch");
+  static_assert(C::civil_from_days(11016).day == 29, "leap day");
+  static_assert(C::weekday_from_days(0) == 4, "Thursday");
+
+  // Documented range:  years within +/-10^16.
+  constexpr std::int64_t Y = 10000000000000000;
+  static_assert(C::civil_from_days(C::days_from_civil(Y, 12, 31)).year == Y,
+                "latest year");
+  static_assert(C::civil_from_days(C::days_from_civil(-Y, 1, 1)).year == -Y,
+                "earliest year");
+
+  // Round trip over +/- one million days.
+  bool round_trip = true;
+  for (std::int64_t z = -1000000; z <= 1000000; ++z)
+  {
+    C::civil_date d = C::civil_from_days(z);
+    round_trip &= (C::days_from_civil(d.year, d.month, d.day) == z);
+  }
+  std::cout << "  days/civil round trip : " << (round_trip ? "true" : "false")
+            << '\n';
+
+  // Agreement with local_tm, 1970 to 2100.
+  using std::chrono::system_clock;
+  std::size_t const N = 1000000;
+  std::uint64_t x = 88172645463325252ull;
+  std::size_t mismatch = 0;
+  for (std::size_t i = 0; i != N; ++i)
+  {
+    x ^= x << 13; x ^= x >> 7; x ^= x << 17;    // xorshift64
+    std::time_t const tt = static_cast<std::time_t>(x % 4102444800ull);
+    std::tm const a = C::local_tm(tt);
+    std::tm const b = C::to_tm(C::local_civil(system_clock::from_time_t(tt)));
+    mismatch += ((a.tm_year != b.tm_year) || (a.tm_mon  != b.tm_mon) ||
+                 (a.tm_mday != b.tm_mday) || (a.tm_hour != b.tm_hour) ||
+                 (a.tm_min  != b.tm_min)  || (a.tm_sec  != b.tm_sec)  ||
+                 (a.tm_wday != b.tm_wday) || (a.tm_yday != b.tm_yday));
+  }
+  std::cout << "  mismatches with local_tm : " << mismatch << " of " << N
+            << "\n  utc_offset : " << C::utc_offset().count() << " seconds\n";
+
+  // Consecutive timestamps, as when converting a log.
+  system_clock::time_point tp = system_clock::now();
+  std::int64_t sum = 0;
+  clock_t t = clock();
+  for (std::size_t i = 0; i != N; ++i)
+  {
+    std::time_t tt = system_clock::to_time_t(tp + std::chrono::milliseconds(i));
+    sum += C::local_tm(tt).tm_sec;
+  }
+  t = clock() - t;
+  std::cout << "  local_tm    : "
+            << ((1e9 * t) / CLOCKS_PER_SEC) / N << " ns per call\n";
+  t = clock();
+  for (std::size_t i = 0; i != N; ++i)
+  {
+    sum -= C::local_civil(tp + std::chrono::milliseconds(i)).second;
+  }
+  t = clock() - t;
+  std::cout << "  local_civil : "
+            << ((1e9 * t) / CLOCKS_PER_SEC) / N << " ns per call"
+            << ((sum == 0) ? "" : " (results differ)") << "\n\n";
 }
 
 } // utl_test
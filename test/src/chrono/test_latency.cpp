@@ -0,0 +1,69 @@
+//===========================================================================//
+//  Nathan Lucas
+//  2018
+//===========================================================================//
+
+#include <iostream>     // std::cout, std::endl
+#include <string>       // std::string
+#include <chrono>       // std::chrono::microseconds, nanoseconds
+#include <thread>       // std::thread
+
+#include "utl/chrono.hpp"             // utl::chrono::latency_histogram
+                                      // utl::chrono::segment
+#include "utl/file/file_csv.hpp"      // utl::file::csv_out
+
+#include "utl_test.hpp"        // utl_test::test_label
+#include "chrono_test.hpp"
+
+namespace utl_test {
+
+
+void
+test_latency(int& n)
+{
+  utl_test::test_label(n, "utl::chrono::latency_histogram");
+
+  using std::chrono::microseconds;
+  using std::chrono::nanoseconds;
+
+  std::cout << "  segment(1234567891 ns) :"
+            << "\n    none " << utl::chrono::segment(nanoseconds(1234567891),
+                                                     utl::chrono::fraction::none)
+            << "\n    ms   " << utl::chrono::segment(nanoseconds(1234567891),
+                                                     utl::chrono::fraction::ms)
+            << "\n    us   " << utl::chrono::segment(nanoseconds(1234567891),
+                                                     utl::chrono::fraction::us)
+            << "\n    ns   " << utl::chrono::segment(nanoseconds(1234567891),
+                                                     utl::chrono::fraction::ns)
+            << "\n\n";
+
+  // Two threads record 1 to 1000 microseconds each, then merge.
+  utl::chrono::latency_histogram<> h[2];
+  std::thread t0([&h]{ for (int i = 1; i <= 1000; ++i) { h[0].add(microseconds(i)); } });
+  std::thread t1([&h]{ for (int i = 1; i <= 1000; ++i) { h[1].add(microseconds(i)); } });
+  t0.join();
+  t1.join();
+  h[0].merge(h[1]);
+
+  std::cout << "  " << h[0] << '\n'
+            << "  mean  = " << h[0].mean().count() << " ns (expect 500500)\n"
+            << "  p50   = " << h[0].quantile(0.5).count() << " ns (expect about 500000)\n"
+            << "  p99   = " << h[0].quantile(0.99).count() << " ns (expect about 990000)\n";
+
+  std::string row;
+  utl::file::csv_out(row) << utl::chrono::csv(h[0]) << "\n";
+  std::cout << "  " << utl::chrono::csv_latency_header() << "\n  " << row;
+
+  // Recording cost.
+  std::size_t const N = 10000000;
+  utl::chrono::latency_histogram<> r;
+  utl::chrono::timer tmr;
+  for (std::size_t i = 0; i != N; ++i) { r.add(nanoseconds(i & 0xFFFFF)); }
+  std::cout << "  add : "
+            << (tmr.elapsed<utl::chrono::timer::ns>().count() / double(N))
+            << " ns per value (" << r.count() << " values)\n" << std::endl;
+}
+
+
+} // utl_test
+//===========================================================================//
@@ -0,0 +1,96 @@
+//===========================================================================//
+//  Nathan Lucas
+//  2018
+//===========================================================================//
+
+#include <iostream>     // std::cout, std::endl
+#include <chrono>       // std::chrono::microseconds, steady_clock
+#include <cmath>        // std::nan
+#include <stdexcept>    // std::invalid_argument
+#include <thread>       // std::this_thread::sleep_for
+
+#include "utl/chrono.hpp"   // utl::chrono::pacer
+                            // utl::chrono::rate_limiter
+
+#include "utl_test.hpp"        // utl_test::test_label
+#include "chrono_test.hpp"
+
+namespace utl_test {
+
+
+void
+test_pacer(int& n)
+{
+  utl_test::test_label(n, "utl::chrono::pacer");
+
+  using std::chrono::microseconds;
+  using std::chrono::steady_clock;
+
+  unsigned const frames = 500;
+  microseconds const period(2000);    // 500 Hz
+  microseconds const work(500);
+
+  // Fixed sleep after each frame drifts by the time spent working.
+  utl::chrono::latency_histogram<> drift;
+  steady_clock::time_point deadline = steady_clock::now();
+  for (unsigned i = 0; i != frames; ++i)
+  {
+    std::this_thread::sleep_for(work);
+    std::this_thread::sleep_for(period);
+    deadline += period;
+    drift.add(steady_clock::now() - deadline);
+  }
+  std::cout << "  sleep_for : " << drift << '\n';
+
+  utl::chrono::pacer pace(period);
+  utl::chrono::timer tmr;
+  for (unsigned i = 0; i != frames; ++i)
+  {
+    std::this_thread::sleep_for(work);
+    pace.wait();
+  }
+  std::cout << "  pacer     : " << pace.jitter() << '\n'
+            << "  elapsed " << tmr.elapsed<utl::chrono::timer::ms>().count()
+            << " ms (expect 1000), missed " << pace.missed() << "\n\n";
+
+  //-----------------------------------------------------------------
+
+  // 1 MB/s with 64 KB burst:  2 MB takes about 1.94 s.
+  utl::chrono::rate_limiter limit(1e6, 65536);
+  tmr.reset();
+  std::size_t bytes = 0;
+  for (unsigned i = 0; i != 32; ++i)
+  {
+    limit.acquire(65536);
+    bytes += 65536;
+  }
+  std::cout << "  rate_limiter acquire : " << bytes << " bytes in "
+            << tmr.elapsed<utl::chrono::timer::ms>().count()
+            << " ms (expect about 2032)\n";
+
+  utl::chrono::rate_limiter burst(1000, 10);
+  unsigned taken = 0;
+  for (unsigned i = 0; i != 100; ++i) { taken += burst.try_acquire(); }
+  std::cout << "  rate_limiter try_acquire : " << taken
+            << " of 100 (expect 10), delay "
+            << burst.delay().count() << " ns (expect about 1000000)\n";
+
+  // Invalid arguments are rejected.
+  unsigned rejected = 0;
+  double const rates[] = { 0, -1, std::nan("") };
+  for (double r : rates)
+  {
+    try { utl::chrono::rate_limiter bad(r, 1); }
+    catch (std::invalid_argument const&) { ++rejected; }
+  }
+  try { utl::chrono::rate_limiter bad(1, -1); }
+  catch (std::invalid_argument const&) { ++rejected; }
+  try { utl::chrono::pacer bad(microseconds(0)); }
+  catch (std::invalid_argument const&) { ++rejected; }
+  std::cout << "  invalid arguments rejected : " << rejected << " of 5\n"
+            << std::endl;
+}
+
+
+} // utl_test
+//===========================================================================//
@@ -12,7 +12,7 @@
                         //    microseconds, nanoseconds, steady_clock
 #include <ctime>        // clock_t, clock, CLOCKS_PER_SEC
 
-#include "utl/chrono.hpp"   //  utl::timer
+#include "utl/chrono.hpp"   //  utl::timer, utl::chrono::tsc_timer
 
 #include "utl_test.hpp"      // utl_test::test_label
 #include "chrono_test.hpp"
@@ -64,6 +64,50 @@ test_timer(int& n)
 }
 
 
+// Time Stamp Counter Clock and Timer
+void
+test_tsc_timer(int& n)
+{
+  utl_test::test_label(n, "utl::chrono::tsc_clock");
+
+  using utl::chrono::tsc_clock;
+  std::cout << "  time stamp counter : " << (tsc_clock::is_tsc() ? "true" : "false")
+            << "\n  ticks per second   : " << tsc_clock::ticks_per_second()
+            << "\n  steady             : " << utl::chrono::clock_is_steady<tsc_clock>()
+            << "\n  now<tsc_clock, ms> : "
+            << utl::chrono::now<tsc_clock, std::chrono::milliseconds>().count()
+            << "\n  now<steady, ms>    : "
+            << utl::chrono::now<std::chrono::steady_clock,
+                                std::chrono::milliseconds>().count() << "\n\n";
+
+  utl::chrono::tsc_timer tmr;
+  int f = frequency_of_primes(PRIME_MAX);
+  std::cout << "  The number of primes lower than " << PRIME_LIMIT
+            << " is: " << f << "\n  Computation time: "
+            << tmr.elapsed<utl::chrono::tsc_timer::ms>().count()
+            << " milliseconds\n\n";
+
+  // Cost of reading each clock.
+  std::size_t const N = 10000000;
+  long long sum = 0;
+  utl::chrono::timer t0;
+  for (std::size_t i = 0; i != N; ++i)
+  {
+    sum += std::chrono::steady_clock::now().time_since_epoch().count();
+  }
+  double steady_ns = t0.elapsed<utl::chrono::timer::ns>().count() / double(N);
+  t0.reset();
+  for (std::size_t i = 0; i != N; ++i)
+  {
+    sum += tsc_clock::now().time_since_epoch().count();
+  }
+  double tsc_ns = t0.elapsed<utl::chrono::timer::ns>().count() / double(N);
+  std::cout << "  steady_clock::now() : " << steady_ns << " ns per call\n"
+            << "  tsc_clock::now()    : " << tsc_ns << " ns per call"
+            << ((sum == 0) ? " " : "") << '\n' << std::endl;
+}
+
+
 void
 test_timer_chrono(int& n)
 {
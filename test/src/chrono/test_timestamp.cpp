@@ -12,6 +12,7 @@
 #include "utl/chrono.hpp"   // util::chrono::date
                             // util::chrono::datetime
                             // util::chrono::time
+                            // util::chrono::timestamp
 
 #include "utl_test.hpp"        // utl_test::test_label
 #include "chrono_test.hpp"
@@ -61,6 +62,42 @@ test_timestamp(int& n)
       << "  to call utl::chrono::time() " << N << " times,\n  or "
       << ((1000000.0 * (float)t)/CLOCKS_PER_SEC) / (float)N
       << " microseconds per call\n" << std::endl;
+
+  //-----------------------------------------------------------------
+
+  char buf[64];
+  std::cout << "  fraction\ttimestamp\n"
+            << "  --------\t---------\n";
+  utl::chrono::timestamp(buf, sizeof(buf));
+  std::cout << "  none\t\t" << buf << '\n';
+  utl::chrono::timestamp(buf, sizeof(buf), utl::chrono::fraction::ms);
+  std::cout << "  ms\t\t" << buf << '\n';
+  utl::chrono::timestamp(buf, sizeof(buf), utl::chrono::fraction::us);
+  std::cout << "  us\t\t" << buf << '\n';
+  utl::chrono::timestamp(buf, sizeof(buf), utl::chrono::fraction::ns);
+  std::cout << "  ns\t\t" << buf << '\n';
+
+  // Epoch plus 1.5 seconds, formatted in basic format.
+  utl::chrono::timestamp_formatter basic(utl::chrono::fraction::ms, "T", "", "");
+  std::chrono::system_clock::time_point tp(std::chrono::milliseconds(1500));
+  std::cout << "  basic\t\t" << basic(tp) << "  (epoch + 1.5 s)\n";
+  std::cout << "  small buffer returns " << basic.format(buf, basic.size(), tp)
+            << "\n" << std::endl;
+
+  t = clock();
+  utl::chrono::timestamp_formatter fmt(utl::chrono::fraction::us);
+  for (std::size_t i = 0; i != N; ++i)
+  {
+    fmt.format(buf, sizeof(buf));
+  }
+  t = clock() - t;
+
+  std::cout << "  It took " << t << " clicks ("
+      << ((float)t)/CLOCKS_PER_SEC << " seconds)\n"
+      << "  to call utl::chrono::timestamp_formatter::format() " << N
+      << " times,\n  or "
+      << ((1000000.0 * (float)t)/CLOCKS_PER_SEC) / (float)N
+      << " microseconds per call\n" << std::endl;
 }
 
 
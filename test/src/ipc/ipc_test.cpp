@@ -0,0 +1,331 @@
+//===========================================================================//
+//  Nathan Lucas
+//  2018
+//===========================================================================//
+
+#include "utl/ipc.hpp"
+
+#include <algorithm>    // std::sort
+#include <atomic>       // std::atomic
+#include <cerrno>       // EEXIST
+#include <chrono>       // std::chrono::steady_clock
+#include <cstdint>      // std::uint64_t
+#include <cstring>      // std::memcpy
+#include <iostream>     // std::cout, std::endl
+#include <memory>       // std::unique_ptr
+#include <stdexcept>    // std::runtime_error
+#include <string>       // std::string
+#include <system_error> // std::system_error
+#include <thread>       // std::thread
+#include <vector>       // std::vector
+
+#include <sys/mman.h>   // shm_unlink
+#include <sys/wait.h>   // waitpid
+#include <unistd.h>     // fork, _exit
+
+#include "utl_test.hpp"  // utl_test::test_label
+
+namespace {   //-------------------------------------------------------------
+
+namespace ipc = utl::ipc;
+
+char const* const ring_name = "/utl-ipc-test";
+
+// Returns record i:  its sequence number followed by filler bytes.
+std::string
+record(std::uint64_t i)
+{
+  std::string s(sizeof(i) + (i * 7919) % 300, static_cast<char>(i));
+  std::memcpy(&s[0], &i, sizeof(i));
+  return s;
+}
+
+// Checks that records arrive complete and in order.
+struct checker
+{
+  checker() : next(0), bad(0) {}
+
+  void
+  operator()(char const* data, std::size_t size)
+  {
+    std::string const expected = record(next++);
+    if ((size != expected.size()) ||
+        (std::memcmp(data, expected.data(), size) != 0))
+    {
+      ++bad;
+    }
+  }
+
+  std::uint64_t next;
+  std::uint64_t bad;
+};
+
+void
+test_order(int& n)
+{
+  utl_test::test_label(n, "utl::ipc::shm_ring, three readers");
+
+  constexpr std::uint64_t count = 200000;
+  std::unique_ptr<ipc::shm_ring> ring(new ipc::shm_ring(ring_name, 4096));
+  std::cout << "capacity:          " << ring->capacity() << '\n'
+            << "max record size:   " << ring->max_record_size() << '\n';
+
+  std::vector<checker> checks(3);
+  std::vector<std::unique_ptr<ipc::shm_ring_reader>> readers;
+  std::vector<std::thread> threads;
+  for (auto& c : checks)
+  {
+    checker* p = &c;
+    readers.emplace_back(new ipc::shm_ring_reader(ring_name,
+        [p](char const* data, std::size_t size) { (*p)(data, size); }));
+    ipc::shm_ring_reader* r = readers.back().get();
+    threads.emplace_back([r]() { r->run(); });
+  }
+  std::cout << "readers:           " << ring->reader_count() << '\n';
+
+  for (std::uint64_t i = 0; i != count; ++i)
+  {
+    ring->write(record(i));
+  }
+  ring.reset();   // close:  readers finish and return
+  for (auto& t : threads) { t.join(); }
+
+  bool pass = true;
+  for (auto const& c : checks)
+  {
+    pass = pass && (c.next == count) && (c.bad == 0);
+  }
+  std::cout << "records in order:  " << (pass ? "pass" : "FAIL") << std::endl;
+}
+
+void
+test_processes(int& n)
+{
+  utl_test::test_label(n, "utl::ipc::shm_ring, reader processes");
+
+  constexpr std::uint64_t count = 50000;
+  std::unique_ptr<ipc::shm_ring> ring(new ipc::shm_ring(ring_name, 4096, 2));
+
+  // A child process reads every record.
+  pid_t const child = ::fork();
+  if (child == 0)
+  {
+    checker c;
+    ipc::shm_ring_reader reader(ring_name,
+        [&c](char const* data, std::size_t size) { c(data, size); });
+    reader.run();
+    ::_exit(((c.next == count) && (c.bad == 0)) ? 0 : 1);
+  }
+  while (ring->reader_count() != 1) { std::this_thread::yield(); }
+
+  // Another attaches and exits without reading or detaching.
+  pid_t const dead = ::fork();
+  if (dead == 0)
+  {
+    ipc::shm_ring_reader reader(ring_name, [](char const*, std::size_t){});
+    ::_exit(0);
+  }
+  ::waitpid(dead, nullptr, 0);
+  std::cout << "readers:           " << ring->reader_count() << '\n';
+
+  // A new reader takes over the slot of the one that exited.
+  bool attached = false;
+  try
+  {
+    ipc::shm_ring_reader reader(ring_name, [](char const*, std::size_t){});
+    attached = (ring->reader_count() == 2);
+  }
+  catch (std::runtime_error const&) {}
+  std::cout << "slot taken over:   " << (attached ? "pass" : "FAIL") << '\n';
+
+  for (std::uint64_t i = 0; i != count; ++i)
+  {
+    ring->write(record(i));
+  }
+  std::cout << "slot reclaimed:    "
+            << ((ring->reader_count() == 1) ? "pass" : "FAIL") << '\n';
+
+  ring.reset();   // close:  the child finishes and exits
+  int status = 0;
+  ::waitpid(child, &status, 0);
+  std::cout << "records in order:  "
+            << ((WIFEXITED(status) && (WEXITSTATUS(status) == 0))
+                ? "pass" : "FAIL") << std::endl;
+}
+
+void
+test_writer_exit(int& n)
+{
+  utl_test::test_label(n, "utl::ipc::shm_ring, writer exits");
+
+  // The writer publishes one record and exits without closing the ring.
+  pid_t const writer = ::fork();
+  if (writer == 0)
+  {
+    ipc::shm_ring* ring = new ipc::shm_ring(ring_name, 4096);
+    while (ring->reader_count() == 0) { std::this_thread::yield(); }
+    ring->write(record(0));
+    ::_exit(0);
+  }
+  std::thread reap([writer]() { ::waitpid(writer, nullptr, 0); });
+
+  std::unique_ptr<ipc::shm_ring_reader> reader;
+  checker c;
+  while (!reader)
+  {
+    try
+    {
+      reader.reset(new ipc::shm_ring_reader(ring_name,
+          [&c](char const* data, std::size_t size) { c(data, size); }));
+    }
+    catch (std::exception const&)
+    {
+      std::this_thread::yield();  // not created yet
+    }
+  }
+  reader->run();    // returns once the writer is gone
+  reap.join();
+
+  // The ring left by the writer may be replaced.
+  bool replaced = true;
+  try
+  {
+    ipc::shm_ring ring(ring_name, 4096);
+  }
+  catch (std::system_error const&)
+  {
+    replaced = false;
+    ::shm_unlink(ring_name);
+  }
+  std::cout << "run() returned:    "
+            << (!reader->writer_alive() ? "pass" : "FAIL") << '\n'
+            << "records read:      " << c.next << " (expect 1)\n"
+            << "ring replaced:     " << (replaced ? "pass" : "FAIL")
+            << std::endl;
+}
+
+void
+test_name_in_use(int& n)
+{
+  utl_test::test_label(n, "utl::ipc::shm_ring, name in use");
+
+  // A second writer may not take the name of a live one.
+  ipc::shm_ring ring(ring_name, 4096);
+  int ec = 0;
+  try
+  {
+    ipc::shm_ring second(ring_name, 4096);
+  }
+  catch (std::system_error const& e)
+  {
+    ec = e.code().value();
+  }
+  bool kept = true;
+  try
+  {
+    ipc::shm_ring_reader reader(ring_name, [](char const*, std::size_t){});
+  }
+  catch (std::exception const&)
+  {
+    kept = false;
+  }
+  std::cout << "second writer refused:  " << ((ec == EEXIST) ? "pass" : "FAIL")
+            << '\n'
+            << "first ring kept:        " << (kept ? "pass" : "FAIL")
+            << std::endl;
+}
+
+void
+test_backpressure(int& n)
+{
+  utl_test::test_label(n, "utl::ipc::shm_ring::try_write");
+
+  ipc::shm_ring ring(ring_name, 1024);
+  std::size_t received = 0;
+  ipc::shm_ring_reader reader(ring_name,
+      [&received](char const*, std::size_t) { ++received; });
+
+  char const payload[100] = {};
+  std::size_t written = 0;
+  while (ring.try_write(payload, sizeof(payload))) { ++written; }
+  std::cout << "written until full:  " << written << '\n';
+  reader.poll();
+  std::cout << "received:            " << received << '\n';
+  std::cout << "write after poll:    "
+            << (ring.try_write(payload, sizeof(payload)) ? "pass" : "FAIL")
+            << std::endl;
+}
+
+void
+test_latency(int& n)
+{
+  utl_test::test_label(n, "utl::ipc::shm_ring throughput and latency");
+
+  using clock = std::chrono::steady_clock;
+  constexpr std::size_t count = 100000;
+  ipc::shm_ring ring(ring_name, 1 << 20);
+
+  // Each record carries the time it was written.
+  std::vector<double> latency;
+  latency.reserve(2 * count);
+  std::atomic<std::size_t> received(0);
+  ipc::shm_ring_reader reader(ring_name,
+      [&latency, &received](char const* data, std::size_t)
+      {
+        clock::time_point sent;
+        std::memcpy(&sent, data, sizeof(sent));
+        latency.push_back(std::chrono::duration<double, std::micro>(
+            clock::now() - sent).count());
+        received.fetch_add(1);
+      });
+  std::thread t([&reader]() { reader.run(); });
+
+  char payload[64] = {};
+  auto write = [&ring, &payload]()
+  {
+    clock::time_point const now = clock::now();
+    std::memcpy(payload, &now, sizeof(now));
+    ring.write(payload, sizeof(payload));
+  };
+
+  // Records written as fast as possible.
+  auto const start = clock::now();
+  for (std::size_t i = 0; i != count; ++i) { write(); }
+  while (received.load() != count) { std::this_thread::yield(); }
+  double const seconds = std::chrono::duration<double>(
+      clock::now() - start).count();
+
+  // Records written one at a time.
+  for (std::size_t i = 1; i <= count; ++i)
+  {
+    write();
+    while (received.load() != count + i) { std::this_thread::yield(); }
+  }
+  reader.stop();
+  t.join();
+
+  std::sort(latency.begin() + count, latency.end());
+  std::cout << "64-byte records/s:   " << static_cast<long long>(count / seconds)
+            << '\n'
+            << "median latency:      " << latency[count + (count / 2)]
+            << " us\n"
+            << "99th percentile:     " << latency[count + ((count * 99) / 100)]
+            << " us" << std::endl;
+}
+
+} // anonymous --------------------------------------------------------------
+
+int
+main()
+{
+  int n = 0;
+  test_order(n);
+  test_processes(n);
+  test_writer_exit(n);
+  test_name_in_use(n);
+  test_backpressure(n);
+  test_latency(n);
+  return 0;
+}
+
+//===========================================================================//
@@ -0,0 +1,414 @@
+//===========================================================================//
+//  Nathan Lucas
+//  2018
+//===========================================================================//
+
+#include <utl/json.hpp>               // utl::json::find, utl::json::value,
+                                      // utl::json::reader,
+                                      // utl::json::extract
+#include <utl/json/json_fields.hpp>   // UTL_JSON_FIELDS, utl::json::decode,
+                                      // utl::json::encode
+
+#include <chrono>     // std::chrono::steady_clock
+#include <iostream>   // std::cout, std::endl
+#include <stdexcept>  // std::invalid_argument
+#include <string>     // std::string
+#include <vector>     // std::vector
+
+#include "utl_test.hpp"  // utl_test::test_label
+
+namespace test {
+
+struct channel
+{
+  std::string name;
+  double      gain = 1;
+};
+
+struct device
+{
+  std::string           name;
+  int                   port = 80;
+  bool                  enabled = false;
+  std::vector<double>   gains;
+  std::vector<bool>     flags;
+  std::vector<channel>  channels;
+  channel               primary;
+  nlohmann::json        extra;
+};
+
+} // test
+
+UTL_JSON_FIELDS(test::channel, name, gain)
+UTL_JSON_FIELDS(test::device, name, port, enabled, gains, flags, channels,
+                primary, extra)
+
+namespace {   //-------------------------------------------------------------
+
+char const* const config = R"({
+  "name": "sensor \"A\"\n\u00e9\ud83d\ude00",
+  "port": 5000,
+  "rate": 2.5e3,
+  "enabled": true,
+  "notes": null,
+  "gains": [1, 2.5, -3],
+  "tags": ["x", "y"],
+  "skipped": { "deep": [[{}, []], { "a": "}" }] },
+  "log": { "level": 3, "file": { "path": "/tmp/log" } },
+  "extra": { "k": [1, { "v": false }] }
+})";
+
+char const*
+result(bool pass)
+{
+  return (pass ? "pass" : "FAIL");
+}
+
+// Returns true if parsing text with a reader throws std::invalid_argument.
+bool
+rejects(std::string const& text)
+{
+  try
+  {
+    utl::json::reader r(text);
+    while (r.next() != utl::json::reader::token::end) {}
+  }
+  catch (std::invalid_argument const&)
+  {
+    return true;
+  }
+  return false;
+}
+
+void
+test_find(int& n)
+{
+  utl_test::test_label(n, "utl::json::find, utl::json::value");
+
+  nlohmann::json const j = nlohmann::json::parse(config);
+  nlohmann::json const* port = utl::json::find(j, "port");
+  std::cout << "find existing key:          "
+            << result(port && (*port == 5000)) << '\n'
+            << "find missing key:           "
+            << result(!utl::json::find(j, "missing")) << '\n'
+            << "find in array:              "
+            << result(!utl::json::find(j["gains"], "port")) << '\n';
+
+  int i = 0;
+  std::vector<double> gains;
+  nlohmann::json log;
+  std::string s;
+  std::cout << "value int:                  "
+            << result(utl::json::value(j, "port", i) && (i == 5000)) << '\n'
+            << "value vector:               "
+            << result(utl::json::value(j, "gains", gains) &&
+                      (gains.size() == 3)) << '\n'
+            << "value object:               "
+            << result(utl::json::value(j, "log", log) && (log["level"] == 3))
+            << '\n'
+            << "value wrong type:           "
+            << result(!utl::json::value(j, "port", s)) << std::endl;
+}
+
+void
+test_reader(int& n)
+{
+  utl_test::test_label(n, "utl::json::reader");
+
+  using token = utl::json::reader::token;
+  utl::json::reader r(R"( {"a": [1, -2.5e1, "s\tt"], "b": {}, "c": null} )");
+  std::vector<token> const expected = {
+      token::object_begin, token::key, token::array_begin, token::number,
+      token::number, token::string, token::array_end, token::key,
+      token::object_begin, token::object_end, token::key, token::null,
+      token::object_end, token::end };
+  std::vector<token> tokens;
+  std::string text;
+  double d = 0;
+  do
+  {
+    tokens.push_back(r.next());
+    if (r.current() == token::string) { text = r.str(); }
+    if ((r.current() == token::number) && !r.is_integer()) { r.number(d); }
+  } while (r.current() != token::end);
+  std::cout << "tokens:                     " << result(tokens == expected)
+            << '\n'
+            << "escaped string:             " << result(text == "s\tt") << '\n'
+            << "number:                     " << result(d == -25) << '\n';
+
+  utl::json::reader big("[18446744073709551615, -9223372036854775808, 300]");
+  unsigned long long u = 0;
+  long long ll = 0;
+  unsigned char uc = 0;
+  big.next();
+  big.next();
+  bool ok = big.number(u) && (u == 18446744073709551615ull) && !big.number(ll);
+  big.next();
+  ok = ok && big.number(ll) && (ll == (-9223372036854775807ll - 1)) &&
+       !big.number(u);
+  big.next();
+  ok = ok && !big.number(uc) && (uc == 0);
+  std::cout << "integer range checks:       " << result(ok) << '\n';
+
+  bool const malformed =
+      rejects("") && rejects("{") && rejects("[1,]") && rejects("{\"a\" 1}") &&
+      rejects("{\"a\":1,}") && rejects("[01]") && rejects("[1.]") &&
+      rejects("\"\\x\"") && rejects("\"\\ud800\"") && rejects("tru") &&
+      rejects("{} {}") && rejects("[1 2]") && rejects("{1:2}") &&
+      rejects("\"a\nb\"");
+  bool const valid =
+      !rejects("[]") && !rejects(" 0 ") && !rejects("[[], {}, \"\"]") &&
+      !rejects("-0.5E-3");
+  std::cout << "malformed text throws:      " << result(malformed) << '\n'
+            << "valid text accepted:        " << result(valid) << std::endl;
+}
+
+void
+test_extract(int& n)
+{
+  utl_test::test_label(n, "utl::json::extract");
+
+  std::string name;
+  int port = 0;
+  double rate = 0;
+  bool enabled = false;
+  std::vector<double> gains;
+  std::vector<int> int_gains = { 7 };
+  int level = 0;
+  std::string path;
+  std::string tags = "unchanged";
+  nlohmann::json extra;
+  int missing = 42;
+
+  std::size_t const count = utl::json::extract(config, {
+      { "name", name },
+      { "port", port },
+      { "rate", rate },
+      { "enabled", enabled },
+      { "gains", gains },
+      { "gains", int_gains },     // Second field with the same key is unused
+      { "log.level", level },
+      { "log.file.path", path },
+      { "tags", tags },           // Wrong type
+      { "extra", extra },
+      { "missing", missing } });
+
+  std::cout << "values assigned:            " << count << '\n'
+            << "string with escapes:        "
+            << result(name == "sensor \"A\"\n\xc3\xa9\xf0\x9f\x98\x80") << '\n'
+            << "numbers:                    "
+            << result((port == 5000) && (rate == 2500)) << '\n'
+            << "boolean:                    " << result(enabled) << '\n'
+            << "vector:                     "
+            << result(gains == std::vector<double>({ 1, 2.5, -3 })) << '\n'
+            << "nested paths:               "
+            << result((level == 3) && (path == "/tmp/log")) << '\n'
+            << "json value:                 "
+            << result(extra["k"][1]["v"] == false) << '\n'
+            << "wrong type unchanged:       "
+            << result((tags == "unchanged") && (int_gains.size() == 1)) << '\n'
+            << "missing key unchanged:      " << result(missing == 42) << '\n';
+
+  bool threw = false;
+  try
+  {
+    utl::json::extract("{\"port\": 1, \"x\": [}", { { "port", port } });
+  }
+  catch (std::invalid_argument const& e)
+  {
+    threw = true;
+    std::cout << "error:                      " << e.what() << '\n';
+  }
+  std::cout << "malformed text throws:      " << result(threw) << '\n';
+
+  // Subnormal numbers are assigned; overflow is not.
+  double tiny = 0;
+  double huge = 1;
+  float narrow = 1;
+  utl::json::extract(R"({"a": 1e-310, "b": 1e400, "c": 1e39})",
+                     { { "a", tiny }, { "b", huge }, { "c", narrow } });
+  std::cout << "subnormal assigned:         "
+            << result((tiny > 0) && (tiny < 1e-300)) << '\n'
+            << "overflow unchanged:         "
+            << result((huge == 1) && (narrow == 1)) << std::endl;
+}
+
+void
+test_speed(int& n)
+{
+  utl_test::test_label(n, "utl::json::extract vs nlohmann::json::parse");
+
+  // Large document with a few wanted keys.
+  std::string text = "{";
+  for (int i = 0; i != 2000; ++i)
+  {
+    text += "\"item" + std::to_string(i) + "\": {\"id\": "
+          + std::to_string(i) + ", \"values\": [1.5, 2.5, 3.5], "
+          + "\"label\": \"some text\"}, ";
+  }
+  text += "\"port\": 5000, \"rate\": 2.5}";
+
+  int const reps = 20;
+  int port_a = 0, port_b = 0;
+  double rate_a = 0, rate_b = 0;
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i != reps; ++i)
+  {
+    nlohmann::json const j = nlohmann::json::parse(text);
+    utl::json::value(j, "port", port_a);
+    utl::json::value(j, "rate", rate_a);
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  for (int i = 0; i != reps; ++i)
+  {
+    utl::json::extract(text, { { "port", port_b }, { "rate", rate_b } });
+  }
+  auto t2 = std::chrono::steady_clock::now();
+
+  double const dom = std::chrono::duration<double, std::micro>(t1 - t0).count()
+                   / reps;
+  double const sax = std::chrono::duration<double, std::micro>(t2 - t1).count()
+                   / reps;
+  std::cout << "document size:              " << text.size() << " bytes\n"
+            << "same values:                "
+            << result((port_a == port_b) && (rate_a == rate_b)) << '\n'
+            << "parse + value:              " << dom << " us\n"
+            << "extract:                    " << sax << " us\n"
+            << "speedup:                    " << (dom / sax) << std::endl;
+}
+
+void
+test_fields(int& n)
+{
+  utl_test::test_label(n, "UTL_JSON_FIELDS");
+
+  test::device d;
+  d.name = "pump";
+  d.port = 5000;
+  d.enabled = true;
+  d.gains = { 0.5, 2 };
+  d.flags = { true, false, true };
+  d.channels.resize(2);
+  d.channels[0].name = "a";
+  d.channels[0].gain = 1.5;
+  d.channels[1].name = "b";
+  d.channels[1].gain = -2;
+  d.primary.name = "p";
+  d.primary.gain = 3;
+  d.extra = { { "k", 1 } };
+
+  // Encode, then decode from text and from a document.
+  nlohmann::json const j = utl::json::encode(d);
+  std::string const text = j.dump();
+  std::cout << "encoded:                    " << text << '\n';
+
+  std::vector<utl::json::field_error> errors;
+  test::device a;
+  test::device b;
+  bool const ok_a = utl::json::decode(text, a, errors);
+  bool const ok_b = utl::json::decode(j, b, errors);
+  auto same = [&d](test::device const& x)
+  {
+    return ((x.name == d.name) && (x.port == d.port) &&
+            (x.enabled == d.enabled) && (x.gains == d.gains) &&
+            (x.flags == d.flags) && (x.channels.size() == 2) && (x.channels[1].name == "b") &&
+            (x.channels[1].gain == -2) && (x.primary.gain == 3) &&
+            (x.extra == d.extra));
+  };
+  std::cout << "decode text:                " << result(ok_a && same(a)) << '\n'
+            << "decode document:            " << result(ok_b && same(b)) << '\n';
+
+  // Every error is reported, and other members are still decoded.
+  char const* const bad = R"({
+    "name": 7, "enabled": true, "gains": [1, "x"], "flags": [false, true],
+    "unknown": [1, 2],
+    "channels": [{ "name": "a" }, { "name": "b", "gain": "high" }],
+    "primary": [] })";
+  std::vector<std::string> const expected = {
+      "wrong type name", "wrong type gains", "missing channels[0].gain",
+      "wrong type channels[1].gain", "wrong type primary", "missing port",
+      "missing extra" };
+  auto listed = [](std::vector<utl::json::field_error> const& errors)
+  {
+    std::vector<std::string> v;
+    for (auto const& e : errors)
+    {
+      v.push_back(((e.reason == utl::json::field_error::kind::missing)
+                   ? "missing " : "wrong type ") + e.path);
+    }
+    return v;
+  };
+  test::device c;
+  c.channels.resize(1);
+  c.channels[0].name = "old";
+  bool ok_c = utl::json::decode(bad, c, errors);
+  std::cout << "errors from text:           "
+            << result(!ok_c && (listed(errors) == expected)) << '\n';
+  ok_c = utl::json::decode(nlohmann::json::parse(bad), c, errors);
+  std::cout << "errors from document:       "
+            << result(!ok_c && (listed(errors).size() == expected.size()))
+            << '\n'
+            << "valid members decoded:      "
+            << result(c.enabled && (c.port == 80)
+                      && (c.flags == std::vector<bool>({ false, true })))
+            << '\n'
+            << "vector with errors kept:    "
+            << result((c.channels.size() == 1) && (c.channels[0].name == "old"))
+            << '\n';
+
+  try
+  {
+    utl::json::decode(bad, c);
+  }
+  catch (utl::json::decode_error const& e)
+  {
+    std::cout << "error:                      " << e.what() << '\n';
+  }
+
+  // Binding against hand-written value() calls.
+  int const reps = 20000;
+  std::string const small = R"({"name": "pump", "port": 5000,
+      "enabled": true, "gains": [0.5, 2], "primary": {"name": "p"}})";
+  test::device x;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i != reps; ++i)
+  {
+    nlohmann::json const doc = nlohmann::json::parse(small);
+    nlohmann::json primary;
+    utl::json::value(doc, "name", x.name);
+    utl::json::value(doc, "port", x.port);
+    utl::json::value(doc, "enabled", x.enabled);
+    utl::json::value(doc, "gains", x.gains);
+    utl::json::value(doc, "primary", primary);
+    utl::json::value(primary, "name", x.primary.name);
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  for (int i = 0; i != reps; ++i)
+  {
+    utl::json::decode(small, x, errors);
+  }
+  auto t2 = std::chrono::steady_clock::now();
+  std::cout << "parse + value:              "
+            << (std::chrono::duration<double, std::nano>(t1 - t0).count()
+                / reps) << " ns\n"
+            << "decode:                     "
+            << (std::chrono::duration<double, std::nano>(t2 - t1).count()
+                / reps) << " ns" << std::endl;
+}
+
+} // anonymous --------------------------------------------------------------
+
+int
+main()
+{
+  int n = 0;
+  test_find(n);
+  test_reader(n);
+  test_extract(n);
+  test_speed(n);
+  test_fields(n);
+  return 0;
+}
+
+//===========================================================================//
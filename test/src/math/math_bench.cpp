@@ -0,0 +1,174 @@
+//===========================================================================//
+//  Nathan Lucas
+//  2018
+//===========================================================================//
+
+#include "utl/math.hpp"
+#include "utl/chrono.hpp"   // utl::chrono::timer
+
+#include <cstddef>    // std::size_t
+#include <iomanip>    // std::setw
+#include <iostream>   // std::cout
+#include <string>     // std::string
+#include <vector>     // std::vector
+
+namespace {   //-------------------------------------------------------------
+
+std::size_t const N = 4096;     // samples per frame
+std::size_t const R = 2000;     // frames
+
+volatile double sink = 0;       // keep results observable
+
+void
+report(std::string const& name, double scalar_us, double batch_us)
+{
+  double const samples = static_cast<double>(N * R);
+  std::cout << "  " << std::left << std::setw(20) << name << std::right
+            << std::setw(10) << (samples / scalar_us) << " M/s scalar"
+            << std::setw(10) << (samples / batch_us)  << " M/s batch"
+            << std::setw(8)  << (scalar_us / batch_us) << "x" << std::endl;
+}
+
+template<typename T>
+void
+bench(char const* type_name)
+{
+  typedef utl::chrono::timer::us us;
+
+  std::vector<T> xs(N), ys(N), out(N);
+  std::vector<double> rad(N);
+  std::vector<char> in(N);
+  bool inb[N];
+  for (std::size_t i = 0; i != N; ++i)
+  {
+    xs[i] = static_cast<T>((i * 7919) % 1280);
+    ys[i] = static_cast<T>((i * 104729) % 1024);
+  }
+
+  std::cout << type_name << std::endl;
+
+  // squared_distance ----------------------------------------
+  {
+    utl::chrono::timer tmr;
+    for (std::size_t r = 0; r != R; ++r)
+    {
+      for (std::size_t i = 0; i != N; ++i)
+      {
+        out[i] = utl::math::squared_distance(T(640), T(512), xs[i], ys[i]);
+      }
+      sink = sink + out[r % N];
+    }
+    double t_scalar = tmr.elapsed<us>().count();
+    tmr.reset();
+    for (std::size_t r = 0; r != R; ++r)
+    {
+      utl::math::squared_distance(xs.data(), ys.data(), N,
+                                  T(640), T(512), out.data());
+      sink = sink + out[r % N];
+    }
+    report("squared_distance", t_scalar, tmr.elapsed<us>().count());
+  }
+
+  // in_radius -----------------------------------------------
+  {
+    utl::chrono::timer tmr;
+    for (std::size_t r = 0; r != R; ++r)
+    {
+      for (std::size_t i = 0; i != N; ++i)
+      {
+        in[i] = utl::math::in_radius(xs[i], ys[i], T(800));
+      }
+      sink = sink + in[r % N];
+    }
+    double t_scalar = tmr.elapsed<us>().count();
+    tmr.reset();
+    for (std::size_t r = 0; r != R; ++r)
+    {
+      sink = sink + utl::math::in_radius(xs.data(), ys.data(), N, T(800), inb);
+    }
+    report("in_radius", t_scalar, tmr.elapsed<us>().count());
+  }
+
+  // bound ---------------------------------------------------
+  {
+    utl::chrono::timer tmr;
+    for (std::size_t r = 0; r != R; ++r)
+    {
+      for (std::size_t i = 0; i != N; ++i)
+      {
+        out[i] = utl::math::bound(xs[i], T(100), T(1000));
+      }
+      sink = sink + out[r % N];
+    }
+    double t_scalar = tmr.elapsed<us>().count();
+    tmr.reset();
+    for (std::size_t r = 0; r != R; ++r)
+    {
+      utl::math::bound(xs.data(), N, T(100), T(1000), out.data());
+      sink = sink + out[r % N];
+    }
+    report("bound", t_scalar, tmr.elapsed<us>().count());
+  }
+
+  // standard_deg --------------------------------------------
+  {
+    utl::chrono::timer tmr;
+    for (std::size_t r = 0; r != R; ++r)
+    {
+      for (std::size_t i = 0; i != N; ++i)
+      {
+        out[i] = utl::math::standard_deg(xs[i]);
+      }
+      sink = sink + out[r % N];
+    }
+    double t_scalar = tmr.elapsed<us>().count();
+    tmr.reset();
+    for (std::size_t r = 0; r != R; ++r)
+    {
+      utl::math::standard_deg(xs.data(), N, out.data());
+      sink = sink + out[r % N];
+    }
+    report("standard_deg", t_scalar, tmr.elapsed<us>().count());
+  }
+
+  // deg_to_rad ----------------------------------------------
+  {
+    utl::chrono::timer tmr;
+    for (std::size_t r = 0; r != R; ++r)
+    {
+      for (std::size_t i = 0; i != N; ++i)
+      {
+        rad[i] = utl::math::deg_to_rad(xs[i]);
+      }
+      sink = sink + rad[r % N];
+    }
+    double t_scalar = tmr.elapsed<us>().count();
+    tmr.reset();
+    for (std::size_t r = 0; r != R; ++r)
+    {
+      utl::math::deg_to_rad(xs.data(), N, rad.data());
+      sink = sink + rad[r % N];
+    }
+    report("deg_to_rad", t_scalar, tmr.elapsed<us>().count());
+  }
+
+  std::cout << std::endl;
+}
+
+} // anonymous --------------------------------------------------------------
+
+
+int
+main(int argc, char* argv[])
+{
+  std::cout << "utl::math batch benchmark: "
+            << N << " samples x " << R << " frames\n" << std::endl;
+
+  bench<float>("float");
+  bench<double>("double");
+  bench<int>("int");
+
+  return 0;
+}
+
+//===========================================================================//
@@ -7,6 +7,7 @@
 
 #include <string>
 #include <iostream>
+#include <vector>
 
 namespace {   //-------------------------------------------------------------
 
@@ -65,6 +66,67 @@ in_radius_test(char x, char y, char r)
 //            << (utl::in_radius(x,lower,upper) ? "true" : "false") << std::endl;
 //}
 
+// Compare batch functions against the scalar functions.
+template<typename T>
+void
+batch_test(char const* type_name)
+{
+  std::size_t const N = 37;   // not a multiple of any vector width
+  std::vector<T> xs(N), ys(N), out(N);
+  std::vector<double> rad(N);
+  bool in[N];
+  for (std::size_t i = 0; i != N; ++i)
+  {
+    xs[i] = static_cast<T>(i * 29 % 23) - 11;
+    ys[i] = static_cast<T>(i * 13 % 17) - 8;
+  }
+
+  unsigned errors = 0;
+
+  utl::math::squared_distance(xs.data(), ys.data(), N, T(2), T(-3), out.data());
+  for (std::size_t i = 0; i != N; ++i)
+  {
+    errors += (out[i] != utl::math::squared_distance(T(2), T(-3), xs[i], ys[i]));
+  }
+
+  std::size_t count = utl::math::in_radius(xs.data(), ys.data(), N, T(7), in);
+  std::size_t expect = 0;
+  for (std::size_t i = 0; i != N; ++i)
+  {
+    bool b = utl::math::in_radius(xs[i], ys[i], T(7));
+    expect += b;
+    errors += (in[i] != b);
+  }
+  errors += (count != expect);
+
+  utl::math::bound(xs.data(), N, T(-5), T(5), out.data());
+  for (std::size_t i = 0; i != N; ++i)
+  {
+    errors += (out[i] != utl::math::bound(xs[i], T(-5), T(5)));
+  }
+  utl::math::bound(xs.data(), N, T(5), T(-5), out.data());   // min > max
+  for (std::size_t i = 0; i != N; ++i)
+  {
+    errors += (out[i] != utl::math::bound(xs[i], T(5), T(-5)));
+  }
+
+  for (std::size_t i = 0; i != N; ++i) { xs[i] *= 97; }
+  utl::math::standard_deg(xs.data(), N, out.data());
+  for (std::size_t i = 0; i != N; ++i)
+  {
+    errors += (std::abs(out[i] - utl::math::standard_deg(xs[i])) > T(1e-3));
+  }
+
+  utl::math::deg_to_rad(xs.data(), N, rad.data());
+  for (std::size_t i = 0; i != N; ++i)
+  {
+    errors += (rad[i] != utl::math::deg_to_rad(xs[i]));
+  }
+
+  std::cout << "  batch " << type_name << " : " << count << " of " << N
+            << " in radius, " << errors << " errors" << std::endl;
+}
+
 } // anonymous --------------------------------------------------------------
 
 
@@ -94,6 +156,12 @@ main(int argc, char* argv[])
   in_radius_test(double(3.0), double(4.0), double(5.1));
   std::cout << std::endl;
 
+  std::cout << "batch functions" <<'\n'<<'\n';
+  batch_test<int>("int");
+  batch_test<float>("float");
+  batch_test<double>("double");
+  std::cout << std::endl;
+
 //  // parameters (x, lower, upper)
 //
 //  in_range_test(char(0), char(-1), char(1));
@@ -0,0 +1,203 @@
+//===========================================================================//
+//  Nathan Lucas
+//  2018
+//===========================================================================//
+
+#define UTL_PROFILE
+#include "utl/profile.hpp"
+
+#include <cmath>        // std::sqrt
+#include <fstream>      // std::ofstream
+#include <iostream>     // std::cout, std::endl
+#include <thread>       // std::thread
+
+#include "utl_test.hpp"  // utl_test::test_label
+
+namespace {   //-------------------------------------------------------------
+
+volatile double sink = 0;   // keep results observable
+
+void
+work(unsigned n)
+{
+  double x = 0;
+  for (unsigned i = 0; i != n; ++i) { x += std::sqrt(double(i)); }
+  sink = x;
+}
+
+void
+draw()
+{
+  UTL_PROFILE_FUNCTION();
+  work(20000);
+}
+
+void
+frame()
+{
+  UTL_PROFILE_SCOPE("frame");
+  draw();
+  {
+    UTL_PROFILE_SCOPE("text");
+    work(5000);
+  }
+}
+
+void
+writer()
+{
+  UTL_PROFILE_THREAD("writer");
+  for (unsigned i = 0; i != 50; ++i)
+  {
+    UTL_PROFILE_SCOPE("write");
+    work(10000);
+  }
+}
+
+void
+test_report(int& n)
+{
+  utl_test::test_label(n, "utl::profile::report");
+
+  UTL_PROFILE_THREAD("main");
+  std::thread t(writer);
+  for (unsigned i = 0; i != 100; ++i) { frame(); }
+  t.join();
+
+  utl::profile::report_type r = utl::profile::report();
+  std::cout << r << '\n';
+
+  // Nested zones cannot take longer than their parent.
+  bool nested = true;
+  for (auto const& z : r)
+  {
+    if (z.name == "draw") { nested &= (z.total <= r[0].total); }
+  }
+  std::cout << "  zones : " << r.size() << " (expect 4)\n"
+            << "  frame count : " << r[0].count << " (expect 100)\n"
+            << "  nested within parent : " << (nested ? "true" : "false")
+            << '\n' << std::endl;
+}
+
+void
+test_chrome_trace(int& n)
+{
+  utl_test::test_label(n, "utl::profile::chrome_trace");
+
+  utl::json::json trace = utl::profile::chrome_trace();
+  std::cout << "  trace events : " << trace["traceEvents"].size()
+            << " (expect 352)\n";
+  std::ofstream("profile_trace.json") << trace;
+  std::cout << "  wrote profile_trace.json\n";
+
+  utl::profile::clear();
+  std::cout << "  zones after clear : " << utl::profile::report().size()
+            << '\n' << std::endl;
+}
+
+void
+test_open_parent(int& n)
+{
+  utl_test::test_label(n, "utl::profile::report with an unfinished zone");
+
+  {
+    UTL_PROFILE_SCOPE("done");
+    UTL_PROFILE_SCOPE("done child");
+  }
+  {
+    UTL_PROFILE_SCOPE("open");
+    {
+      UTL_PROFILE_SCOPE("open child");
+    }
+    // "open" has not ended, so its child is left out rather than
+    // attached to "done" or to the thread.
+    utl::profile::report_type r = utl::profile::report();
+    std::cout << r;
+    std::cout << "  zones : " << r.size() << " (expect 2)\n";
+  }
+  utl::profile::report_type r = utl::profile::report();
+  std::cout << "  zones after it ends : " << r.size() << " (expect 4)\n"
+            << '\n' << std::endl;
+  utl::profile::clear();
+}
+
+void
+test_dropped(int& n)
+{
+  utl_test::test_label(n, "utl::profile buffer limit");
+
+  std::size_t const extra = 10;
+  for (std::size_t i = 0; i != (UTL_PROFILE_MAX_EVENTS + extra); ++i)
+  {
+    UTL_PROFILE_SCOPE("zone");
+  }
+  utl::profile::report_type r = utl::profile::report();
+  std::cout << r
+            << "  recorded : " << r[0].count << " (expect "
+            << UTL_PROFILE_MAX_EVENTS << ")\n"
+            << "  dropped : " << r[0].dropped << " (expect " << extra << ")\n";
+  utl::profile::clear();
+  {
+    UTL_PROFILE_SCOPE("zone");
+  }
+  r = utl::profile::report();
+  std::cout << "  dropped after clear : " << r[0].dropped << " (expect 0)\n"
+            << std::endl;
+  utl::profile::clear();
+}
+
+void
+test_thread_exit(int& n)
+{
+  utl_test::test_label(n, "utl::profile logs of finished threads");
+
+  for (unsigned i = 0; i != 8; ++i)
+  {
+    std::thread t([]() { UTL_PROFILE_SCOPE("short"); });
+    t.join();
+    utl::profile::report();   // reading the zones frees the log for reuse
+  }
+  // Logs of "main" and "writer" from the first test, the latter reused by
+  // each short thread in turn:  two thread names and one zone.
+  utl::json::json trace = utl::profile::chrome_trace();
+  std::cout << "  trace events : " << trace["traceEvents"].size()
+            << " (expect 3)\n" << std::endl;
+  utl::profile::clear();
+}
+
+void
+test_overhead(int& n)
+{
+  utl_test::test_label(n, "UTL_PROFILE_SCOPE overhead");
+
+  std::size_t const N = 100000;
+  auto t0 = utl::chrono::tsc_clock::now();
+  for (std::size_t i = 0; i != N; ++i)
+  {
+    UTL_PROFILE_SCOPE("empty");
+  }
+  auto dt = utl::chrono::tsc_clock::now() - t0;
+  std::cout << "  " << (double(dt.count()) / N) << " ns per zone\n"
+            << std::endl;
+  utl::profile::clear();
+}
+
+} // anonymous --------------------------------------------------------------
+
+
+int
+main(int argc, char* argv[])
+{
+  int n = 0;  // test number
+
+  test_report(n);
+  test_chrome_trace(n);
+  test_open_parent(n);
+  test_dropped(n);
+  test_thread_exit(n);
+  test_overhead(n);
+
+  return 0;
+}
+
+//===========================================================================//
@@ -0,0 +1,146 @@
+//===========================================================================//
+//  Nathan Lucas
+//  2018
+//===========================================================================//
+
+#include "utl/random.hpp"
+#include "utl/randomize.hpp"
+#include "utl/chrono.hpp"   // utl::chrono::timer
+
+#include <algorithm>    // std::shuffle
+#include <chrono>       // std::chrono::system_clock
+#include <cstdint>      // std::uint64_t
+#include <iomanip>      // std::setw
+#include <iostream>     // std::cout
+#include <numeric>      // std::iota
+#include <random>       // std::default_random_engine, std::mt19937_64,
+                        // std::normal_distribution,
+                        // std::uniform_real_distribution
+#include <string>       // std::string
+#include <vector>       // std::vector
+
+namespace {   //-------------------------------------------------------------
+
+typedef utl::chrono::timer::ms ms;
+
+volatile std::uint64_t sink = 0;    // keep results observable
+
+void
+report(std::string const& name, double ms_elapsed, double count)
+{
+  std::cout << "  " << std::left << std::setw(32) << name << std::right
+            << std::setw(10) << ms_elapsed << " ms"
+            << std::setw(10) << (count / (ms_elapsed * 1000.0)) << " M/s"
+            << std::endl;
+}
+
+template<typename Engine>
+void
+bench_engine(std::string const& name, Engine engine)
+{
+  std::size_t const N = 100000000;
+  utl::chrono::timer tmr;
+  std::uint64_t x = 0;
+  for (std::size_t i = 0; i != N; ++i) { x += engine(); }
+  sink = x;
+  report(name, tmr.elapsed<ms>().count(), N);
+}
+
+// Implementation of utl::randomize prior to utl::random.
+template<typename T>
+void
+randomize_clock(std::vector<T>& vec)
+{
+  unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
+  auto engine = std::default_random_engine(seed);
+  std::shuffle(std::begin(vec), std::end(vec), engine);
+}
+
+} // anonymous --------------------------------------------------------------
+
+
+int
+main(int argc, char* argv[])
+{
+  std::cout << "engine throughput (100M values)\n" << std::endl;
+  bench_engine("std::default_random_engine", std::default_random_engine(1));
+  bench_engine("std::mt19937_64", std::mt19937_64(1));
+  bench_engine("utl::random::splitmix64", utl::random::splitmix64(1));
+  bench_engine("utl::random::xoshiro256ss", utl::random::xoshiro256ss(1));
+  bench_engine("utl::random::pcg64", utl::random::pcg64(1));
+  std::cout << std::endl;
+
+  //-----------------------------------------------------------------
+
+  std::cout << "bulk variates (16M values)\n" << std::endl;
+  {
+    std::size_t const M = 1 << 24;
+    std::vector<double> v(M);
+    utl::random::xoshiro256ss engine(1);
+
+    std::uniform_real_distribution<double> ud(0.0, 1.0);
+    utl::chrono::timer tmr;
+    for (double& x : v) { x = ud(engine); }
+    report("std::uniform_real_distribution", tmr.elapsed<ms>().count(), M);
+    tmr.reset();
+    utl::random::fill_uniform(v.data(), M, 0.0, 1.0, engine);
+    report("utl::random::fill_uniform", tmr.elapsed<ms>().count(), M);
+
+    std::normal_distribution<double> nd(0.0, 1.0);
+    tmr.reset();
+    for (double& x : v) { x = nd(engine); }
+    report("std::normal_distribution", tmr.elapsed<ms>().count(), M);
+    tmr.reset();
+    utl::random::fill_normal(v.data(), M, 0.0, 1.0, engine);
+    report("utl::random::fill_normal", tmr.elapsed<ms>().count(), M);
+    sink = static_cast<std::uint64_t>(v[M / 2] * 1000);
+  }
+  std::cout << std::endl;
+
+  //-----------------------------------------------------------------
+
+  std::cout << "randomize small vector (1M calls, 64 elements)\n" << std::endl;
+  {
+    std::size_t const calls = 1000000;
+    std::vector<int> v(64);
+    std::iota(v.begin(), v.end(), 0);
+    utl::chrono::timer tmr;
+    for (std::size_t i = 0; i != calls; ++i) { randomize_clock(v); }
+    report("clock seed + std::shuffle", tmr.elapsed<ms>().count(), calls);
+    tmr.reset();
+    for (std::size_t i = 0; i != calls; ++i) { utl::randomize(v); }
+    report("utl::randomize", tmr.elapsed<ms>().count(), calls);
+  }
+  std::cout << std::endl;
+
+  //-----------------------------------------------------------------
+
+  std::size_t const N = 1 << 24;
+  std::cout << "shuffle large vector (" << N << " elements)\n" << std::endl;
+  {
+    std::vector<unsigned> v(N);
+    std::iota(v.begin(), v.end(), 0);
+    utl::chrono::timer tmr;
+    randomize_clock(v);
+    report("clock seed + std::shuffle", tmr.elapsed<ms>().count(), N);
+
+    utl::random::xoshiro256ss engine(1);
+    tmr.reset();
+    utl::random::shuffle(v.begin(), v.end(), engine);
+    report("utl::random::shuffle", tmr.elapsed<ms>().count(), N);
+
+    for (unsigned threads : { 2u, 4u, 8u, 0u })
+    {
+      tmr.reset();
+      utl::random::parallel_shuffle(v.begin(), v.end(), engine, threads);
+      std::string name = "utl::random::parallel_shuffle ";
+      name += (threads ? std::to_string(threads) : std::string("max"));
+      report(name, tmr.elapsed<ms>().count(), N);
+    }
+  }
+  std::cout << std::endl;
+
+  return 0;
+}
+
+//===========================================================================//
@@ -0,0 +1,270 @@
+//===========================================================================//
+//  Nathan Lucas
+//  2018
+//===========================================================================//
+
+#include "utl/random.hpp"
+
+#include <algorithm>    // std::sort
+#include <cmath>        // std::sqrt
+#include <cstdint>      // std::int8_t, std::uint64_t
+#include <iostream>     // std::cout, std::endl
+#include <numeric>      // std::iota
+#include <set>          // std::set
+#include <stdexcept>    // std::invalid_argument
+#include <thread>       // std::thread
+#include <vector>       // std::vector
+
+#include "utl_test.hpp"  // utl_test::test_label
+
+namespace {   //-------------------------------------------------------------
+
+template<typename Engine>
+void
+print_sequence(char const* name, Engine engine)
+{
+  std::cout << "  " << name << " :";
+  for (unsigned i = 0; i != 3; ++i) { std::cout << ' ' << engine(); }
+  std::cout << '\n';
+}
+
+void
+test_engines(int& n)
+{
+  utl_test::test_label(n, "engines");
+
+  // Same seed, same sequence.
+  print_sequence("splitmix64(42)  ", utl::random::splitmix64(42));
+  print_sequence("splitmix64(42)  ", utl::random::splitmix64(42));
+  print_sequence("xoshiro256ss(42)", utl::random::xoshiro256ss(42));
+  print_sequence("xoshiro256ss(42)", utl::random::xoshiro256ss(42));
+  print_sequence("pcg64(42, 0)    ", utl::random::pcg64(42, 0));
+  print_sequence("pcg64(42, 1)    ", utl::random::pcg64(42, 1));
+
+  utl::random::xoshiro256ss a(7), b(7);
+  b.jump();
+  std::cout << "  jump changes state : " << (a != b ? "true" : "false")
+            << '\n' << std::endl;
+}
+
+void
+test_thread_engine(int& n)
+{
+  utl_test::test_label(n, "utl::random::thread_engine");
+
+  // Threads seeded from entropy get different sequences.
+  std::uint64_t v[2];
+  std::thread t0([&v]{ v[0] = utl::random::thread_engine()(); });
+  std::thread t1([&v]{ v[1] = utl::random::thread_engine()(); });
+  t0.join();
+  t1.join();
+  std::cout << "  distinct threads differ : "
+            << (v[0] != v[1] ? "true" : "false") << '\n';
+
+  // Explicit seed gives a reproducible sequence.
+  utl::random::seed(42);
+  std::uint64_t x = utl::random::thread_engine()();
+  std::cout << "  seed(42) matches xoshiro256ss(42) : "
+            << (x == utl::random::xoshiro256ss(42)() ? "true" : "false")
+            << '\n' << std::endl;
+}
+
+void
+test_uniform_index(int& n)
+{
+  utl_test::test_label(n, "utl::random::uniform_index");
+
+  // Chi-square statistic for 10 bins; expect about 9 (df = 9).
+  utl::random::xoshiro256ss engine(1);
+  unsigned const bins = 10;
+  unsigned const N = 1000000;
+  std::vector<unsigned> counts(bins);
+  for (unsigned i = 0; i != N; ++i)
+  {
+    ++counts[utl::random::uniform_index(engine, bins)];
+  }
+  double chi2 = 0;
+  double const expect = double(N) / bins;
+  for (unsigned c : counts) { chi2 += ((c - expect) * (c - expect)) / expect; }
+  std::cout << "  chi-square (df = 9) : " << chi2 << '\n' << std::endl;
+}
+
+template<typename T>
+void
+print_moments(char const* name, std::vector<T> const& v)
+{
+  double sum = 0, sq = 0;
+  for (T x : v) { sum += x; sq += double(x) * x; }
+  double const mean = sum / v.size();
+  std::cout << "  " << name << " : mean = " << mean
+            << ", SD = " << std::sqrt((sq / v.size()) - (mean * mean)) << '\n';
+}
+
+void
+test_distributions(int& n)
+{
+  utl_test::test_label(n, "utl::random bulk variates");
+
+  std::size_t const N = 1000000;
+  utl::random::xoshiro256ss engine(5);
+
+  std::vector<double> d(N);
+  utl::random::fill_uniform(d.data(), N, -1.0, 1.0, engine);
+  print_moments("fill_uniform [-1,1) double (expect 0, 0.577)", d);
+
+  std::vector<float> f(N);
+  utl::random::fill_uniform(f.data(), N, 0.0f, 1.0f, engine);
+  print_moments("fill_uniform [0,1)  float  (expect 0.5, 0.289)", f);
+
+  std::vector<int> k(N);
+  utl::random::fill_uniform_int(k.data(), N, 1, 6, engine);
+  print_moments("fill_uniform_int [1,6]     (expect 3.5, 1.708)", k);
+  std::cout << "  fill_uniform_int in range : "
+            << ((*std::min_element(k.begin(), k.end()) == 1) &&
+                (*std::max_element(k.begin(), k.end()) == 6) ? "true" : "false")
+            << '\n';
+
+  // Types narrower than int, with ranges spanning zero.
+  std::vector<std::int8_t> k8(N);
+  utl::random::fill_uniform_int<std::int8_t>(k8.data(), N, -128, 0, engine);
+  std::vector<short> ks(N);
+  utl::random::fill_uniform_int<short>(ks.data(), N, -10, 5, engine);
+  std::cout << "  fill_uniform_int int8_t [-128,0] in range : "
+            << ((*std::min_element(k8.begin(), k8.end()) == -128) &&
+                (*std::max_element(k8.begin(), k8.end()) == 0) ? "true" : "false")
+            << '\n'
+            << "  fill_uniform_int short [-10,5] in range : "
+            << ((*std::min_element(ks.begin(), ks.end()) == -10) &&
+                (*std::max_element(ks.begin(), ks.end()) == 5) ? "true" : "false")
+            << '\n';
+
+  utl::random::fill_normal(d.data(), N, 10.0, 2.0, engine);
+  print_moments("fill_normal (10, 2)        (expect 10, 2)   ", d);
+
+  // Tail beyond 3 SD; expect about 0.0027.
+  std::size_t tail = 0;
+  for (double x : d) { tail += ((x < 4.0) || (x > 16.0)); }
+  std::cout << "  fill_normal beyond 3 SD : " << (double(tail) / N)
+            << " (expect 0.0027)\n" << std::endl;
+}
+
+void
+test_sample(int& n)
+{
+  utl_test::test_label(n, "utl::random sampling");
+
+  utl::random::xoshiro256ss engine(9);
+
+  // Each of 10 elements should be selected about 3/10 of the time.
+  std::vector<int> v(10);
+  std::iota(v.begin(), v.end(), 0);
+  std::vector<unsigned> counts(v.size());
+  unsigned const trials = 100000;
+  bool distinct = true;
+  for (unsigned t = 0; t != trials; ++t)
+  {
+    std::vector<int> s = utl::random::sample(v.begin(), v.end(), 3, engine);
+    distinct &= (std::set<int>(s.begin(), s.end()).size() == 3);
+    for (int x : s) { ++counts[x]; }
+  }
+  std::cout << "  sample 3 of 10 (expect 0.3 each) :";
+  for (unsigned c : counts) { std::cout << ' ' << (double(c) / trials); }
+  std::cout << "\n  sample distinct : " << (distinct ? "true" : "false") << '\n';
+
+  std::vector<double> const weights = { 1, 2, 0, 5 };
+  utl::random::alias_table table(weights);
+  std::fill(counts.begin(), counts.end(), 0);
+  for (unsigned t = 0; t != trials; ++t) { ++counts[table(engine)]; }
+  std::cout << "  alias_table {1,2,0,5} (expect 0.125 0.25 0 0.625) :";
+  for (std::size_t i = 0; i != weights.size(); ++i)
+  {
+    std::cout << ' ' << (double(counts[i]) / trials);
+  }
+  std::cout << '\n';
+
+  std::fill(counts.begin(), counts.end(), 0);
+  for (unsigned t = 0; t != trials; ++t)
+  {
+    ++counts[utl::random::weighted_sample(weights, 2, engine)[0]];
+  }
+  std::cout << "  weighted_sample first (expect 0.125 0.25 0 0.625) :";
+  for (std::size_t i = 0; i != weights.size(); ++i)
+  {
+    std::cout << ' ' << (double(counts[i]) / trials);
+  }
+  std::cout << "\n  weighted_sample skips zero weight : "
+            << (utl::random::weighted_sample(weights, 4, engine).size() == 3
+                ? "true" : "false") << '\n';
+
+  bool thrown = false;
+  try { utl::random::weighted_sample({ 1, -1, 2 }, 2, engine); }
+  catch (std::invalid_argument const&) { thrown = true; }
+  std::cout << "  weighted_sample rejects negative weight : "
+            << (thrown ? "true" : "false") << '\n' << std::endl;
+}
+
+void
+test_shuffle(int& n)
+{
+  utl_test::test_label(n, "utl::random::shuffle");
+
+  std::vector<int> v(8);
+  for (unsigned i = 0; i != 3; ++i)
+  {
+    std::iota(v.begin(), v.end(), 0);
+    utl::random::xoshiro256ss engine(i / 2);  // first two are identical
+    utl::random::shuffle(v.begin(), v.end(), engine);
+    std::cout << "  seed " << (i / 2) << " : {";
+    for (int x : v) { std::cout << ' ' << x; }
+    std::cout << " }\n";
+  }
+  std::cout << std::endl;
+}
+
+void
+test_parallel_shuffle(int& n)
+{
+  utl_test::test_label(n, "utl::random::parallel_shuffle");
+
+  std::size_t const N = 1 << 20;
+  std::vector<unsigned> v(N), w(N);
+  std::iota(v.begin(), v.end(), 0);
+  w = v;
+
+  utl::random::xoshiro256ss e1(3), e2(3);
+  utl::random::parallel_shuffle(v.begin(), v.end(), e1, 4);
+  utl::random::parallel_shuffle(w.begin(), w.end(), e2, 4);
+  std::cout << "  reproducible : " << (v == w ? "true" : "false") << '\n';
+
+  // Fraction of elements left in place; expect about 1/N.
+  std::size_t fixed = 0;
+  for (std::size_t i = 0; i != N; ++i) { fixed += (v[i] == i); }
+  std::cout << "  fixed points : " << fixed << " (expect about 1)\n";
+
+  std::sort(v.begin(), v.end());
+  bool permutation = true;
+  for (std::size_t i = 0; i != N; ++i) { permutation &= (v[i] == i); }
+  std::cout << "  permutation  : " << (permutation ? "true" : "false")
+            << '\n' << std::endl;
+}
+
+} // anonymous --------------------------------------------------------------
+
+
+int
+main(int argc, char* argv[])
+{
+  int n = 0;  // test number
+
+  test_engines(n);
+  test_thread_engine(n);
+  test_uniform_index(n);
+  test_distributions(n);
+  test_sample(n);
+  test_shuffle(n);
+  test_parallel_shuffle(n);
+
+  return 0;
+}
+
+//===========================================================================//
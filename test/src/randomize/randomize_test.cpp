@@ -38,6 +38,15 @@ main(int argc, char* argv[])
     print_vector(vv);
   }
 
+  std::cout << "\nseeded (pairs are identical)...\n\n";
+
+  for (unsigned i = 0; i != 4; ++i)
+  {
+    std::vector<int> vv(v);
+    utl::randomize(vv, i / 2);
+    print_vector(vv);
+  }
+
   return 0;
 }
 
@@ -0,0 +1,254 @@
+//===========================================================================//
+//  Nathan Lucas
+//  2018
+//===========================================================================//
+
+#include <utl/serialize.hpp>    // utl::encode, utl::decode, UTL_SERIALIZE
+
+#include <array>      // std::array
+#include <chrono>     // std::chrono::steady_clock
+#include <cstdint>    // std::int8_t, std::int64_t, std::uint8_t, std::uint64_t
+#include <cstdlib>    // std::strtod, std::strtol
+#include <iomanip>    // std::setw
+#include <iostream>   // std::cout, std::endl
+#include <limits>     // std::numeric_limits
+#include <string>     // std::string
+#include <vector>     // std::vector
+
+#include "utl_test.hpp"  // utl_test::test_label
+
+namespace test {
+
+enum class side : std::uint8_t { buy, sell };
+
+struct level
+{
+  double        price;
+  std::int64_t  size;
+};
+
+struct quote
+{
+  std::string         symbol;
+  side                dir;
+  std::uint64_t       sequence;
+  std::vector<level>  levels;
+  std::array<float, 2> range;
+  bool                last;
+};
+
+} // test
+
+UTL_SERIALIZE(test::level, price, size)
+UTL_SERIALIZE(test::quote, symbol, dir, sequence, levels, range, last)
+
+namespace {   //-------------------------------------------------------------
+
+template<typename T>
+std::string
+encoded(T const& v)
+{
+  std::string s;
+  utl::encode(s, v);
+  return s;
+}
+
+std::string
+hex(std::string const& s)
+{
+  static char const digits[] = "0123456789abcdef";
+  std::string h;
+  for (unsigned char c : s)
+  {
+    if (!h.empty()) { h += ' '; }
+    h += digits[c >> 4];
+    h += digits[c & 0xF];
+  }
+  return h;
+}
+
+template<typename T>
+bool
+round_trip(T const& v)
+{
+  std::string const s = encoded(v);
+  T w{};
+  return (utl::decode(s.data(), s.size(), w) && (w == v) &&
+          (s.size() == utl::encoded_size(v)));
+}
+
+test::quote
+sample()
+{
+  return test::quote{ "ABC", test::side::sell, 123456789,
+                      { { 101.25, 300 }, { 101.5, -20 } },
+                      {{ 1.5f, -2.0f }}, true };
+}
+
+void
+test_scalars(int& n)
+{
+  utl_test::test_label(n, "utl::serialize scalars");
+
+  std::cout << "0u, 127u, 128u, 300u:       " << hex(encoded(0u)) << " | "
+            << hex(encoded(127u)) << " | " << hex(encoded(128u)) << " | "
+            << hex(encoded(300u)) << '\n'
+            << "0, -1, 1, -64, 64:          " << hex(encoded(0)) << " | "
+            << hex(encoded(-1)) << " | " << hex(encoded(1)) << " | "
+            << hex(encoded(-64)) << " | " << hex(encoded(64)) << '\n'
+            << "uint64 max size:            "
+            << utl::encoded_size(std::numeric_limits<std::uint64_t>::max())
+            << '\n'
+            << "1.0f:                       " << hex(encoded(1.0f)) << '\n'
+            << "-2.5:                       " << hex(encoded(-2.5)) << '\n'
+            << "true, sell:                 " << hex(encoded(true)) << " | "
+            << hex(encoded(test::side::sell)) << '\n';
+
+  bool pass =
+      round_trip(std::numeric_limits<std::uint64_t>::max()) &&
+      round_trip(std::numeric_limits<std::int64_t>::min()) &&
+      round_trip(std::numeric_limits<std::int64_t>::max()) &&
+      round_trip(std::numeric_limits<std::int8_t>::min()) &&
+      round_trip(std::numeric_limits<double>::max()) &&
+      round_trip(-0.1f) && round_trip('x') && round_trip(false);
+  std::cout << "round trips:                " << (pass ? "pass" : "FAIL")
+            << std::endl;
+}
+
+void
+test_structs(int& n)
+{
+  utl_test::test_label(n, "UTL_SERIALIZE");
+
+  test::quote const q = sample();
+  std::string const s = encoded(q);
+  test::quote r;
+  bool const ok = utl::decode(s.data(), s.size(), r);
+  bool const same = ok && (r.symbol == q.symbol) && (r.dir == q.dir) &&
+                    (r.sequence == q.sequence) &&
+                    (r.levels.size() == 2) &&
+                    (r.levels[1].price == 101.5) && (r.levels[1].size == -20) &&
+                    (r.range == q.range) && r.last;
+  std::cout << "encoded size:               " << s.size() << " bytes\n"
+            << "round trip:                 " << (same ? "pass" : "FAIL")
+            << '\n'
+            << "vectors and strings:        "
+            << ((round_trip(std::vector<std::string>{ "", "a", "bc" }) &&
+                 round_trip(std::vector<bool>{ true, false, true }) &&
+                 round_trip(std::string(300, 'z')))
+                ? "pass" : "FAIL") << std::endl;
+}
+
+void
+test_malformed(int& n)
+{
+  utl_test::test_label(n, "utl::decode malformed data");
+
+  std::string const s = encoded(sample());
+  bool truncated = true;
+  for (std::size_t i = 0; i < s.size(); ++i)
+  {
+    test::quote r;
+    if (utl::decode(s.data(), i, r)) { truncated = false; }
+  }
+  test::quote r;
+  std::string const trailing = s + '\0';
+  std::uint8_t small;
+  std::string const big = encoded(300u);
+  std::string const bad_bool = "\x02";
+  bool b;
+  // Count of 2^32 elements in a 6-byte message.
+  std::string const huge = "\x80\x80\x80\x80\x10\x01";
+  std::vector<std::uint64_t> v;
+  std::string const long_varint(11, '\xFF');
+  std::uint64_t u;
+
+  std::cout << "every truncation rejected:  " << (truncated ? "pass" : "FAIL")
+            << '\n'
+            << "trailing byte rejected:     "
+            << (!utl::decode(trailing.data(), trailing.size(), r)
+                ? "pass" : "FAIL") << '\n'
+            << "out of range rejected:      "
+            << (!utl::decode(big.data(), big.size(), small) ? "pass" : "FAIL")
+            << '\n'
+            << "bool 2 rejected:            "
+            << (!utl::decode(bad_bool.data(), bad_bool.size(), b)
+                ? "pass" : "FAIL") << '\n'
+            << "huge count rejected:        "
+            << ((!utl::decode(huge.data(), huge.size(), v) &&
+                 (v.capacity() == 0)) ? "pass" : "FAIL") << '\n'
+            << "varint over 64 bits:        "
+            << (!utl::decode(long_varint.data(), long_varint.size(), u)
+                ? "pass" : "FAIL") << std::endl;
+}
+
+// Compares the binary encoding with a text encoding of the same quote.
+void
+test_speed(int& n)
+{
+  utl_test::test_label(n, "binary vs text encoding");
+
+  using clock = std::chrono::steady_clock;
+  constexpr int count = 200000;
+  test::quote const q = sample();
+  std::size_t check = 0;
+
+  auto start = clock::now();
+  std::string buf;
+  for (int i = 0; i != count; ++i)
+  {
+    buf.clear();
+    utl::encode(buf, q);
+    test::quote r;
+    utl::decode(buf.data(), buf.size(), r);
+    check += r.levels.size();
+  }
+  double const binary = std::chrono::duration<double, std::nano>(
+      clock::now() - start).count() / count;
+  std::size_t const binary_size = buf.size();
+
+  start = clock::now();
+  std::string text;
+  for (int i = 0; i != count; ++i)
+  {
+    text = q.symbol + ' ' + std::to_string(int(q.dir)) + ' ' +
+           std::to_string(q.sequence);
+    for (auto const& l : q.levels)
+    {
+      text += ' ' + std::to_string(l.price) + ' ' + std::to_string(l.size);
+    }
+    text += ' ' + std::to_string(q.range[0]) + ' ' + std::to_string(q.range[1])
+          + ' ' + std::to_string(q.last);
+    char* p = &text[q.symbol.size()];
+    std::strtol(p, &p, 10);
+    std::strtol(p, &p, 10);
+    for (std::size_t j = 0; j != (2 * q.levels.size()) + 3; ++j)
+    {
+      std::strtod(p, &p);
+    }
+    check += q.levels.size();
+  }
+  double const textual = std::chrono::duration<double, std::nano>(
+      clock::now() - start).count() / count;
+
+  std::cout << "binary:  " << std::setw(4) << binary_size << " bytes  "
+            << std::setw(6) << int(binary) << " ns encode + decode\n"
+            << "text:    " << std::setw(4) << text.size() << " bytes  "
+            << std::setw(6) << int(textual) << " ns format + parse\n"
+            << "(" << check << ")" << std::endl;
+}
+
+} // anonymous --------------------------------------------------------------
+
+int
+main()
+{
+  int n = 0;
+  test_scalars(n);
+  test_structs(n);
+  test_malformed(n);
+  test_speed(n);
+  return 0;
+}
+
+//===========================================================================//
@@ -0,0 +1,154 @@
+//===========================================================================//
+//  Nathan Lucas
+//  2018
+//===========================================================================//
+
+#include "utl/statistics.hpp"
+#include "utl/summation.hpp"
+
+#include <cstdint>      // std::uint64_t
+#include <iostream>     // std::cout, std::endl
+#include <limits>       // std::numeric_limits
+#include <stdexcept>    // std::invalid_argument
+#include <thread>       // std::thread
+#include <vector>       // std::vector
+
+#include "utl_test.hpp"  // utl_test::test_label
+
+namespace {   //-------------------------------------------------------------
+
+void
+test_running_stats(int& n)
+{
+  utl_test::test_label(n, "utl::running_stats");
+
+  utl::running_stats<int> a;
+  utl::running_stats<int> b;
+  utl::running_stats<int> all;
+  for (int i = 1; i <= 10; ++i)
+  {
+    ((i <= 4) ? a : b).add(i);
+    all.add(i);
+  }
+  a.merge(b);
+
+  std::cout << "  all    : " << all << '\n'
+            << "  merged : " << a << '\n'
+            << "  csv    : " << utl::csv(a) << '\n'
+            << "  expect : Mean[10] = 5.5, SD = 2.87228, Min = 1, Max = 10"
+            << '\n' << std::endl;
+}
+
+void
+test_exponential_average(int& n)
+{
+  utl_test::test_label(n, "utl::exponential_average");
+
+  utl::exponential_average<double> ema(0.5);
+  for (double v : { 8.0, 0.0, 0.0, 0.0 })
+  {
+    ema.add(v);
+    std::cout << "  add " << v << "  ->  " << ema << '\n';
+  }
+  std::cout << "  csv : " << utl::csv(ema) << '\n'
+            << "  expect : EMA[4] = 1" << '\n' << std::endl;
+}
+
+void
+test_quantile_histogram(int& n)
+{
+  utl_test::test_label(n, "utl::quantile_histogram");
+
+  // Values 1..100000 accumulated by four threads, then merged.
+  unsigned const threads = 4;
+  std::uint64_t const N = 100000;
+  std::vector<utl::quantile_histogram<std::uint64_t>> parts(threads);
+  std::vector<std::thread> workers;
+  for (unsigned t = 0; t != threads; ++t)
+  {
+    workers.emplace_back([&parts, t, threads, N]()
+    {
+      for (std::uint64_t v = (t + 1); v <= N; v += threads)
+      {
+        parts[t].add(v);
+      }
+    });
+  }
+  for (auto& w : workers) { w.join(); }
+
+  utl::quantile_histogram<std::uint64_t> qh;
+  for (auto const& p : parts) { qh.merge(p); }
+
+  std::cout << "  " << qh << '\n'
+            << "  csv : " << utl::csv(qh) << '\n'
+            << "  expect within 1.6% : p50 = 50000, p90 = 90000,"
+               " p99 = 99000, p99.9 = 99900, max = 100000" << '\n'
+            << "  memory : " << sizeof(qh) << " bytes" << '\n';
+
+  bool threw = false;
+  try
+  {
+    qh.quantile(std::numeric_limits<double>::quiet_NaN());
+  }
+  catch (std::invalid_argument const&)
+  {
+    threw = true;
+  }
+  std::cout << "  quantile(NaN) throws : " << (threw ? "pass" : "FAIL")
+            << '\n' << std::endl;
+}
+
+void
+test_summation(int& n)
+{
+  utl_test::test_label(n, "utl::Summation");
+
+  utl::Summation sm;
+  for (unsigned i = 1; i <= 10; ++i) { sm.add(i); }
+  std::cout << "  " << sm << '\n'
+            << "  csv : " << utl::csv(sm) << '\n'
+            << "  expect : Sum[10] = 55" << '\n' << std::endl;
+}
+
+void
+test_sharded_summation(int& n)
+{
+  utl_test::test_label(n, "utl::sharded_summation");
+
+  // Eight threads each add 1..100000.
+  unsigned const threads = 8;
+  unsigned const N = 100000;
+  utl::sharded_summation<> total;
+  std::vector<std::thread> workers;
+  for (unsigned t = 0; t != threads; ++t)
+  {
+    workers.emplace_back([&total, N]()
+    {
+      for (unsigned v = 1; v <= N; ++v) { total.add(v); }
+    });
+  }
+  for (auto& w : workers) { w.join(); }
+
+  std::cout << "  " << total << '\n'
+            << "  csv : " << utl::csv(total) << '\n'
+            << "  expect : Sum[800000] = 40000400000" << '\n' << std::endl;
+}
+
+} // anonymous --------------------------------------------------------------
+
+
+int
+main(int argc, char* argv[])
+{
+  int n = 0;  // test number
+
+  test_summation(n);
+  test_sharded_summation(n);
+  test_running_stats(n);
+  test_exponential_average(n);
+  test_quantile_histogram(n);
+
+  return 0;
+}
+
+//===========================================================================//
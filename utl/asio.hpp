@@ -39,8 +39,15 @@ SOFTWARE.
   http://www.boost.org/LICENSE_1_0.txt
 */
 
+#include <utl/asio/datagram.hpp>
+#include <utl/asio/io_service_pool.hpp>
+#include <utl/asio/local.hpp>
 #include <utl/asio/tcp/client.hpp>
+#include <utl/asio/tcp/coroutine.hpp>
+#include <utl/asio/tcp/framing.hpp>
+#include <utl/asio/tcp/message.hpp>
 #include <utl/asio/tcp/server.hpp>
+#include <utl/asio/udp.hpp>
 
 #endif // UTL_ASIO_HPP
 //===========================================================================//
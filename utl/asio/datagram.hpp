@@ -0,0 +1,520 @@
+/*
+Licensed under the MIT License <http://opensource.org/licenses/MIT>
+
+Copyright 2018 Nathan Lucas <nathan.lucas@wayne.edu>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+//===========================================================================//
+/// @file
+/// @brief    Datagram socket server and client.
+/// @details  Protocol-independent templates behind utl::io::udp and
+///           utl::io::unix_dgram.
+/// @author   Nathan Lucas
+/// @date     2018
+//===========================================================================//
+#ifndef UTL_IO_DATAGRAM_HPP
+#define UTL_IO_DATAGRAM_HPP
+
+#ifndef __cplusplus
+#error must be compiled as C++
+#endif
+
+//-----------------------------------------------------------
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+
+// The Asio C++ Library is released under Boost Software License.
+//  https://think-async.com/Asio/License
+//  http://www.boost.org/LICENSE_1_0.txt
+#include <asio.hpp>     // Asio library
+
+#pragma GCC diagnostic pop
+//-----------------------------------------------------------
+
+#include <utl/asio/detail/socket.hpp>  // utl::io::detail::remove_stale_socket
+#include <utl/asio/tcp/buffer.hpp>      // utl::io::tcp::shared_buffer
+
+#include <functional>   // std::function
+#include <string>       // std::string
+#include <vector>       // std::vector
+
+namespace utl { namespace io { namespace datagram {
+
+using tcp::shared_buffer;
+using tcp::make_shared_buffer;
+
+namespace detail {  //-------------------------------------------------------
+
+// Opens a socket and binds it to an endpoint.
+template<typename Socket, typename Endpoint>
+inline void
+bind(Socket& socket, Endpoint const& ep)
+{
+  socket.open(ep.protocol());
+  socket.bind(ep);
+}
+
+// Lets several receivers on one host share a port, as multicast
+// receivers must.
+template<typename Socket>
+inline void
+bind(Socket& socket, asio::ip::udp::endpoint const& ep)
+{
+  socket.open(ep.protocol());
+  socket.set_option(asio::ip::udp::socket::reuse_address(true));
+  socket.bind(ep);
+}
+
+#if defined(ASIO_HAS_LOCAL_SOCKETS)
+// Removes a socket file left behind by a previous socket.
+template<typename Socket>
+inline void
+bind(Socket& socket, asio::local::datagram_protocol::endpoint const& ep)
+{
+  io::detail::remove_stale_socket<asio::local::datagram_protocol>(ep);
+  socket.open(ep.protocol());
+  socket.bind(ep);
+}
+#endif
+
+// Returns true if a datagram from sender replies to messages written
+// to remote.
+template<typename Endpoint>
+inline bool
+is_reply(Endpoint const& sender, Endpoint const& remote)
+{
+  return (sender == remote);
+}
+
+// Members of a multicast group reply from their own addresses.
+inline bool
+is_reply(asio::ip::udp::endpoint const& sender,
+         asio::ip::udp::endpoint const& remote)
+{
+  return (remote.address().is_multicast() || (sender == remote));
+}
+
+// Returns a buffer handler that passes a copy of each message
+// to handler, followed by any further arguments.
+template<typename Handler, typename... Args>
+inline std::function<void(asio::const_buffer const&, Args...)>
+copy_to(Handler handler)
+{
+  return [handler](asio::const_buffer const& buf, Args... args)
+         {
+           char const* data = asio::buffer_cast<char const*>(buf);
+           handler(std::string(data, data + asio::buffer_size(buf)), args...);
+         };
+}
+
+} // detail -----------------------------------------------------------------
+
+/// @addtogroup utl_asio
+/// @{
+
+/// Default size of the read buffer in bytes, enough for any UDP datagram.
+/// Longer datagrams are truncated.
+constexpr std::size_t default_buffer_size = 65536;
+
+//---------------------------------------------------------------------------
+/// @brief  Datagram server that receives messages from any sender
+///         and writes messages to any endpoint.
+/// @tparam Protocol  Datagram protocol, such as `asio::ip::udp` or
+///                   `asio::local::datagram_protocol`.
+///
+/// Each datagram is one message, so no framing is needed.
+template<typename Protocol>
+class basic_server
+{
+public:
+
+  using endpoint_type = typename Protocol::endpoint;
+
+  /// Handler that receives a copy of each message and its sender.
+  using read_handler =
+        std::function<void(std::string const&, endpoint_type const&)>;
+
+  /// @brief  Handler that receives each message in place, and its sender.
+  ///
+  /// The buffer refers to the read buffer of the server, and is valid
+  /// only until the handler returns.
+  using buffer_handler =
+        std::function<void(asio::const_buffer const&, endpoint_type const&)>;
+
+  /// @brief  Construct a UDP server that discards received messages.
+  /// @param  [in]  port    UDP port number.
+  explicit
+  basic_server(unsigned short port)
+  : basic_server(endpoint_type(asio::ip::udp::v4(), port))
+  {}
+
+  /// @brief  Construct a UDP server.
+  /// @param  [in]  port    UDP port number.
+  /// @param  [in]  handler Callback to process a copy of received messages.
+  basic_server(unsigned short port, read_handler handler)
+  : basic_server(endpoint_type(asio::ip::udp::v4(), port), std::move(handler))
+  {}
+
+  /// @brief  Construct a server that discards received messages.
+  /// @param  [in]  ep      Endpoint to receive on.
+  explicit
+  basic_server(endpoint_type const& ep)
+  : basic_server(ep, default_buffer_size,
+                 [](asio::const_buffer const&, endpoint_type const&){})
+  {}
+
+  /// @brief  Construct a server.
+  /// @param  [in]  ep      Endpoint to receive on.
+  /// @param  [in]  handler Callback to process a copy of received messages.
+  basic_server(endpoint_type const& ep, read_handler handler)
+  : basic_server(ep, default_buffer_size,
+        detail::copy_to<read_handler, endpoint_type const&>(
+            std::move(handler)))
+  {}
+
+  /// @brief  Construct a server.
+  /// @param  [in]  ep          Endpoint to receive on.  A Unix domain
+  ///                           socket file left at its path is removed
+  ///                           if no socket is bound to it.
+  /// @param  [in]  buffer_size Size of the read buffer in bytes.
+  /// @param  [in]  handler     Callback to process received messages in
+  ///                           place, without allocation.
+  /// @throw  std::invalid_argument if @a buffer_size is `0`.
+  /// @throw  asio::system_error if @a ep is in use, including a Unix
+  ///         domain path held by a live socket or by another file.
+  basic_server(endpoint_type const& ep, std::size_t buffer_size,
+               buffer_handler handler)
+  : io_service_()
+  , socket_(io_service_)
+  , sender_()
+  , handler_(std::move(handler))
+  , read_buffer_(tcp::detail::checked_buffer_size(buffer_size))
+  {
+    detail::bind(socket_, ep);
+    do_receive();
+  }
+
+  /// @brief  Run the server loop.
+  ///
+  /// The run() function blocks until stop() is called.
+  void
+  run()
+  {
+    io_service_.run();
+  }
+
+  /// @brief  Close the socket and stop the server loop.
+  void
+  stop()
+  {
+    io_service_.post(
+        [this]()
+        {
+          asio::error_code ignored_ec;
+          socket_.close(ignored_ec);
+        });
+    io_service_.stop();
+  }
+
+  /// @brief  Sends the specified data to an endpoint.
+  void
+  write(std::string const& str, endpoint_type const& to)
+  {
+    write(make_shared_buffer(str), to);
+  }
+
+  /// @brief  Sends the specified shared data to an endpoint without
+  ///         copying it.
+  ///
+  /// To fan out to many receivers, write to a multicast group.
+  void
+  write(shared_buffer buf, endpoint_type const& to)
+  {
+    io_service_.post(
+        [this, buf, to]()
+        {
+          socket_.async_send_to(asio::buffer(*buf), to,
+              [buf](asio::error_code /*ec*/, std::size_t /*bytes_sent*/) {});
+        });
+  }
+
+  /// @brief  Receives messages sent to a multicast group.
+  ///
+  /// The server must be bound to the port the group is sent to, on
+  /// any address.  Must be called before run().
+  void
+  join(asio::ip::address const& group)
+  {
+    socket_.set_option(asio::ip::multicast::join_group(group));
+  }
+
+  /// Stops receiving messages sent to a multicast group.
+  void
+  leave(asio::ip::address const& group)
+  {
+    socket_.set_option(asio::ip::multicast::leave_group(group));
+  }
+
+  /// @brief  Sets a socket option.
+  ///
+  /// Must be called before run().
+  template<typename Option>
+  void
+  set_option(Option const& option)
+  {
+    socket_.set_option(option);
+  }
+
+  /// Returns the endpoint the server receives on.
+  endpoint_type
+  local_endpoint() const
+  {
+    return socket_.local_endpoint();
+  }
+
+  /// Get the Asio io_service associated with the object.
+  asio::io_service&
+  io_service()
+  {
+    return io_service_;
+  }
+
+private:
+
+  // Perform an asynchronous receive.
+  void
+  do_receive()
+  {
+    socket_.async_receive_from(asio::buffer(read_buffer_), sender_,
+        [this](asio::error_code ec, std::size_t bytes_received)
+        {
+          if (ec == asio::error::operation_aborted)
+          {
+            return;
+          }
+          if (!ec)
+          {
+            handler_(asio::buffer(read_buffer_.data(), bytes_received),
+                     sender_);
+          }
+          do_receive();
+        });
+  }
+
+  asio::io_service                io_service_;
+  typename Protocol::socket       socket_;
+  endpoint_type                   sender_;      // Sender of last message
+  buffer_handler                  handler_;     // To process messages
+  std::vector<char>               read_buffer_; // Buffer for incoming data
+
+};
+
+//---------------------------------------------------------------------------
+/// @brief  Datagram client that writes messages to one server and
+///         receives its replies.
+/// @tparam Protocol  Datagram protocol, such as `asio::ip::udp` or
+///                   `asio::local::datagram_protocol`.
+///
+/// The socket is not connected, so messages can be written whether
+/// or not the server is running.  Instead, datagrams from any endpoint
+/// other than the server are dropped, except that a client writing to a
+/// UDP multicast group receives from any sender, as each member of the
+/// group replies from its own address.
+template<typename Protocol>
+class basic_client
+{
+public:
+
+  using endpoint_type = typename Protocol::endpoint;
+
+  /// Handler that receives a copy of each message.
+  using read_handler =  std::function<void(std::string const&)>;
+
+  /// @brief  Handler that receives each message in place.
+  ///
+  /// The buffer refers to the read buffer of the client, and is valid
+  /// only until the handler returns.
+  using buffer_handler = std::function<void(asio::const_buffer const&)>;
+
+  /// @brief  Construct a UDP client.
+  /// @param  [in]  host    Name or numeric address string.
+  /// @param  [in]  service Service name or numeric port number string.
+  /// @param  [in]  handler Callback to process a copy of received messages.
+  /// @throws asio::system_error if the host cannot be resolved.
+  basic_client(std::string const& host, std::string const& service,
+               read_handler handler=[](std::string const&){})
+  : basic_client(resolve(host, service), std::move(handler))
+  {}
+
+  /// @brief  Construct a client.
+  /// @param  [in]  remote  Endpoint of the server.
+  /// @param  [in]  handler Callback to process a copy of received messages.
+  explicit
+  basic_client(endpoint_type const& remote,
+               read_handler handler=[](std::string const&){})
+  : basic_client(remote, default_buffer_size,
+                 detail::copy_to<read_handler>(std::move(handler)))
+  {}
+
+  /// @brief  Construct a client.
+  /// @param  [in]  remote      Endpoint of the server.
+  /// @param  [in]  buffer_size Size of the read buffer in bytes.
+  /// @param  [in]  handler     Callback to process received messages in
+  ///                           place, without allocation.
+  /// @throw  std::invalid_argument if @a buffer_size is `0`.
+  basic_client(endpoint_type const& remote, std::size_t buffer_size,
+               buffer_handler handler)
+  : io_service_()
+  , socket_(io_service_)
+  , remote_(remote)
+  , sender_()
+  , handler_(std::move(handler))
+  , read_buffer_(tcp::detail::checked_buffer_size(buffer_size))
+  {
+    socket_.open(remote.protocol());
+    do_receive();
+  }
+
+  /// @brief  Construct a client bound to a local endpoint.
+  /// @param  [in]  remote      Endpoint of the server.
+  /// @param  [in]  local       Endpoint to receive replies on.  A Unix
+  ///                           domain client must be bound to receive.
+  /// @param  [in]  buffer_size Size of the read buffer in bytes.
+  /// @param  [in]  handler     Callback to process received messages in
+  ///                           place, without allocation.
+  /// @throw  std::invalid_argument if @a buffer_size is `0`.
+  /// @throw  asio::system_error if @a local is in use.
+  basic_client(endpoint_type const& remote, endpoint_type const& local,
+               std::size_t buffer_size, buffer_handler handler)
+  : io_service_()
+  , socket_(io_service_)
+  , remote_(remote)
+  , sender_()
+  , handler_(std::move(handler))
+  , read_buffer_(tcp::detail::checked_buffer_size(buffer_size))
+  {
+    detail::bind(socket_, local);
+    do_receive();
+  }
+
+  /// @brief  Run the client loop.
+  ///
+  /// The run() function blocks until stop() is called.
+  void
+  run()
+  {
+    io_service_.run();
+  }
+
+  /// @brief  Close the socket and stop the client loop.
+  void
+  stop()
+  {
+    io_service_.post(
+        [this]()
+        {
+          asio::error_code ignored_ec;
+          socket_.close(ignored_ec);
+        });
+    io_service_.stop();
+  }
+
+  /// @brief  Sends the specified data to the server.
+  void
+  write(std::string const& str)
+  {
+    write(make_shared_buffer(str));
+  }
+
+  /// @brief  Sends the specified shared data to the server without
+  ///         copying it.
+  void
+  write(shared_buffer buf)
+  {
+    io_service_.post(
+        [this, buf]()
+        {
+          socket_.async_send_to(asio::buffer(*buf), remote_,
+              [buf](asio::error_code /*ec*/, std::size_t /*bytes_sent*/) {});
+        });
+  }
+
+  /// @brief  Sets a socket option, such as `asio::ip::multicast::hops`.
+  ///
+  /// Must be called before run().
+  template<typename Option>
+  void
+  set_option(Option const& option)
+  {
+    socket_.set_option(option);
+  }
+
+  /// Get the Asio io_service associated with the object.
+  asio::io_service&
+  io_service()
+  {
+    return io_service_;
+  }
+
+private:
+
+  // Returns the first endpoint of a host and service.
+  static endpoint_type
+  resolve(std::string const& host, std::string const& service)
+  {
+    asio::io_service ios;
+    typename Protocol::resolver resolver(ios);
+    return *resolver.resolve(typename Protocol::resolver::query(host, service));
+  }
+
+  // Perform an asynchronous receive.
+  void
+  do_receive()
+  {
+    socket_.async_receive_from(asio::buffer(read_buffer_), sender_,
+        [this](asio::error_code ec, std::size_t bytes_received)
+        {
+          if (ec == asio::error::operation_aborted)
+          {
+            return;
+          }
+          if (!ec && detail::is_reply(sender_, remote_))
+          {
+            handler_(asio::buffer(read_buffer_.data(), bytes_received));
+          }
+          do_receive();
+        });
+  }
+
+  asio::io_service                io_service_;
+  typename Protocol::socket       socket_;
+  endpoint_type                   remote_;      // Server endpoint
+  endpoint_type                   sender_;      // Sender of last message
+  buffer_handler                  handler_;     // To process messages
+  std::vector<char>               read_buffer_; // Buffer for incoming data
+
+};
+
+/// @}
+
+} } } // utl::io::datagram
+
+#endif // UTL_IO_DATAGRAM_HPP
+//===========================================================================//
@@ -0,0 +1,86 @@
+/*
+Licensed under the MIT License <http://opensource.org/licenses/MIT>
+
+Copyright 2018 Nathan Lucas <nathan.lucas@wayne.edu>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+//===========================================================================//
+/// @file
+/// @brief    Socket helpers.
+/// @details  Unix domain socket file handling shared by the stream and
+///           datagram transports.
+/// @author   Nathan Lucas
+/// @date     2018
+//===========================================================================//
+#ifndef UTL_IO_DETAIL_SOCKET_HPP
+#define UTL_IO_DETAIL_SOCKET_HPP
+
+#ifndef __cplusplus
+#error must be compiled as C++
+#endif
+
+//-----------------------------------------------------------
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+
+// The Asio C++ Library is released under Boost Software License.
+//  https://think-async.com/Asio/License
+//  http://www.boost.org/LICENSE_1_0.txt
+#include <asio.hpp>     // Asio library
+
+#pragma GCC diagnostic pop
+//-----------------------------------------------------------
+
+#if defined(ASIO_HAS_LOCAL_SOCKETS)
+
+#include <sys/stat.h>   // ::lstat, S_ISSOCK
+#include <unistd.h>     // ::unlink
+
+namespace utl { namespace io { namespace detail {
+
+// Removes the socket file at a Unix domain endpoint if no socket is
+// bound to it any more.  Anything else at the path is left for bind()
+// to report as in use:  a live socket, which accepts a probe connect,
+// or a file that is not a socket.
+template<typename Protocol>
+inline void
+remove_stale_socket(typename Protocol::endpoint const& ep)
+{
+  struct stat st;
+  if ((::lstat(ep.path().c_str(), &st) != 0) || !S_ISSOCK(st.st_mode))
+  {
+    return;
+  }
+  asio::io_service ios;
+  typename Protocol::socket probe(ios);
+  asio::error_code ec;
+  probe.connect(ep, ec);
+  if (ec == asio::error::connection_refused)
+  {
+    ::unlink(ep.path().c_str());
+  }
+}
+
+} } } // utl::io::detail
+
+#endif // ASIO_HAS_LOCAL_SOCKETS
+
+#endif // UTL_IO_DETAIL_SOCKET_HPP
+//===========================================================================//
@@ -0,0 +1,181 @@
+/*
+Licensed under the MIT License <http://opensource.org/licenses/MIT>
+
+Copyright 2018 Nathan Lucas <nathan.lucas@wayne.edu>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+//===========================================================================//
+/// @file
+/// @brief    Pool of Asio io_service objects.
+/// @details  Runs one io_service per thread and hands them out
+///           round-robin, so work can be spread across cores.
+/// @author   Nathan Lucas
+/// @date     2018
+//===========================================================================//
+#ifndef UTL_IO_SERVICE_POOL_HPP
+#define UTL_IO_SERVICE_POOL_HPP
+
+#ifndef __cplusplus
+#error must be compiled as C++
+#endif
+
+//-----------------------------------------------------------
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+
+// The Asio C++ Library is released under Boost Software License.
+//  https://think-async.com/Asio/License
+//  http://www.boost.org/LICENSE_1_0.txt
+#include <asio.hpp>     // Asio library
+
+#pragma GCC diagnostic pop
+//-----------------------------------------------------------
+
+#include <atomic>       // std::atomic
+#include <cstddef>      // std::size_t
+#include <memory>       // std::unique_ptr
+#include <thread>       // std::thread
+#include <vector>       // std::vector
+
+namespace utl { namespace io {
+
+/// @addtogroup utl_asio
+/// @{
+
+/// @brief  Pool of io_service objects, each run by its own thread.
+///
+/// Objects that belong to one io_service have all of their handlers
+/// invoked by one thread, so they need no further synchronization.
+class io_service_pool
+{
+public:
+
+  /// @brief  Construct a pool.
+  /// @param  [in]  size  Number of io_service objects, or `0` to use
+  ///                     `std::thread::hardware_concurrency()`.
+  explicit
+  io_service_pool(std::size_t size=1);
+
+  // Prohibit copying and assignment.
+  io_service_pool(io_service_pool const&) = delete;
+  io_service_pool& operator=(io_service_pool const&) = delete;
+
+  /// Returns the number of io_service objects.
+  std::size_t
+  size() const    { return services_.size(); }
+
+  /// Returns the io_service at index @a i.
+  asio::io_service&
+  get(std::size_t i)    { return *services_[i]; }
+
+  /// Returns the next io_service in round-robin order.
+  asio::io_service&
+  next();
+
+  /// @brief  Run every io_service.
+  ///
+  /// The first io_service is run by the calling thread and the rest by
+  /// new threads.  Blocks until stop() is called and all threads exit.
+  void
+  run();
+
+  /// Stop every io_service.
+  void
+  stop();
+
+  /// @brief  Let every io_service return from run() once it runs out of
+  ///         work.
+  ///
+  /// Unlike stop(), handlers already queued still run, as do the
+  /// completions of operations they cancel.
+  void
+  release();
+
+  /// Returns `true` while run() is running.
+  bool
+  running() const   { return running_.load(std::memory_order_acquire); }
+
+private:
+
+  std::vector<std::unique_ptr<asio::io_service>>        services_;
+  std::vector<std::unique_ptr<asio::io_service::work>>  work_;
+  std::atomic<std::size_t>                              next_;
+  std::atomic<bool>                                     running_;
+};
+
+/// @}
+
+//===========================================================================//
+// Implementation
+
+inline
+io_service_pool::io_service_pool(std::size_t size)
+: services_()
+, work_()
+, next_(0)
+, running_(false)
+{
+  if (size == 0) { size = std::thread::hardware_concurrency(); }
+  if (size == 0) { size = 1; }
+  for (std::size_t i = 0; i != size; ++i)
+  {
+    services_.emplace_back(new asio::io_service(1));  // one thread each
+    work_.emplace_back(new asio::io_service::work(*services_.back()));
+  }
+}
+
+inline asio::io_service&
+io_service_pool::next()
+{
+  return *services_[next_.fetch_add(1, std::memory_order_relaxed)
+                    % services_.size()];
+}
+
+inline void
+io_service_pool::run()
+{
+  running_.store(true, std::memory_order_release);
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < services_.size(); ++i)
+  {
+    asio::io_service& service = *services_[i];
+    threads.emplace_back([&service]() { service.run(); });
+  }
+  services_[0]->run();
+  for (auto& t : threads) { t.join(); }
+  running_.store(false, std::memory_order_release);
+}
+
+inline void
+io_service_pool::stop()
+{
+  for (auto& service : services_) { service->stop(); }
+}
+
+inline void
+io_service_pool::release()
+{
+  work_.clear();
+}
+
+} } // utl::io
+
+#endif // UTL_IO_SERVICE_POOL_HPP
+//===========================================================================//
@@ -0,0 +1,101 @@
+/*
+Licensed under the MIT License <http://opensource.org/licenses/MIT>
+
+Copyright 2018 Nathan Lucas <nathan.lucas@wayne.edu>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+//===========================================================================//
+/// @file
+/// @brief    Unix domain socket servers and clients.
+/// @details  Same-host transports with the same handler, write, run,
+///           and stop interface as utl::io::tcp, without the cost of
+///           the TCP/IP stack.
+/// @author   Nathan Lucas
+/// @date     2018
+//===========================================================================//
+#ifndef UTL_IO_LOCAL_HPP
+#define UTL_IO_LOCAL_HPP
+
+#ifndef __cplusplus
+#error must be compiled as C++
+#endif
+
+#include <utl/asio/datagram.hpp>    // utl::io::datagram::basic_server,
+                                    // utl::io::datagram::basic_client
+#include <utl/asio/tcp/client.hpp>  // utl::io::tcp::basic_client
+#include <utl/asio/tcp/server.hpp>  // utl::io::tcp::basic_server
+
+#if defined(ASIO_HAS_LOCAL_SOCKETS)
+
+namespace utl { namespace io {
+
+/// @addtogroup utl_asio
+/// @{
+
+/// @brief  Unix domain stream sockets.
+///
+/// Connections are the same utl::io::tcp::connection objects as for TCP,
+/// so framing, shared buffers, and write limits apply unchanged.
+namespace unix_stream {
+
+/// Unix domain endpoint:  a socket file path.
+using endpoint = asio::local::stream_protocol::endpoint;
+
+/// Unix domain stream server.
+using server = tcp::basic_server<asio::local::stream_protocol>;
+
+/// Unix domain stream client.
+using client = tcp::basic_client<asio::local::stream_protocol>;
+
+using tcp::connection;
+using tcp::connection_ptr;
+using tcp::connection_id;
+using tcp::shared_buffer;
+using tcp::make_shared_buffer;
+
+} // unix_stream
+
+/// Unix domain datagram sockets.
+namespace unix_dgram {
+
+/// Unix domain endpoint:  a socket file path.
+using endpoint = asio::local::datagram_protocol::endpoint;
+
+/// Unix domain datagram server.
+using server = datagram::basic_server<asio::local::datagram_protocol>;
+
+/// @brief  Unix domain datagram client.
+///
+/// To receive replies, a client must be bound to its own path.
+using client = datagram::basic_client<asio::local::datagram_protocol>;
+
+using datagram::shared_buffer;
+using datagram::make_shared_buffer;
+
+} // unix_dgram
+
+/// @}
+
+} } // utl::io
+
+#endif // ASIO_HAS_LOCAL_SOCKETS
+
+#endif // UTL_IO_LOCAL_HPP
+//===========================================================================//
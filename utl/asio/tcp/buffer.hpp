@@ -0,0 +1,345 @@
+/*
+Licensed under the MIT License <http://opensource.org/licenses/MIT>
+
+Copyright 2018 Nathan Lucas <nathan.lucas@wayne.edu>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+//===========================================================================//
+/// @file
+/// @brief    TCP write buffers.
+/// @details  Shared immutable buffers and bounded write queues.
+/// @author   Nathan Lucas
+/// @date     2018
+//===========================================================================//
+#ifndef UTL_IO_TCP_BUFFER_HPP
+#define UTL_IO_TCP_BUFFER_HPP
+
+#ifndef __cplusplus
+#error must be compiled as C++
+#endif
+
+//-----------------------------------------------------------
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wall"
+
+// The Asio C++ Library is released under Boost Software License.
+//  https://think-async.com/Asio/License
+//  http://www.boost.org/LICENSE_1_0.txt
+#include <asio.hpp>     // Asio library
+
+#pragma GCC diagnostic pop
+//-----------------------------------------------------------
+
+#include <atomic>       // std::atomic
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint64_t
+#include <deque>        // std::deque
+#include <memory>       // std::make_shared, std::shared_ptr
+#include <stdexcept>    // std::invalid_argument
+#include <string>       // std::string
+#include <utility>      // std::move
+#include <vector>       // std::vector
+
+namespace utl { namespace io { namespace tcp {
+
+/// @addtogroup utl_asio
+/// @{
+
+/// @brief  Immutable message that can be queued on many connections.
+///
+/// Writing a shared buffer to several connections queues the same
+/// allocation on each, rather than a copy per connection.
+typedef std::shared_ptr<std::string const> shared_buffer;
+
+/// Returns a shared buffer holding @a str.
+inline shared_buffer
+make_shared_buffer(std::string str)
+{
+  return std::make_shared<std::string const>(std::move(str));
+}
+
+//---------------------------------------------------------------------------
+/// What a write queue does when a write would exceed its high watermark.
+enum class slow_consumer
+{
+  drop_oldest,  ///< Discard the oldest unsent messages down to the low watermark.
+  keep_latest,  ///< Until congestion clears, keep only the newest unsent message.
+  disconnect    ///< Refuse the message; the connection is closed.
+};
+
+/// @brief  Limits on the memory held by a write queue.
+///
+/// A high watermark of `0` means the queue is unbounded.  A queue that
+/// reaches its high watermark is congested until it drains to its low
+/// watermark.
+struct write_limits
+{
+  /// Constructs unbounded limits.
+  write_limits()
+  : high_watermark(0)
+  , low_watermark(0)
+  , policy(slow_consumer::drop_oldest)
+  {}
+
+  /// @brief  Constructor.
+  /// @param  [in]  high    High watermark in bytes.
+  /// @param  [in]  low     Low watermark in bytes.
+  /// @param  [in]  policy  Action when the high watermark is exceeded.
+  write_limits(std::size_t high, std::size_t low,
+               slow_consumer policy=slow_consumer::drop_oldest)
+  : high_watermark(high)
+  , low_watermark((low < high) ? low : high)
+  , policy(policy)
+  {}
+
+  std::size_t   high_watermark;   ///< Bytes at which the policy applies.
+  std::size_t   low_watermark;    ///< Bytes at which congestion clears.
+  slow_consumer policy;           ///< Action at the high watermark.
+};
+
+/// Write queue depth and drop counts.
+struct write_stats
+{
+  std::size_t   queued_messages;  ///< Messages queued or being sent.
+  std::size_t   queued_bytes;     ///< Bytes queued or being sent.
+  std::size_t   peak_bytes;       ///< Largest value of queued_bytes.
+  std::uint64_t dropped_messages; ///< Messages discarded by the policy.
+  std::uint64_t dropped_bytes;    ///< Bytes discarded by the policy.
+  bool          congested;        ///< High watermark reached and not cleared.
+};
+
+//---------------------------------------------------------------------------
+/// @brief  Queue of outgoing messages with optional memory limits.
+///
+/// Messages are sent in gathered writes of up to 64 messages.  Messages
+/// being sent are never discarded.  Modifiers must be called from the
+/// thread that performs the writes; stats() may be called from any thread.
+class write_queue
+{
+public:
+
+  /// Largest number of messages sent by one gathered write;
+  /// Asio passes at most 64 buffers to each writev call.
+  static constexpr std::size_t max_gather = 64;
+
+  /// Constructor.
+  explicit
+  write_queue(write_limits const& limits=write_limits())
+  : limits_(limits)
+  , queue_()
+  , buffers_()
+  , in_flight_(0)
+  , messages_(0)
+  , bytes_(0)
+  , peak_(0)
+  , dropped_messages_(0)
+  , dropped_bytes_(0)
+  , congested_(false)
+  {}
+
+  /// Returns the limits.
+  write_limits const&
+  limits() const  { return limits_; }
+
+  /// Sets the limits, which apply from the next push().
+  void
+  limits(write_limits const& val)   { limits_ = val; }
+
+  /// Returns `true` if no message is queued or being sent.
+  bool
+  empty() const   { return queue_.empty(); }
+
+  /// Returns `true` if a gathered write is in progress.
+  bool
+  writing() const { return (in_flight_ != 0); }
+
+  /// @brief  Queues a message, applying the limits.
+  /// @return `false` if the message was refused under the
+  ///         slow_consumer::disconnect policy.
+  bool
+  push(shared_buffer buf);
+
+  /// @brief  Returns a buffer sequence over the next messages to send,
+  ///         and marks them as being sent.
+  std::vector<asio::const_buffer> const&
+  gather();
+
+  /// Removes the messages sent by the last gathered write.
+  void
+  pop_sent();
+
+  /// Discards every message.
+  void
+  clear();
+
+  /// Returns queue depth and drop counts.
+  write_stats
+  stats() const;
+
+private:
+
+  // Discards unsent message i.
+  void
+  drop(std::size_t i);
+
+  write_limits                      limits_;
+  std::deque<shared_buffer>         queue_;       // Being sent, then unsent
+  std::vector<asio::const_buffer>   buffers_;     // Gathered write
+  std::size_t                       in_flight_;   // Messages being sent
+  std::atomic<std::size_t>          messages_;
+  std::atomic<std::size_t>          bytes_;
+  std::atomic<std::size_t>          peak_;
+  std::atomic<std::uint64_t>        dropped_messages_;
+  std::atomic<std::uint64_t>        dropped_bytes_;
+  std::atomic<bool>                 congested_;
+};
+
+/// @}
+
+//===========================================================================//
+// Implementation
+
+namespace detail {  //-------------------------------------------------------
+
+// Returns n, which must be nonzero:  reads into an empty buffer complete
+// at once with no data, so the read loop would spin.
+inline std::size_t
+checked_buffer_size(std::size_t n)
+{
+  if (n == 0)
+  {
+    throw std::invalid_argument("utl::io: read buffer size must be nonzero");
+  }
+  return n;
+}
+
+} // detail -----------------------------------------------------------------
+
+inline bool
+write_queue::push(shared_buffer buf)
+{
+  std::size_t const size = buf->size();
+  std::size_t bytes = bytes_.load(std::memory_order_relaxed);
+  bool const over = ((limits_.high_watermark != 0) &&
+                     ((bytes + size) > limits_.high_watermark));
+  if (over)
+  {
+    congested_.store(true, std::memory_order_relaxed);
+    switch (limits_.policy)
+    {
+      case slow_consumer::disconnect:
+        dropped_messages_.fetch_add(1, std::memory_order_relaxed);
+        dropped_bytes_.fetch_add(size, std::memory_order_relaxed);
+        return false;
+      case slow_consumer::keep_latest:
+        break;
+      case slow_consumer::drop_oldest:
+        while ((queue_.size() > in_flight_) &&
+               ((bytes_.load(std::memory_order_relaxed) + size)
+                   > limits_.low_watermark))
+        {
+          drop(in_flight_);
+        }
+        break;
+    }
+  }
+  if ((limits_.policy == slow_consumer::keep_latest) &&
+      congested_.load(std::memory_order_relaxed))
+  {
+    // The new message replaces the unsent one until congestion clears.
+    while (queue_.size() > in_flight_) { drop(in_flight_); }
+  }
+  queue_.push_back(std::move(buf));
+  messages_.store(queue_.size(), std::memory_order_relaxed);
+  bytes = bytes_.fetch_add(size, std::memory_order_relaxed) + size;
+  if (bytes > peak_.load(std::memory_order_relaxed))
+  {
+    peak_.store(bytes, std::memory_order_relaxed);
+  }
+  return true;
+}
+
+inline std::vector<asio::const_buffer> const&
+write_queue::gather()
+{
+  buffers_.clear();
+  for (auto const& msg : queue_)
+  {
+    if (buffers_.size() == max_gather) { break; }
+    buffers_.push_back(asio::buffer(*msg));
+  }
+  in_flight_ = buffers_.size();
+  return buffers_;
+}
+
+inline void
+write_queue::pop_sent()
+{
+  std::size_t sent = 0;
+  for (std::size_t i = 0; i != in_flight_; ++i) { sent += queue_[i]->size(); }
+  queue_.erase(queue_.begin(), queue_.begin() + in_flight_);
+  messages_.store(queue_.size(), std::memory_order_relaxed);
+  in_flight_ = 0;
+  std::size_t const bytes = bytes_.fetch_sub(sent, std::memory_order_relaxed)
+                          - sent;
+  if (bytes <= limits_.low_watermark)
+  {
+    congested_.store(false, std::memory_order_relaxed);
+  }
+}
+
+inline void
+write_queue::clear()
+{
+  queue_.clear();
+  in_flight_ = 0;
+  messages_.store(0, std::memory_order_relaxed);
+  bytes_.store(0, std::memory_order_relaxed);
+  congested_.store(false, std::memory_order_relaxed);
+}
+
+inline write_stats
+write_queue::stats() const
+{
+  write_stats s;
+  s.queued_bytes     = bytes_.load(std::memory_order_relaxed);
+  s.queued_messages  = messages_.load(std::memory_order_relaxed);
+  s.peak_bytes       = peak_.load(std::memory_order_relaxed);
+  s.dropped_messages = dropped_messages_.load(std::memory_order_relaxed);
+  s.dropped_bytes    = dropped_bytes_.load(std::memory_order_relaxed);
+  s.congested        = congested_.load(std::memory_order_relaxed);
+  return s;
+}
+
+inline void
+write_queue::drop(std::size_t i)
+{
+  std::size_t const size = queue_[i]->size();
+  queue_.erase(queue_.begin() + i);
+  messages_.store(queue_.size(), std::memory_order_relaxed);
+  bytes_.fetch_sub(size, std::memory_order_relaxed);
+  dropped_messages_.fetch_add(1, std::memory_order_relaxed);
+  dropped_bytes_.fetch_add(size, std::memory_order_relaxed);
+}
+
+} } } // utl::io::tcp
+
+#endif // UTL_IO_TCP_BUFFER_HPP
+//===========================================================================//
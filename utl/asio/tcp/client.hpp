@@ -46,40 +46,328 @@ SOFTWARE.
 #pragma GCC diagnostic pop
 //-----------------------------------------------------------
 
-#include <array>        // std::array
+#include <utl/asio/tcp/buffer.hpp>  // utl::io::tcp::shared_buffer
+#include <utl/random/random_distribution.hpp> // utl::random::uniform01
+#include <utl/random/random_engine.hpp> // utl::random::thread_engine
+
+#include <atomic>       // std::atomic
+#include <chrono>       // std::chrono
+#include <cstdint>      // std::uint64_t
 #include <deque>        // std::deque
 #include <functional>   // std::function
 #include <string>       // std::string
+#include <vector>       // std::vector
 
 namespace utl { namespace io { namespace tcp {
 
 /// @addtogroup utl_asio
 /// @{
 
-/// TCP client that asynchronously reads and writes data.
-class client
+/// Connection state of a tcp::client.
+enum class client_state
+{
+  connecting,     ///< Resolving, connecting, or waiting to retry.
+  connected,      ///< Connected and reading.
+  disconnected    ///< Connection lost, retries exhausted, or stopped.
+};
+
+//---------------------------------------------------------------------------
+/// @brief  Schedule of reconnect attempts after a failed or lost
+///         connection.
+///
+/// Retry @a n waits `initial_delay * multiplier^(n-1)`, at most
+/// `max_delay`, scaled by a random factor in [1 - jitter, 1 + jitter]
+/// so that clients dropped at the same time do not retry in lockstep.
+/// Connections lost before any data arrives back off the same way, so
+/// a server that accepts and then drops the client is not hammered.
+struct reconnect_policy
+{
+  /// @brief  Constructor.
+  /// @param  [in]  initial   Delay before the first retry.
+  /// @param  [in]  max       Largest delay between retries.
+  /// @param  [in]  mult      Factor by which the delay grows per retry.
+  /// @param  [in]  jit       Fraction of the delay randomized, in [0, 1].
+  /// @param  [in]  attempts  Consecutive failures before giving up,
+  ///                         or `0` to retry forever.
+  reconnect_policy(
+      std::chrono::milliseconds initial=std::chrono::milliseconds(100),
+      std::chrono::milliseconds max=std::chrono::milliseconds(30000),
+      double mult=2.0, double jit=0.2, std::size_t attempts=0)
+  : initial_delay(initial)
+  , max_delay(max)
+  , multiplier(mult)
+  , jitter(jit)
+  , max_attempts(attempts)
+  {}
+
+  /// @brief  Returns the delay before a retry.
+  /// @param  [in]  attempt   Retry number, starting at 1.
+  /// @param  [in]  u         Uniform random number in [0, 1).
+  std::chrono::milliseconds
+  delay(std::size_t attempt, double u) const
+  {
+    double d = static_cast<double>(initial_delay.count());
+    double const cap = static_cast<double>(max_delay.count());
+    for (std::size_t i = 1; (i < attempt) && (d < cap); ++i)
+    {
+      d *= multiplier;
+    }
+    d = ((d < cap) ? d : cap) * (1.0 + (jitter * ((2.0 * u) - 1.0)));
+    return std::chrono::milliseconds(static_cast<long long>(d));
+  }
+
+  std::chrono::milliseconds initial_delay;  ///< Delay before first retry.
+  std::chrono::milliseconds max_delay;      ///< Largest delay.
+  double                    multiplier;     ///< Growth factor per retry.
+  double                    jitter;         ///< Randomized fraction.
+  std::size_t               max_attempts;   ///< `0` retries forever.
+};
+
+/// Connection and traffic counters of a tcp::client.
+struct client_counters
+{
+  std::uint64_t bytes_in;         ///< Bytes received.
+  std::uint64_t bytes_out;        ///< Bytes sent.
+  std::uint64_t connects;         ///< Connections established.
+  std::uint64_t reconnects;       ///< Connections after the first.
+  std::uint64_t failed_attempts;  ///< Resolves or connects that failed.
+  std::chrono::microseconds rtt;  ///< Handshake time of last connection.
+};
+
+/// @}
+
+namespace detail {  //-------------------------------------------------------
+
+// Connects a socket to a fixed endpoint.
+template<typename Protocol>
+class connector
+{
+public:
+  using target_type = typename Protocol::endpoint;
+
+  connector(asio::io_service&, target_type const& target)
+  : endpoint_(target)
+  {}
+
+  static target_type
+  target(typename Protocol::endpoint const& ep)
+  {
+    return ep;
+  }
+
+  // Calls handler(ec, start) once connected or failed, where start
+  // is the time the handshake began.
+  template<typename Handler>
+  void
+  async_connect(typename Protocol::socket& socket, Handler handler)
+  {
+    auto const start = std::chrono::steady_clock::now();
+    socket.async_connect(endpoint_,
+        [handler, start](asio::error_code ec) { handler(ec, start); });
+  }
+
+  void
+  cancel()
+  {}
+
+private:
+  target_type endpoint_;
+};
+
+// Resolves a host and service, then connects to the first
+// endpoint that accepts.
+template<>
+class connector<asio::ip::tcp>
 {
 public:
+  using target_type = asio::ip::tcp::resolver::query;
+
+  connector(asio::io_service& ios, target_type const& target)
+  : resolver_(ios)
+  , query_(target)
+  {}
+
+  static target_type
+  target(asio::ip::tcp::endpoint const& ep)
+  {
+    return target_type(ep.address().to_string(), std::to_string(ep.port()));
+  }
 
+  template<typename Handler>
+  void
+  async_connect(asio::ip::tcp::socket& socket, Handler handler)
+  {
+    using asio::ip::tcp;
+    // Get list of endpoints
+    resolver_.async_resolve(query_,
+        [&socket, handler](asio::error_code ec, tcp::resolver::iterator it)
+        {
+          auto const start = std::chrono::steady_clock::now();
+          if (ec)
+          {
+            handler(ec, start);
+            return;
+          }
+          asio::async_connect(socket, it,
+              [handler, start](asio::error_code ec, tcp::resolver::iterator)
+              {
+                handler(ec, start);
+              });
+        });
+  }
+
+  // Cancel any asynchronous operations waiting on the resolver.
+  void
+  cancel()
+  {
+    resolver_.cancel();
+  }
+
+private:
+  asio::ip::tcp::resolver         resolver_;
+  asio::ip::tcp::resolver::query  query_;
+};
+
+} // detail -----------------------------------------------------------------
+
+/// @addtogroup utl_asio
+/// @{
+
+//---------------------------------------------------------------------------
+/// @brief  Stream socket client that asynchronously reads and writes data.
+/// @tparam Protocol  Stream protocol, such as `asio::ip::tcp` or
+///                   `asio::local::stream_protocol`.
+///
+/// The client connects when run() is called, and reconnects according
+/// to its reconnect_policy whenever a connection attempt fails or an
+/// established connection is lost.
+template<typename Protocol>
+class basic_client
+{
+public:
+
+  using endpoint_type = typename Protocol::endpoint;
+
+  /// Handler that receives a copy of each message.
   using read_handler =  std::function<void(std::string const&)>;
 
+  /// @brief  Handler that receives each message in place.
+  ///
+  /// The buffer refers to the read buffer of the client, and is valid
+  /// only until the handler returns.  No memory is allocated per message.
+  using buffer_handler = std::function<void(asio::const_buffer const&)>;
+
+  /// Handler notified of each change in connection state.
+  using state_handler = std::function<void(client_state)>;
+
+  /// Default size of the read buffer in bytes.
+  static constexpr std::size_t default_buffer_size = 8192;
+
+  /// @brief  Construct a TCP client that discards received messages.
+  /// @param  [in]  host    Name or numeric address string.
+  /// @param  [in]  service Service name or numeric port number string.
+  basic_client(std::string const& host, std::string const& service)
+  : basic_client(host, service, default_buffer_size,
+                 [](asio::const_buffer const&){})
+  {}
+
   /// @brief  Construct a TCP client.
   /// @param  [in]  host    Name or numeric address string.
   /// @param  [in]  service Service name or numeric port number string.
-  /// @param  [in]  handler Callback to process received messages.
+  /// @param  [in]  handler Callback to process a copy of received messages.
+  basic_client(std::string const& host, std::string const& service,
+               read_handler handler)
+  : basic_client(host, service, default_buffer_size,
+                 copy_to(std::move(handler)))
+  {}
+
+  /// @brief  Construct a TCP client.
+  /// @param  [in]  host        Name or numeric address string.
+  /// @param  [in]  service     Service name or numeric port number string.
+  /// @param  [in]  buffer_size Size of the read buffer in bytes.
+  /// @param  [in]  handler     Callback to process received messages in
+  ///                           place, without allocation.
+  /// @param  [in]  limits      Limits on the write queue.  Under the
+  ///                           slow_consumer::disconnect policy the client
+  ///                           drops the connection and reconnects.
+  /// @throw  std::invalid_argument if @a buffer_size is `0`.
+  basic_client(std::string const& host, std::string const& service,
+               std::size_t buffer_size, buffer_handler handler,
+               write_limits const& limits=write_limits())
+  : basic_client(buffer_size, std::move(handler), limits,
+                 target_type(host, service))
+  {}
+
+  /// @brief  Construct a client that discards received messages.
+  /// @param  [in]  ep      Endpoint of the server.
   explicit
-  client(std::string const& host, std::string const& service,
-         read_handler handler = [](std::string const&){})
+  basic_client(endpoint_type const& ep)
+  : basic_client(ep, default_buffer_size, [](asio::const_buffer const&){})
+  {}
+
+  /// @brief  Construct a client.
+  /// @param  [in]  ep      Endpoint of the server.
+  /// @param  [in]  handler Callback to process a copy of received messages.
+  basic_client(endpoint_type const& ep, read_handler handler)
+  : basic_client(ep, default_buffer_size, copy_to(std::move(handler)))
+  {}
+
+  /// @brief  Construct a client.
+  /// @param  [in]  ep          Endpoint of the server.
+  /// @param  [in]  buffer_size Size of the read buffer in bytes.
+  /// @param  [in]  handler     Callback to process received messages in
+  ///                           place, without allocation.
+  /// @param  [in]  limits      Limits on the write queue.
+  /// @throw  std::invalid_argument if @a buffer_size is `0`.
+  basic_client(endpoint_type const& ep, std::size_t buffer_size,
+               buffer_handler handler,
+               write_limits const& limits=write_limits())
+  : basic_client(buffer_size, std::move(handler), limits,
+                 connector_type::target(ep))
+  {}
+
+  /// Returns a buffer handler that passes a copy of each message
+  /// to @a handler.
+  static buffer_handler
+  copy_to(read_handler handler)
+  {
+    return [handler](asio::const_buffer const& buf)
+           {
+             char const* data = asio::buffer_cast<char const*>(buf);
+             handler(std::string(data, data + asio::buffer_size(buf)));
+           };
+  }
+
+private:
+
+  using connector_type = detail::connector<Protocol>;
+  using target_type = typename connector_type::target_type;
+  using socket_type = typename Protocol::socket;
+
+  basic_client(std::size_t buffer_size, buffer_handler handler,
+               write_limits const& limits, target_type const& target)
   : io_service_()
   , work_(io_service_)
-  , resolver_(io_service_)
-  , query_(host, service)
+  , connector_(io_service_, target)
   , socket_(io_service_)
-  , read_handler_(handler)
-  , read_buffer_()
-  , write_queue_()
+  , timer_(io_service_)
+  , read_handler_(std::move(handler))
+  , read_buffer_(detail::checked_buffer_size(buffer_size))
+  , write_queue_(limits)
+  , session_(0)
+  , connected_(false)
+  , attempt_(0)
+  , drops_(0)
+  , state_(client_state::disconnected)
+  , bytes_in_(0)
+  , bytes_out_(0)
+  , connects_(0)
+  , failed_attempts_(0)
+  , rtt_(0)
   {
-    do_connect();
+    // Connect once run() is called, so that handlers
+    // and policy set beforehand apply from the start.
+    io_service_.post([this]() { do_connect(); });
 //    auto endpoint_iterator = resolver_.resolve(query_);
 //    // Create and connect the socket.
 //    // asio.connect trys both IPv4 and IPv6
@@ -88,6 +376,8 @@ public:
 //    do_read();
   }
 
+public:
+
   /// @brief  Run the server loop.
   ///
   /// The run() function blocks until stop() is called to discontinue
@@ -111,18 +401,13 @@ public:
     io_service_.post(
         [this]()
         {
-          // Cancel any asynchronous operations waiting on the resolver.
-          resolver_.cancel();
+          // Cancel any asynchronous operations waiting on the resolver
+          // or on the reconnect timer.
+          connector_.cancel();
+          timer_.cancel();
           // Initiate graceful connection closure.
-          if (socket_.is_open())
-          {
-            asio::error_code ignored_ec;
-            // Disable send and receive options.
-            socket_.shutdown(asio::ip::tcp::socket::shutdown_both, ignored_ec);
-            // Close the socket.  Any asynchronous send, receive,
-            // or connect operations will be cancelled immediately.
-            socket_.close(ignored_ec);
-          }
+          close();
+          set_state(client_state::disconnected);
         });
     // Non-blocking call to stop even processing loop.
     io_service_.stop();
@@ -131,37 +416,90 @@ public:
   /// @brief  Sends the specified data to the server.
   void
   write(std::string const& str)
+  {
+    write(make_shared_buffer(str));
+  }
+
+  /// @brief  Sends the specified shared data to the server without
+  ///         copying it.
+  void
+  write(shared_buffer buf)
   {
     io_service_.post(
-        [this, str]()
+        [this, buf]()
         {
-          if (!socket_.is_open())   // const
+          if (!connected_)
           {
-            return;   // socket not open
+            return;   // not connected
           }
 
-          // Socket may be open but not connected.
-          // One option is to use an is_connected_ flag.
-          //   http://stackoverflow.com/questions/9920370
-          //   http://stackoverflow.com/questions/1511129
-          // Here we check for a remote endpoint.
-          asio::error_code ec;
-          /*asio::ip::tcp::endpoint endpoint =*/
-          socket_.remote_endpoint(ec);   // const
-          if (ec)
+          if (!write_queue_.push(buf))
           {
-            return;   // no remote endpoint
+            drop();   // slow consumer:  start over
           }
-
-          bool write_in_progress = !write_queue_.empty();   // const
-          write_queue_.push_back(str);
-          if (!write_in_progress)
+          else if (!write_queue_.writing())
           {
             do_write();
           }
         });
   }
 
+  /// Returns write queue depth and drop counts.
+  write_stats
+  stats() const
+  {
+    return write_queue_.stats();
+  }
+
+  /// @brief  Returns connection and traffic counters.
+  ///
+  /// Safe to call from any thread.
+  client_counters
+  counters() const
+  {
+    client_counters c;
+    c.bytes_in = bytes_in_.load(std::memory_order_relaxed);
+    c.bytes_out = bytes_out_.load(std::memory_order_relaxed);
+    c.connects = connects_.load(std::memory_order_relaxed);
+    c.reconnects = (c.connects > 0) ? (c.connects - 1) : 0;
+    c.failed_attempts = failed_attempts_.load(std::memory_order_relaxed);
+    c.rtt = std::chrono::microseconds(rtt_.load(std::memory_order_relaxed));
+    return c;
+  }
+
+  /// Returns the current connection state.
+  client_state
+  state() const
+  {
+    return state_.load();
+  }
+
+  /// Returns the reconnect policy.
+  reconnect_policy const&
+  policy() const
+  {
+    return policy_;
+  }
+
+  /// @brief  Sets the reconnect policy.
+  ///
+  /// Must be called before run().
+  void
+  policy(reconnect_policy const& val)
+  {
+    policy_ = val;
+  }
+
+  /// @brief  Sets the handler notified of connection state changes.
+  ///
+  /// The handler is called from the thread running run(), and must be
+  /// set before run() is called.
+  void
+  on_state(state_handler handler)
+  {
+    state_handler_ = std::move(handler);
+  }
+
   /// Get the Asio io_service associated with the object.
   asio::io_service&
   io_service()
@@ -175,32 +513,105 @@ private:
   void
   do_connect()
   {
-    using asio::ip::tcp;
-    asio::error_code ignored_ec;
-    socket_.shutdown(tcp::socket::shutdown_both, ignored_ec);
-    socket_.close();
-    // Get list of endpoints
-    resolver_.async_resolve(query_,
-        [this](std::error_code ec, tcp::resolver::iterator it)
+    close();
+    set_state(client_state::connecting);
+    connector_.async_connect(socket_,
+        [this](asio::error_code ec, std::chrono::steady_clock::time_point start)
+        {
+          if (!ec)
+          {                 // If connected,
+            connected(std::chrono::steady_clock::now() - start);
+            do_read();      // start receiving data.
+          }
+          else if (ec != asio::error::operation_aborted)
+          {                 // If not connected,
+            retry();        // try again after a delay.
+          }
+        });
+  }
+
+  // Record an established connection.
+  void
+  connected(std::chrono::steady_clock::duration handshake)
+  {
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    connected_ = true;
+    attempt_ = 0;
+    rtt_.store(duration_cast<microseconds>(handshake).count(),
+               std::memory_order_relaxed);
+    connects_.fetch_add(1, std::memory_order_relaxed);
+    set_state(client_state::connected);
+  }
+
+  // Schedule the next connection attempt, or give up.
+  void
+  retry()
+  {
+    failed_attempts_.fetch_add(1, std::memory_order_relaxed);
+    ++attempt_;
+    if ((policy_.max_attempts != 0) && (attempt_ >= policy_.max_attempts))
+    {
+      set_state(client_state::disconnected);
+      return;
+    }
+    wait(attempt_);
+  }
+
+  // Drop an established connection and reconnect, backing off
+  // if the server keeps dropping us.
+  void
+  drop()
+  {
+    close();
+    set_state(client_state::disconnected);
+    wait(++drops_);
+  }
+
+  // Call do_connect() after the delay before the specified retry.
+  void
+  wait(std::size_t retry)
+  {
+    double const u = utl::random::uniform01(utl::random::thread_engine());
+    timer_.expires_from_now(policy_.delay(retry, u));
+    timer_.async_wait(
+        [this](asio::error_code ec)
         {
           if (!ec)
           {
-            asio::async_connect(socket_, it,
-                [this](std::error_code ec, tcp::resolver::iterator it)
-                {
-                  if (!ec)
-                  {                 // If connected,
-                    do_read();      // start receiving data.
-                  }
-                  else
-                  {                 // If not connected,
-                    do_connect();   // keep trying to connect.
-                  }
-                });
+            do_connect();
           }
         });
   }
 
+  // Close the socket and discard writes meant for it.
+  void
+  close()
+  {
+    asio::error_code ignored_ec;
+    if (socket_.is_open())
+    {
+      // Disable send and receive options.
+      socket_.shutdown(socket_type::shutdown_both, ignored_ec);
+      // Close the socket.  Any asynchronous send, receive,
+      // or connect operations will be cancelled immediately.
+      socket_.close(ignored_ec);
+    }
+    connected_ = false;
+    ++session_;
+    write_queue_.clear();
+  }
+
+  // Notify the state handler of a change in state.
+  void
+  set_state(client_state state)
+  {
+    if (state_.exchange(state) != state && state_handler_)
+    {
+      state_handler_(state);
+    }
+  }
+
   // Perform an asynchronous read.
   void
   do_read()
@@ -210,13 +621,14 @@ private:
         {
           if (!ec)
           {
-            read_handler_(std::string(read_buffer_.begin(),
-                                      read_buffer_.begin() + bytes_received));
+            bytes_in_.fetch_add(bytes_received, std::memory_order_relaxed);
+            drops_ = 0;
+            read_handler_(asio::buffer(read_buffer_.data(), bytes_received));
             do_read();
           }
           else if (ec != asio::error::operation_aborted)
           {
-            do_connect();
+            drop();
           }
         });
   }
@@ -225,13 +637,19 @@ private:
   void
   do_write()
   {
-    asio::async_write(socket_,
-        asio::buffer(write_queue_.front(), write_queue_.front().size()),
-        [this](asio::error_code ec, std::size_t /*bytes_sent*/)
+    // Send everything queued so far with one gathered write.
+    std::size_t const session = session_;
+    asio::async_write(socket_, write_queue_.gather(),
+        [this, session](asio::error_code ec, std::size_t bytes_sent)
         {
+          if (session != session_)
+          {
+            return;   // write to a previous connection
+          }
           if (!ec)
           {
-            write_queue_.pop_front();
+            bytes_out_.fetch_add(bytes_sent, std::memory_order_relaxed);
+            write_queue_.pop_sent();
             if (!write_queue_.empty())
             {
               do_write();
@@ -243,18 +661,32 @@ private:
 
   asio::io_service                io_service_;
   asio::io_service::work          work_;
-  asio::ip::tcp::resolver         resolver_;
-  asio::ip::tcp::resolver::query  query_;
-  asio::ip::tcp::socket           socket_;
+  connector_type                  connector_;
+  socket_type                     socket_;
+  asio::steady_timer              timer_;     // Delays reconnect attempts
 
   // /*mutable*/ std::mutex write_mutex;
 
-  read_handler            read_handler_;    // To process received messages
-  std::array<char, 8192>  read_buffer_;     // Buffer for incoming data
-  std::deque<std::string> write_queue_;
-
+  buffer_handler          read_handler_;    // To process received messages
+  std::vector<char>       read_buffer_;     // Buffer for incoming data
+  write_queue             write_queue_;     // Outgoing data
+  std::size_t             session_;         // Counts connection attempts
+  bool                    connected_;       // Socket is connected
+  std::size_t             attempt_;         // Consecutive failed attempts
+  std::size_t             drops_;           // Consecutive drops before data
+  reconnect_policy        policy_;          // Delay between attempts
+  state_handler           state_handler_;   // Notified of state changes
+  std::atomic<client_state>   state_;
+  std::atomic<std::uint64_t>  bytes_in_;
+  std::atomic<std::uint64_t>  bytes_out_;
+  std::atomic<std::uint64_t>  connects_;
+  std::atomic<std::uint64_t>  failed_attempts_;
+  std::atomic<long long>      rtt_;         // Microseconds
 };
 
+/// TCP client.
+using client = basic_client<asio::ip::tcp>;
+
 /// @}
 
 } } } // utl::io::tcp
@@ -46,12 +46,17 @@ SOFTWARE.
 #pragma GCC diagnostic pop
 //-----------------------------------------------------------
 
-#include <array>        // std::array
+#include <utl/asio/tcp/buffer.hpp>  // utl::io::tcp::shared_buffer
+
+#include <atomic>       // std::atomic
+#include <cstdint>      // std::uint32_t, std::uint64_t
 #include <deque>        // std::deque
 #include <functional>   // std::function
-#include <memory>       // std::shared_ptr, std::enable_shared_from_this
+#include <memory>       // std::shared_ptr, std::enable_shared_from_this,
+                        // std::atomic_load, std::atomic_store
+#include <mutex>        // std::lock_guard, std::mutex
 #include <string>       // std::string
-#include <set>          // std::set
+#include <vector>       // std::vector
 
 //#include <iostream>   // tmp
 
@@ -67,22 +72,68 @@ class connection_manager;
 
 typedef std::shared_ptr<connection> connection_ptr;
 
-/// Connection to a TCP client.
+/// @brief  Identifier of a connection, unique within its server.
+///
+/// Identifiers of closed connections are not reused until their slot
+/// has been reused 2^32 times.
+typedef std::uint64_t connection_id;
+
+/// @brief  Connection to a TCP client.
+///
+/// The socket may be of any stream protocol, so the same connection
+/// serves Unix domain stream sockets (see utl/asio/local.hpp).
+/// Handlers for a connection run on the thread that runs its io_service.
+/// start(), stop(), and write() may be called from any thread.
 class connection
 : public std::enable_shared_from_this<connection>
 {
 public:
 
+  /// Handler that receives a copy of each message.
   using read_handler =
         std::function<void(std::string const&, connection_ptr)>;
 
+  /// @brief  Handler that receives each message in place.
+  ///
+  /// The buffer refers to the read buffer of the connection, and is
+  /// valid only until the handler returns.  No memory is allocated
+  /// per message.
+  using buffer_handler =
+        std::function<void(asio::const_buffer const&, connection_ptr)>;
+
+  /// Socket of any stream protocol, such as TCP or Unix domain.
+  using socket_type = asio::generic::stream_protocol::socket;
+
+  /// Default size of the read buffer in bytes.
+  static constexpr std::size_t default_buffer_size = 8192;
+
   /// Construct a connect.
   /// @param  [in]  socket    Socket for this connection.
   /// @param  [in]  manager   Connection manager for this connection.
   /// @param  [in]  handler   Handler to process received messages.
-  connection(asio::ip::tcp::socket socket,
+  connection(socket_type socket,
              connection_manager& manager, read_handler& handler);
 
+  /// Construct a connect.
+  /// @param  [in]  socket      Socket for this connection.
+  /// @param  [in]  manager     Connection manager for this connection.
+  /// @param  [in]  handler     Handler to process received messages.
+  /// @param  [in]  buffer_size Size of the read buffer in bytes.
+  /// @param  [in]  limits      Limits on the write queue.
+  /// @throw  std::invalid_argument if @a buffer_size is `0`.
+  connection(socket_type socket,
+             connection_manager& manager, buffer_handler handler,
+             std::size_t buffer_size=default_buffer_size,
+             write_limits const& limits=write_limits());
+
+  /// Returns a buffer handler that passes a copy of each message
+  /// to @a handler.
+  static buffer_handler
+  copy_to(read_handler handler);
+
+  /// Returns the identifier assigned by the connection manager.
+  connection_id id() const  { return id_; }
+
   /// Returns `true` if the socket is open.
   bool is_open() const;
 
@@ -95,16 +146,26 @@ public:
   /// Write data to the connection.
   void write(std::string const& str);
 
+  /// Write shared data to the connection without copying it.
+  void write(shared_buffer buf);
+
+  /// Returns write queue depth and drop counts.
+  write_stats stats() const   { return write_queue_.stats(); }
+
 private:
 
+  friend class connection_manager;
+
   void do_read();   // Perform an asynchronous read.
   void do_write();  // Perform an asynchronous write.
 
-  asio::ip::tcp::socket   socket_;              // Socket for this connection
+  socket_type             socket_;              // Socket for this connection
+  asio::io_service&       io_service_;          // Runs this connection
   connection_manager&     connection_manager_;  // Manager for this connection
-  read_handler&           read_handler_;        // To process received messages
-  std::array<char, 8192>  read_buffer_;         // Buffer for incoming data
-  std::deque<std::string> write_queue_;
+  connection_id           id_;                  // Assigned by the manager
+  buffer_handler          read_handler_;        // To process received messages
+  std::vector<char>       read_buffer_;         // Buffer for incoming data
+  write_queue             write_queue_;         // Outgoing data
 
 };
 
@@ -112,13 +173,26 @@ private:
 
 //---------------------------------------------------------------------------//
 
-/// Manages open connections for the server.
+/// @brief  Manages open connections for the server.
+///
+/// Member functions may be called from any thread.  Connections are kept
+/// in a slot map indexed by connection ID, so adding, removing, and
+/// finding a connection take constant time.  Broadcasts iterate over an
+/// immutable snapshot of the open connections that is shared by all
+/// readers and rebuilt only after the set of connections changes.
 class connection_manager
 {
 public:
 
   /// Construct a connection manager.
-  connection_manager() {}
+  connection_manager()
+  : mutex_()
+  , slots_()
+  , free_()
+  , count_(0)
+  , dirty_(false)
+  , snapshot_(std::make_shared<snapshot_type>())
+  {}
 
   // Prohibit copying and assignment.
   connection_manager(const connection_manager&) = delete;
@@ -132,7 +206,7 @@ public:
   std::size_t
   size() const
   {
-    return connections_.size();
+    return count_.load(std::memory_order_relaxed);
   }
 
   /// @}
@@ -140,12 +214,32 @@ public:
   /// @name Modifiers
   /// @{
 
-  /// Add the specified connection to the manager and start it.
-  void
+  /// @brief  Add the specified connection to the manager and start it.
+  /// @return Identifier of the connection.
+  connection_id
   start(connection_ptr c)
   {
-    connections_.insert(c);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      std::uint32_t index;
+      if (free_.empty())
+      {
+        index = static_cast<std::uint32_t>(slots_.size());
+        slots_.push_back(slot());
+      }
+      else
+      {
+        index = free_.back();
+        free_.pop_back();
+      }
+      slot& s = slots_[index];
+      s.con = c;
+      c->id_ = (static_cast<connection_id>(s.generation) << 32) | index;
+      count_.fetch_add(1, std::memory_order_relaxed);
+      dirty_.store(true, std::memory_order_release);
+    }
     c->start();
+    return c->id();
   }
 
   /// Stop and delete the specified connection.
@@ -153,18 +247,40 @@ public:
   stop(connection_ptr c)
   {
     c->stop();
-    connections_.erase(c);
+    remove(c->id(), c.get());
+  }
+
+  /// @brief  Stop and delete the connection with the specified ID.
+  /// @return `false` if there is no such connection.
+  bool
+  stop(connection_id id)
+  {
+    connection_ptr c = find(id);
+    if (!c) { return false; }
+    stop(c);
+    return true;
   }
 
   /// Stop and delete all connections.
   void
   stop_all()
   {
-    for (auto c : connections_)
+    std::vector<connection_ptr> connections;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (std::size_t i = 0; i != slots_.size(); ++i)
+      {
+        if (slots_[i].con)
+        {
+          connections.push_back(std::move(slots_[i].con));
+          release(static_cast<std::uint32_t>(i));
+        }
+      }
+    }
+    for (auto const& c : connections)
     {
       c->stop();
     }
-    connections_.clear();
   }
 
   /// @}
@@ -172,6 +288,35 @@ public:
   /// @name Connection Access
   /// @{
 
+  /// @brief  Returns the connection with the specified ID, or an
+  ///         empty pointer if there is no such connection.
+  connection_ptr
+  find(connection_id id) const
+  {
+    std::uint32_t const index = static_cast<std::uint32_t>(id);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if ((index < slots_.size()) &&
+        (slots_[index].generation == static_cast<std::uint32_t>(id >> 32)))
+    {
+      return slots_[index].con;
+    }
+    return connection_ptr();
+  }
+
+  /// @brief  Calls `f(connection_ptr const&)` for each open connection.
+  ///
+  /// Iterates over a snapshot, so @a f may call any member function.
+  template<typename Function>
+  void
+  for_each(Function f) const
+  {
+    std::shared_ptr<snapshot_type const> connections = snapshot();
+    for (auto const& c : *connections)
+    {
+      f(c);
+    }
+  }
+
   /// Write data to a connection.
   void
   write(std::string const& str, connection_ptr const& con)
@@ -179,14 +324,29 @@ public:
     con->write(str);
   }
 
+  /// @brief  Write data to the connection with the specified ID.
+  /// @return `false` if there is no such connection.
+  bool
+  write(shared_buffer const& buf, connection_id id)
+  {
+    connection_ptr c = find(id);
+    if (!c) { return false; }
+    c->write(buf);
+    return true;
+  }
+
   /// Write data to all connections.
   void
   write(std::string const& str)
   {
-    for (auto c : connections_)
-    {
-      c->write(str);
-    }
+    write(make_shared_buffer(str));
+  }
+
+  /// Write shared data to all connections without copying it.
+  void
+  write(shared_buffer const& buf)
+  {
+    for_each([&buf](connection_ptr const& c) { c->write(buf); });
   }
 
   /// @}
@@ -194,7 +354,68 @@ public:
 
 private:
 
-  std::set<connection_ptr> connections_;
+  typedef std::vector<connection_ptr> snapshot_type;
+
+  struct slot
+  {
+    slot() : con(), generation(1) {}
+    connection_ptr  con;
+    std::uint32_t   generation;   // distinguishes reuses of the slot
+  };
+
+  // Removes connection c from its slot, if it is still there.
+  void
+  remove(connection_id id, connection const* c)
+  {
+    std::uint32_t const index = static_cast<std::uint32_t>(id);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if ((index < slots_.size()) && (slots_[index].con.get() == c) && c)
+    {
+      slots_[index].con.reset();
+      release(index);
+    }
+  }
+
+  // Returns an empty slot to the free list.  Requires mutex_.
+  void
+  release(std::uint32_t index)
+  {
+    ++slots_[index].generation;
+    free_.push_back(index);
+    count_.fetch_sub(1, std::memory_order_relaxed);
+    dirty_.store(true, std::memory_order_release);
+  }
+
+  // Returns the open connections, rebuilding the shared snapshot only
+  // if connections were added or removed since it was last built.
+  std::shared_ptr<snapshot_type const>
+  snapshot() const
+  {
+    if (dirty_.load(std::memory_order_acquire))
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (dirty_.load(std::memory_order_relaxed))
+      {
+        auto connections = std::make_shared<snapshot_type>();
+        connections->reserve(count_.load(std::memory_order_relaxed));
+        for (auto const& s : slots_)
+        {
+          if (s.con) { connections->push_back(s.con); }
+        }
+        std::atomic_store(&snapshot_,
+            std::shared_ptr<snapshot_type const>(std::move(connections)));
+        dirty_.store(false, std::memory_order_relaxed);
+      }
+    }
+    return std::atomic_load(&snapshot_);
+  }
+
+  mutable std::mutex                            mutex_;   // Guards slots
+  std::vector<slot>                             slots_;
+  std::vector<std::uint32_t>                    free_;    // Empty slots
+  std::atomic<std::size_t>                      count_;
+  mutable std::atomic<bool>                     dirty_;   // Snapshot stale
+  mutable std::shared_ptr<snapshot_type const>  snapshot_;
 
 };
 
@@ -203,16 +424,58 @@ private:
 //---------------------------------------------------------------------------//
 // Implementation
 
+namespace detail {  //-------------------------------------------------------
+
+// Returns the io_service of a socket.
+// Asio 1.11 replaced get_io_service() with get_executor().
+template<typename Socket>
+inline asio::io_service&
+io_service_of(Socket& socket)
+{
+#if defined(ASIO_VERSION) && (ASIO_VERSION >= 101100)
+  return static_cast<asio::io_service&>(socket.get_executor().context());
+#else
+  return socket.get_io_service();
+#endif
+}
+
+} // detail -----------------------------------------------------------------
+
 inline
-connection::connection(asio::ip::tcp::socket socket,
+connection::connection(socket_type socket,
     connection_manager& manager, read_handler& handler)
 : socket_(std::move(socket))
+, io_service_(detail::io_service_of(socket_))
 , connection_manager_(manager)
-, read_handler_(handler)
-, read_buffer_()
+, id_(0)
+, read_handler_(copy_to(handler))
+, read_buffer_(default_buffer_size)
 , write_queue_()
 {}
 
+inline
+connection::connection(socket_type socket,
+    connection_manager& manager, buffer_handler handler,
+    std::size_t buffer_size, write_limits const& limits)
+: socket_(std::move(socket))
+, io_service_(detail::io_service_of(socket_))
+, connection_manager_(manager)
+, id_(0)
+, read_handler_(std::move(handler))
+, read_buffer_(detail::checked_buffer_size(buffer_size))
+, write_queue_(limits)
+{}
+
+inline connection::buffer_handler
+connection::copy_to(read_handler handler)
+{
+  return [handler](asio::const_buffer const& buf, connection_ptr con)
+  {
+    char const* data = asio::buffer_cast<char const*>(buf);
+    handler(std::string(data, data + asio::buffer_size(buf)), con);
+  };
+}
+
 inline bool
 connection::is_open() const
 {
@@ -222,31 +485,48 @@ connection::is_open() const
 inline void
 connection::start()
 {
-  do_read();
+  auto self(shared_from_this());
+  io_service_.dispatch([this, self]() { do_read(); });
 }
 
 inline void
 connection::stop()
 {
-  if (socket_.is_open())
+  auto self(shared_from_this());
+  io_service_.dispatch([this, self]()
   {
-    // Initiate graceful connection closure.
-    // Shutdown both send and receive on the socket.
-    asio::error_code ignored_ec;
-    socket_.shutdown(asio::ip::tcp::socket::shutdown_both, ignored_ec);
-    socket_.close(ignored_ec);
-  }
+    if (socket_.is_open())
+    {
+      // Initiate graceful connection closure.
+      // Shutdown both send and receive on the socket.
+      asio::error_code ignored_ec;
+      socket_.shutdown(socket_type::shutdown_both, ignored_ec);
+      socket_.close(ignored_ec);
+    }
+  });
 }
 
 inline void
 connection::write(std::string const& str)
 {
-  bool write_in_progress = !write_queue_.empty();
-  write_queue_.push_back(str);
-  if (!write_in_progress)
+  write(make_shared_buffer(str));
+}
+
+inline void
+connection::write(shared_buffer buf)
+{
+  auto self(shared_from_this());
+  io_service_.dispatch([this, self, buf]()
   {
-    do_write();
-  }
+    if (!write_queue_.push(buf))
+    {
+      connection_manager_.stop(shared_from_this());   // slow consumer
+    }
+    else if (!write_queue_.writing())
+    {
+      do_write();
+    }
+  });
 }
 
 // private ----------------------------------------------------
@@ -260,8 +540,7 @@ connection::do_read()
       {
         if (!ec)
         {
-          read_handler_(std::string(read_buffer_.begin(),
-                                    read_buffer_.begin() + bytes_received),
+          read_handler_(asio::buffer(read_buffer_.data(), bytes_received),
                         shared_from_this());
           do_read();
         }
@@ -275,14 +554,14 @@ connection::do_read()
 inline void
 connection::do_write()
 {
+  // Send everything queued so far with one gathered write.
   auto self(shared_from_this());
-  asio::async_write(socket_, asio::buffer(write_queue_.front(),
-                                          write_queue_.front().size()),
+  asio::async_write(socket_, write_queue_.gather(),
       [this, self](std::error_code ec, std::size_t /*bytes_sent*/)
       {
         if (!ec)
         {
-          write_queue_.pop_front();
+          write_queue_.pop_sent();
           if (!write_queue_.empty())
           {
             do_write();
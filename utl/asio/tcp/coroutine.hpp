@@ -0,0 +1,1051 @@
+/*
+Licensed under the MIT License <http://opensource.org/licenses/MIT>
+
+Copyright 2018 Nathan Lucas <nathan.lucas@wayne.edu>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+//===========================================================================//
+/// @file
+/// @brief    TCP coroutine interface.
+/// @details  Awaitable connect, accept, read, and write operations for
+///           C++20 coroutines.
+/// @author   Nathan Lucas
+/// @date     2018
+//===========================================================================//
+#ifndef UTL_IO_TCP_COROUTINE_HPP
+#define UTL_IO_TCP_COROUTINE_HPP
+
+#ifndef __cplusplus
+#error must be compiled as C++
+#endif
+
+#include <utl/asio/tcp/buffer.hpp>      // utl::io::tcp::shared_buffer
+#include <utl/asio/tcp/connection.hpp>  // utl::io::tcp::connection
+#include <utl/asio/tcp/framing.hpp>     // utl::io::tcp::delimited_framer,
+                                        // utl::io::tcp::frame_overflow
+
+/// @def    UTL_IO_HAS_COROUTINES
+/// @brief  Defined when the compiler supports C++20 coroutines and Asio
+///         supports associated allocators (Asio 1.11 or later), in which
+///         case this header provides utl::io::tcp::task and
+///         utl::io::tcp::co_connection.  Otherwise the header is empty.
+#if !defined(UTL_IO_HAS_COROUTINES)
+#if defined(__cpp_impl_coroutine) && (__cpp_impl_coroutine >= 201902L) && \
+    defined(ASIO_VERSION) && (ASIO_VERSION >= 101100)
+#define UTL_IO_HAS_COROUTINES 1
+#endif
+#endif
+
+#if defined(UTL_IO_HAS_COROUTINES)
+
+#include <coroutine>    // std::coroutine_handle, std::noop_coroutine,
+                        // std::suspend_always, std::suspend_never
+#include <cstddef>      // std::max_align_t, std::size_t
+#include <cstring>      // std::memmove
+#include <exception>    // std::exception_ptr, std::current_exception,
+                        // std::rethrow_exception, std::terminate
+#include <new>          // operator new, operator delete
+#include <optional>     // std::optional
+#include <stdexcept>    // std::length_error
+#include <string>       // std::string
+#include <utility>      // std::exchange, std::forward, std::move
+#include <vector>       // std::vector
+
+namespace utl { namespace io { namespace tcp {
+
+// Forward declarations
+template<typename T> class task;
+template<typename Framer> class co_connection;
+
+namespace detail {  //-------------------------------------------------------
+
+// Thread-local free lists of coroutine frames by size class.  A frame
+// freed on another thread joins the free lists of that thread.
+class frame_pool
+{
+public:
+  static void*
+  allocate(std::size_t size)
+  {
+    std::size_t const c = size_class(size);
+    if (c < classes)
+    {
+      lists& l = local();
+      if (block* b = l.head[c])
+      {
+        l.head[c] = b->next;
+        --l.count[c];
+        return b;
+      }
+      return ::operator new((c + 1) * granularity);
+    }
+    return ::operator new(size);
+  }
+
+  static void
+  deallocate(void* p, std::size_t size) noexcept
+  {
+    std::size_t const c = size_class(size);
+    if (c < classes)
+    {
+      lists& l = local();
+      if (l.count[c] < max_cached)
+      {
+        block* b = static_cast<block*>(p);
+        b->next = l.head[c];
+        l.head[c] = b;
+        ++l.count[c];
+        return;
+      }
+    }
+    ::operator delete(p);
+  }
+
+private:
+  static constexpr std::size_t granularity  = 64;
+  static constexpr std::size_t classes      = 32;   // frames up to 2 KB
+  static constexpr std::size_t max_cached   = 64;   // per class and thread
+
+  struct block { block* next; };
+
+  struct lists
+  {
+    block*      head[classes]   = {};
+    std::size_t count[classes]  = {};
+
+    ~lists()
+    {
+      for (block* b : head)
+      {
+        while (b)
+        {
+          block* next = b->next;
+          ::operator delete(b);
+          b = next;
+        }
+      }
+    }
+  };
+
+  static std::size_t
+  size_class(std::size_t size)  { return ((size - 1) / granularity); }
+
+  static lists&
+  local()
+  {
+    thread_local lists l;
+    return l;
+  }
+};
+
+// Base of promise types whose frames come from the frame pool.
+struct pooled_frame
+{
+  static void*
+  operator new(std::size_t size)
+  {
+    return frame_pool::allocate(size);
+  }
+
+  static void
+  operator delete(void* p, std::size_t size) noexcept
+  {
+    frame_pool::deallocate(p, size);
+  }
+};
+
+// Promise of a task:  starts when awaited, and resumes the awaiting
+// coroutine when done.
+class task_promise_base
+: public pooled_frame
+{
+public:
+  struct final_awaiter
+  {
+    bool await_ready() const noexcept   { return false; }
+
+    template<typename Promise>
+    std::coroutine_handle<>
+    await_suspend(std::coroutine_handle<Promise> h) const noexcept
+    {
+      return h.promise().continuation_;
+    }
+
+    void await_resume() const noexcept  {}
+  };
+
+  std::suspend_always initial_suspend() const noexcept  { return {}; }
+  final_awaiter       final_suspend() const noexcept    { return {}; }
+
+  void
+  unhandled_exception() noexcept
+  {
+    error_ = std::current_exception();
+  }
+
+  std::coroutine_handle<> continuation_ = std::noop_coroutine();
+
+protected:
+  void
+  rethrow() const
+  {
+    if (error_) { std::rethrow_exception(error_); }
+  }
+
+private:
+  std::exception_ptr error_;
+};
+
+template<typename T>
+class task_promise
+: public task_promise_base
+{
+public:
+  task<T> get_return_object() noexcept;
+
+  template<typename U>
+  void
+  return_value(U&& value)
+  {
+    value_.emplace(std::forward<U>(value));
+  }
+
+  T
+  result()
+  {
+    rethrow();
+    return std::move(*value_);
+  }
+
+private:
+  std::optional<T> value_;
+};
+
+template<>
+class task_promise<void>
+: public task_promise_base
+{
+public:
+  task<void> get_return_object() noexcept;
+
+  void return_void() const noexcept   {}
+
+  void result() const   { rethrow(); }
+};
+
+// Coroutine started by spawn(), which destroys itself when done.
+struct detached_task
+{
+  struct promise_type
+  : public pooled_frame
+  {
+    detached_task
+    get_return_object() noexcept
+    {
+      return { std::coroutine_handle<promise_type>::from_promise(*this) };
+    }
+
+    std::suspend_always initial_suspend() const noexcept  { return {}; }
+    std::suspend_never  final_suspend() const noexcept    { return {}; }
+    void return_void() const noexcept                     {}
+    void unhandled_exception() const noexcept             { std::terminate(); }
+  };
+
+  std::coroutine_handle<promise_type> handle;
+};
+
+//---------------------------------------------------------------------------
+
+// Storage for the completion handler of one asynchronous operation.
+// Kept in the awaiter, which lives in the awaiting coroutine's frame,
+// so the operation itself allocates nothing.
+class handler_memory
+{
+public:
+  handler_memory() noexcept : in_use_(false) {}
+
+  handler_memory(handler_memory const&) = delete;
+  handler_memory& operator=(handler_memory const&) = delete;
+
+  void*
+  allocate(std::size_t size)
+  {
+    if (!in_use_ && (size <= sizeof(storage_)))
+    {
+      in_use_ = true;
+      return storage_;
+    }
+    return ::operator new(size);
+  }
+
+  void
+  deallocate(void* p) noexcept
+  {
+    if (p == storage_)  { in_use_ = false; }
+    else                { ::operator delete(p); }
+  }
+
+private:
+  alignas(std::max_align_t) unsigned char storage_[384];
+  bool in_use_;
+};
+
+template<typename T>
+class handler_allocator
+{
+public:
+  using value_type = T;
+
+  explicit
+  handler_allocator(handler_memory& memory) noexcept
+  : memory_(&memory)
+  {}
+
+  template<typename U>
+  handler_allocator(handler_allocator<U> const& other) noexcept
+  : memory_(other.memory_)
+  {}
+
+  T*
+  allocate(std::size_t n)
+  {
+    return static_cast<T*>(memory_->allocate(sizeof(T) * n));
+  }
+
+  void
+  deallocate(T* p, std::size_t) noexcept
+  {
+    memory_->deallocate(p);
+  }
+
+  template<typename U>
+  bool
+  operator==(handler_allocator<U> const& other) const noexcept
+  {
+    return (memory_ == other.memory_);
+  }
+
+  template<typename U>
+  bool
+  operator!=(handler_allocator<U> const& other) const noexcept
+  {
+    return (memory_ != other.memory_);
+  }
+
+private:
+  template<typename> friend class handler_allocator;
+
+  handler_memory* memory_;
+};
+
+// Base of awaiters that resume a coroutine when an operation completes.
+class io_awaiter
+{
+public:
+  io_awaiter() = default;
+  io_awaiter(io_awaiter const&) = delete;
+  io_awaiter& operator=(io_awaiter const&) = delete;
+
+  bool await_ready() const noexcept   { return false; }
+
+  handler_memory& memory()            { return memory_; }
+
+protected:
+  // Resumes the coroutine, which may destroy this awaiter.
+  void
+  resume(asio::error_code const& ec)
+  {
+    ec_ = ec;
+    handle_.resume();
+  }
+
+  void
+  check() const
+  {
+    if (ec_) { throw asio::system_error(ec_); }
+  }
+
+  std::coroutine_handle<>   handle_;
+  asio::error_code          ec_;
+
+private:
+  handler_memory            memory_;
+};
+
+// Completion handler that passes its result to an awaiter, and
+// allocates from the awaiter's handler memory.
+template<typename Awaiter>
+class completion
+{
+public:
+  using allocator_type = handler_allocator<void>;
+
+  explicit
+  completion(Awaiter* awaiter) noexcept
+  : awaiter_(awaiter)
+  {}
+
+  allocator_type
+  get_allocator() const noexcept
+  {
+    return allocator_type(awaiter_->memory());
+  }
+
+  template<typename... Args>
+  void
+  operator()(Args&&... args) const
+  {
+    awaiter_->complete(std::forward<Args>(args)...);
+  }
+
+private:
+  Awaiter* awaiter_;
+};
+
+//---------------------------------------------------------------------------
+
+template<typename Framer>
+class read_awaiter
+: public io_awaiter
+{
+public:
+  explicit
+  read_awaiter(co_connection<Framer>& con)
+  : con_(con)
+  , frame_()
+  , overflow_(false)
+  {}
+
+  bool
+  await_ready()
+  {
+    return con_.next_frame(frame_, overflow_);
+  }
+
+  void
+  await_suspend(std::coroutine_handle<> h)
+  {
+    handle_ = h;
+    read();
+  }
+
+  asio::const_buffer
+  await_resume() const
+  {
+    check();
+    if (overflow_)
+    {
+      throw std::length_error("utl::io::tcp: frame exceeds maximum size");
+    }
+    return frame_;
+  }
+
+  void
+  complete(asio::error_code const& ec, std::size_t bytes_received)
+  {
+    if (!ec)
+    {
+      con_.end_ += bytes_received;
+      if (!con_.next_frame(frame_, overflow_))
+      {
+        read();
+        return;
+      }
+    }
+    resume(ec);
+  }
+
+private:
+  void
+  read()
+  {
+    con_.socket_.async_read_some(
+        asio::buffer(con_.buffer_.data() + con_.end_,
+                     con_.buffer_.size() - con_.end_),
+        completion<read_awaiter>(this));
+  }
+
+  co_connection<Framer>&  con_;
+  asio::const_buffer      frame_;
+  bool                    overflow_;
+};
+
+template<typename Socket>
+class write_awaiter
+: public io_awaiter
+{
+public:
+  write_awaiter(Socket& socket, asio::const_buffer buf, shared_buffer keep)
+  : socket_(socket)
+  , buf_(buf)
+  , keep_(std::move(keep))
+  {}
+
+  void
+  await_suspend(std::coroutine_handle<> h)
+  {
+    handle_ = h;
+    asio::async_write(socket_, asio::buffer(buf_),
+                      completion<write_awaiter>(this));
+  }
+
+  void await_resume() const   { check(); }
+
+  void
+  complete(asio::error_code const& ec, std::size_t /*bytes_sent*/)
+  {
+    resume(ec);
+  }
+
+private:
+  Socket&             socket_;
+  asio::const_buffer  buf_;
+  shared_buffer       keep_;    // Keeps a shared buffer alive
+};
+
+template<typename Acceptor, typename Socket>
+class accept_awaiter
+: public io_awaiter
+{
+public:
+  accept_awaiter(Acceptor& acceptor, Socket& socket)
+  : acceptor_(acceptor)
+  , socket_(socket)
+  {}
+
+  void
+  await_suspend(std::coroutine_handle<> h)
+  {
+    handle_ = h;
+    acceptor_.async_accept(socket_, completion<accept_awaiter>(this));
+  }
+
+  void await_resume() const   { check(); }
+
+  void complete(asio::error_code const& ec)   { resume(ec); }
+
+private:
+  Acceptor& acceptor_;
+  Socket&   socket_;
+};
+
+template<typename Socket, typename Endpoint>
+class connect_awaiter
+: public io_awaiter
+{
+public:
+  connect_awaiter(Socket& socket, Endpoint const& endpoint)
+  : socket_(socket)
+  , endpoint_(endpoint)
+  {}
+
+  void
+  await_suspend(std::coroutine_handle<> h)
+  {
+    handle_ = h;
+    socket_.async_connect(typename Socket::endpoint_type(endpoint_),
+                          completion<connect_awaiter>(this));
+  }
+
+  void await_resume() const   { check(); }
+
+  void complete(asio::error_code const& ec)   { resume(ec); }
+
+private:
+  Socket&   socket_;
+  Endpoint  endpoint_;
+};
+
+// Resolves a host and service, then connects to the first
+// endpoint that accepts.
+template<typename Socket>
+class resolve_awaiter
+: public io_awaiter
+{
+public:
+  resolve_awaiter(Socket& socket, std::string const& host,
+                  std::string const& service)
+  : socket_(socket)
+  , resolver_(detail::io_service_of(socket))
+  , query_(host, service)
+  , it_()
+  {}
+
+  void
+  await_suspend(std::coroutine_handle<> h)
+  {
+    handle_ = h;
+    resolver_.async_resolve(query_, completion<resolve_awaiter>(this));
+  }
+
+  void await_resume() const   { check(); }
+
+  // Resolved:  connect to the first endpoint.
+  void
+  complete(asio::error_code const& ec, asio::ip::tcp::resolver::iterator it)
+  {
+    if (ec)
+    {
+      resume(ec);
+      return;
+    }
+    it_ = it;
+    connect();
+  }
+
+  // Connected or failed:  try the next endpoint on failure.
+  void
+  complete(asio::error_code const& ec)
+  {
+    if (ec && (ec != asio::error::operation_aborted) &&
+        (++it_ != asio::ip::tcp::resolver::iterator()))
+    {
+      asio::error_code ignored_ec;
+      socket_.close(ignored_ec);
+      connect();
+      return;
+    }
+    resume(ec);
+  }
+
+private:
+  void
+  connect()
+  {
+    socket_.async_connect(typename Socket::endpoint_type(it_->endpoint()),
+                          completion<resolve_awaiter>(this));
+  }
+
+  Socket&                             socket_;
+  asio::ip::tcp::resolver             resolver_;
+  asio::ip::tcp::resolver::query      query_;
+  asio::ip::tcp::resolver::iterator   it_;
+};
+
+} // detail -----------------------------------------------------------------
+
+/// @addtogroup utl_asio
+/// @{
+
+//---------------------------------------------------------------------------
+/// @brief  Coroutine that produces a value of type @a T.
+///
+/// A task starts when awaited, and resumes the awaiting coroutine when
+/// it returns.  An exception thrown by the task is rethrown from the
+/// `co_await` expression.  Use spawn() to start a task from ordinary
+/// code.
+///
+/// Coroutine frames are recycled through thread-local free lists
+/// rather than returned to the heap, so a steady stream of short tasks
+/// allocates nothing once the lists are warm.
+///
+/// A lambda that returns a task should take its state as parameters
+/// rather than captures:  the closure may be destroyed before the task
+/// finishes, but parameters are kept in the coroutine frame.
+template<typename T=void>
+class task
+{
+public:
+  using promise_type = detail::task_promise<T>;
+
+  task(task&& other) noexcept
+  : handle_(std::exchange(other.handle_, nullptr))
+  {}
+
+  task&
+  operator=(task&& other) noexcept
+  {
+    if (this != &other)
+    {
+      if (handle_) { handle_.destroy(); }
+      handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+  }
+
+  ~task()
+  {
+    if (handle_) { handle_.destroy(); }
+  }
+
+  /// Starts the task and awaits its result.
+  auto
+  operator co_await() && noexcept
+  {
+    struct awaiter
+    {
+      std::coroutine_handle<promise_type> handle;
+
+      bool await_ready() const noexcept   { return false; }
+
+      std::coroutine_handle<>
+      await_suspend(std::coroutine_handle<> continuation) const noexcept
+      {
+        handle.promise().continuation_ = continuation;
+        return handle;
+      }
+
+      T await_resume() const  { return handle.promise().result(); }
+    };
+    return awaiter{ handle_ };
+  }
+
+private:
+  friend promise_type;
+
+  explicit
+  task(std::coroutine_handle<promise_type> h) noexcept
+  : handle_(h)
+  {}
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+/// @brief  Runs task @a t on @a ios without waiting for it.
+///
+/// The task starts on a thread running `ios.run()`.  An exception that
+/// escapes the task is rethrown out of `ios.run()`.
+void spawn(asio::io_service& ios, task<void> t);
+
+//---------------------------------------------------------------------------
+/// @brief  Connection whose operations are awaited from a coroutine.
+/// @tparam Framer  Framer that splits the byte stream into frames
+///                 (see utl/asio/tcp/framing.hpp).
+///
+/// Each operation returns an awaiter that keeps the memory for its
+/// completion handler, so reads and writes allocate nothing; a coroutine
+/// awaiting them allocates only its own frame, which task recycles.
+/// Operations throw `asio::system_error` on failure, including
+/// `asio::error::eof` when the peer closes the connection.
+///
+/// Await operations from a thread running the io_service of the socket.
+/// At most one read and one write may be outstanding at a time, and the
+/// connection must not be moved or destroyed while either is.
+///
+/// Example usage:
+/// ```
+///   utl::io::tcp::task<>
+///   echo(utl::io::tcp::co_connection<> con)
+///   {
+///     for (;;)
+///     {
+///       asio::const_buffer line = co_await con.read_frame();
+///       std::string reply(asio::buffer_cast<char const*>(line),
+///                         asio::buffer_size(line));
+///       co_await con.write(reply + '\n');
+///     }
+///   }
+/// ```
+template<typename Framer=delimited_framer>
+class co_connection
+{
+public:
+
+  /// Socket of any stream protocol, such as TCP or Unix domain.
+  using socket_type = connection::socket_type;
+
+  /// @brief  Construct an unconnected connection.
+  /// @param  [in]  ios         I/O service that runs the connection.
+  /// @param  [in]  framer      Framer that defines the frames.
+  /// @param  [in]  buffer_size Initial size of the read buffer in bytes.
+  explicit
+  co_connection(asio::io_service& ios, Framer framer=Framer(),
+                std::size_t buffer_size=connection::default_buffer_size);
+
+  /// @brief  Construct a connection over a connected socket.
+  /// @param  [in]  socket      Connected socket.
+  /// @param  [in]  framer      Framer that defines the frames.
+  /// @param  [in]  buffer_size Initial size of the read buffer in bytes.
+  explicit
+  co_connection(socket_type socket, Framer framer=Framer(),
+                std::size_t buffer_size=connection::default_buffer_size);
+
+  co_connection(co_connection&&) = default;
+  co_connection& operator=(co_connection&&) = default;
+
+  /// Returns the socket.
+  socket_type& socket()   { return socket_; }
+
+  /// Returns `true` if the socket is open.
+  bool is_open() const    { return socket_.is_open(); }
+
+  /// @brief  Close the socket.
+  ///
+  /// Outstanding operations throw `asio::error::operation_aborted`.
+  void close();
+
+  //-----------------------------------------------------------
+  /// @name Awaitable Operations
+  /// @{
+
+  /// @brief  Accept the next connection on @a acceptor.
+  ///
+  /// `co_await con.accept(acceptor);`
+  template<typename Acceptor>
+  detail::accept_awaiter<Acceptor, socket_type>
+  accept(Acceptor& acceptor);
+
+  /// @brief  Resolve @a host and @a service and connect to the first
+  ///         TCP endpoint that accepts.
+  ///
+  /// `co_await con.connect("localhost", "8080");`
+  detail::resolve_awaiter<socket_type>
+  connect(std::string const& host, std::string const& service);
+
+  /// @brief  Connect to @a endpoint of any stream protocol.
+  ///
+  /// `co_await con.connect(endpoint);`
+  template<typename Endpoint>
+  detail::connect_awaiter<socket_type, Endpoint>
+  connect(Endpoint const& endpoint);
+
+  /// @brief  Read the next frame.
+  ///
+  /// `asio::const_buffer frame = co_await con.read_frame();`
+  ///
+  /// The frame refers to the read buffer of the connection and is valid
+  /// until the next read_frame().  Frames already buffered are returned
+  /// without suspending.  Throws `std::length_error` if a frame exceeds
+  /// the framer's maximum size, after which the stream cannot be resumed.
+  detail::read_awaiter<Framer>
+  read_frame();
+
+  /// @brief  Write all of @a buf.
+  ///
+  /// `co_await con.write(buf);`
+  ///
+  /// The data must remain valid until the write completes.
+  detail::write_awaiter<socket_type>
+  write(asio::const_buffer buf);
+
+  /// Write all of a shared buffer, which is kept until the write completes.
+  detail::write_awaiter<socket_type>
+  write(shared_buffer buf);
+
+  /// Write a copy of @a str.
+  detail::write_awaiter<socket_type>
+  write(std::string str);
+
+  /// @}
+  //-----------------------------------------------------------
+
+private:
+
+  template<typename> friend class detail::read_awaiter;
+
+  // Finds the next buffered frame, or makes room to read more data and
+  // returns false.  Also returns true on overflow.
+  bool next_frame(asio::const_buffer& frame, bool& overflow);
+
+  socket_type       socket_;    // Socket for this connection
+  Framer            framer_;    // Defines the frames
+  std::vector<char> buffer_;    // Received data in [begin_, end_)
+  std::size_t       begin_;
+  std::size_t       end_;
+
+};
+
+/// @}
+
+//===========================================================================//
+// Implementation
+
+namespace detail {  //-------------------------------------------------------
+
+template<typename T>
+inline task<T>
+task_promise<T>::get_return_object() noexcept
+{
+  return task<T>(std::coroutine_handle<task_promise>::from_promise(*this));
+}
+
+inline task<void>
+task_promise<void>::get_return_object() noexcept
+{
+  return task<void>(std::coroutine_handle<task_promise>::from_promise(*this));
+}
+
+// Awaits t, and passes any exception to the thread running ios.
+inline detached_task
+run_detached(asio::io_service& ios, task<void> t)
+{
+  std::exception_ptr error;
+  try
+  {
+    co_await std::move(t);
+  }
+  catch (...)
+  {
+    error = std::current_exception();
+  }
+  if (error)
+  {
+    ios.post([error]() { std::rethrow_exception(error); });
+  }
+}
+
+} // detail -----------------------------------------------------------------
+
+inline void
+spawn(asio::io_service& ios, task<void> t)
+{
+  std::coroutine_handle<> h = detail::run_detached(ios, std::move(t)).handle;
+  ios.post([h]() { h.resume(); });
+}
+
+//---------------------------------------------------------------------------
+
+template<typename Framer>
+inline
+co_connection<Framer>::co_connection(asio::io_service& ios, Framer framer,
+                                     std::size_t buffer_size)
+: socket_(ios)
+, framer_(std::move(framer))
+, buffer_(buffer_size)
+, begin_(0)
+, end_(0)
+{}
+
+template<typename Framer>
+inline
+co_connection<Framer>::co_connection(socket_type socket, Framer framer,
+                                     std::size_t buffer_size)
+: socket_(std::move(socket))
+, framer_(std::move(framer))
+, buffer_(buffer_size)
+, begin_(0)
+, end_(0)
+{}
+
+template<typename Framer>
+inline void
+co_connection<Framer>::close()
+{
+  if (socket_.is_open())
+  {
+    asio::error_code ignored_ec;
+    socket_.shutdown(socket_type::shutdown_both, ignored_ec);
+    socket_.close(ignored_ec);
+  }
+}
+
+template<typename Framer>
+template<typename Acceptor>
+inline detail::accept_awaiter<Acceptor,
+                              typename co_connection<Framer>::socket_type>
+co_connection<Framer>::accept(Acceptor& acceptor)
+{
+  close();
+  begin_ = end_ = 0;
+  return detail::accept_awaiter<Acceptor, socket_type>(acceptor, socket_);
+}
+
+template<typename Framer>
+inline detail::resolve_awaiter<typename co_connection<Framer>::socket_type>
+co_connection<Framer>::connect(std::string const& host,
+                               std::string const& service)
+{
+  close();
+  begin_ = end_ = 0;
+  return detail::resolve_awaiter<socket_type>(socket_, host, service);
+}
+
+template<typename Framer>
+template<typename Endpoint>
+inline detail::connect_awaiter<typename co_connection<Framer>::socket_type,
+                               Endpoint>
+co_connection<Framer>::connect(Endpoint const& endpoint)
+{
+  close();
+  begin_ = end_ = 0;
+  return detail::connect_awaiter<socket_type, Endpoint>(socket_, endpoint);
+}
+
+template<typename Framer>
+inline detail::read_awaiter<Framer>
+co_connection<Framer>::read_frame()
+{
+  return detail::read_awaiter<Framer>(*this);
+}
+
+template<typename Framer>
+inline detail::write_awaiter<typename co_connection<Framer>::socket_type>
+co_connection<Framer>::write(asio::const_buffer buf)
+{
+  return detail::write_awaiter<socket_type>(socket_, buf, shared_buffer());
+}
+
+template<typename Framer>
+inline detail::write_awaiter<typename co_connection<Framer>::socket_type>
+co_connection<Framer>::write(shared_buffer buf)
+{
+  asio::const_buffer const data = asio::buffer(*buf);
+  return detail::write_awaiter<socket_type>(socket_, data, std::move(buf));
+}
+
+template<typename Framer>
+inline detail::write_awaiter<typename co_connection<Framer>::socket_type>
+co_connection<Framer>::write(std::string str)
+{
+  return write(make_shared_buffer(std::move(str)));
+}
+
+// private ----------------------------------------------------
+
+template<typename Framer>
+inline bool
+co_connection<Framer>::next_frame(asio::const_buffer& frame, bool& overflow)
+{
+  std::size_t const n = framer_.parse(buffer_.data() + begin_,
+                                      end_ - begin_, frame);
+  if (n == frame_overflow)
+  {
+    begin_ = end_ = 0;
+    overflow = true;
+    return true;
+  }
+  if (n != 0)
+  {
+    begin_ += n;
+    return true;
+  }
+
+  // Move the partial frame to the front, and grow if the buffer is full.
+  std::size_t const used = end_ - begin_;
+  if ((begin_ != 0) && (used != 0))
+  {
+    std::memmove(buffer_.data(), buffer_.data() + begin_, used);
+  }
+  begin_ = 0;
+  end_   = used;
+  if (end_ == buffer_.size())
+  {
+    buffer_.resize((buffer_.size() < 64) ? 128 : (buffer_.size() * 2));
+  }
+  return false;
+}
+
+//---------------------------------------------------------------------------//
+} } } // utl::io::tcp
+
+#endif // UTL_IO_HAS_COROUTINES
+
+#endif // UTL_IO_TCP_COROUTINE_HPP
+//===========================================================================//
@@ -0,0 +1,518 @@
+/*
+Licensed under the MIT License <http://opensource.org/licenses/MIT>
+
+Copyright 2018 Nathan Lucas <nathan.lucas@wayne.edu>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+//===========================================================================//
+/// @file
+/// @brief    TCP message framing.
+/// @details  Splits the byte stream of a connection or client into
+///           delimited, length-prefixed, or fixed-size frames.
+/// @author   Nathan Lucas
+/// @date     2018
+//===========================================================================//
+#ifndef UTL_IO_TCP_FRAMING_HPP
+#define UTL_IO_TCP_FRAMING_HPP
+
+#ifndef __cplusplus
+#error must be compiled as C++
+#endif
+
+#include <utl/asio/tcp/connection.hpp>  // utl::io::tcp::connection_ptr
+
+#include <cstddef>      // std::size_t
+#include <cstring>      // std::memchr, std::memcpy, std::memmove
+#include <stdexcept>    // std::invalid_argument, std::length_error
+#include <type_traits>  // std::decay, std::is_unsigned
+#include <utility>      // std::forward, std::move
+#include <vector>       // std::vector
+
+namespace utl { namespace io { namespace tcp {
+
+/// @addtogroup utl_asio
+/// @{
+
+//---------------------------------------------------------------------------
+/// @name Framers
+///
+/// A framer finds the first frame at the start of a byte range.  Its
+/// `parse(data, size, frame)` member sets @a frame to the payload and
+/// returns the number of bytes the frame occupies, returns `0` if the
+/// range does not yet hold a complete frame, or returns #frame_overflow
+/// if the frame would exceed `max_frame()` bytes.
+///
+/// Its `complete(head, used, data, size)` member returns how many bytes
+/// of [@a data, @a data + @a size) to append to the incomplete frame
+/// [@a head, @a head + @a used) to finish it, or to make progress
+/// toward it, and is nonzero if @a size is.  frame_reader copies only
+/// those bytes, and parses the rest of @a data in place.
+/// @{
+
+/// Returned by a framer when a frame exceeds its maximum size.
+constexpr std::size_t frame_overflow = static_cast<std::size_t>(-1);
+
+/// Byte order of a length prefix.
+enum class byte_order
+{
+  big,      ///< Most significant byte first (network order).
+  little    ///< Least significant byte first.
+};
+
+/// @brief  Frames terminated by a delimiter character.
+///
+/// The delimiter is not part of the frame.
+class delimited_framer
+{
+public:
+
+  /// @brief  Constructor.
+  /// @param  [in]  max_frame   Maximum frame size in bytes.
+  /// @param  [in]  delim       Delimiter character.
+  explicit
+  delimited_framer(std::size_t max_frame=65536, char delim='\n')
+  : max_frame_(max_frame)
+  , delim_(delim)
+  {}
+
+  /// Returns the maximum frame size in bytes.
+  std::size_t
+  max_frame() const   { return max_frame_; }
+
+  /// Finds the first frame in [@a data, @a data + @a size).
+  std::size_t
+  parse(char const* data, std::size_t size, asio::const_buffer& frame) const;
+
+  /// Returns the bytes of @a data that finish an incomplete frame.
+  std::size_t
+  complete(char const* head, std::size_t used,
+           char const* data, std::size_t size) const;
+
+private:
+  std::size_t max_frame_;
+  char        delim_;
+};
+
+/// @brief  Frames preceded by their length as an unsigned integer.
+/// @tparam Length  Type of the length prefix, such as `std::uint16_t`
+///                 or `std::uint32_t`.
+/// @tparam Order   Byte order of the length prefix.
+///
+/// The length counts the payload only, not the prefix.
+template<typename Length, byte_order Order=byte_order::big>
+class length_framer
+{
+  static_assert(std::is_unsigned<Length>::value,
+                "Length must be an unsigned integer type");
+public:
+
+  /// Type of the length prefix.
+  typedef Length length_type;
+
+  /// Size of the length prefix in bytes.
+  static constexpr std::size_t header_size = sizeof(Length);
+
+  /// @brief  Constructor.
+  /// @param  [in]  max_frame   Maximum payload size in bytes.
+  explicit
+  length_framer(std::size_t max_frame=65536)
+  : max_frame_(max_frame)
+  {}
+
+  /// Returns the maximum payload size in bytes.
+  std::size_t
+  max_frame() const   { return max_frame_; }
+
+  /// Finds the first frame in [@a data, @a data + @a size).
+  std::size_t
+  parse(char const* data, std::size_t size, asio::const_buffer& frame) const;
+
+  /// Returns the bytes of @a data that finish an incomplete frame.
+  std::size_t
+  complete(char const* head, std::size_t used,
+           char const* data, std::size_t size) const;
+
+  /// Writes the length prefix for a payload of @a size bytes to @a out.
+  static void
+  put_header(char* out, Length size);
+
+private:
+  std::size_t max_frame_;
+};
+
+/// @brief  Frames of a fixed size.
+class fixed_framer
+{
+public:
+
+  /// @brief  Constructor.
+  /// @param  [in]  size  Frame size in bytes.
+  /// @throw  std::invalid_argument if @a size is zero.
+  explicit
+  fixed_framer(std::size_t size)
+  : size_(size)
+  {
+    if (size == 0) { throw std::invalid_argument("fixed_framer: zero size"); }
+  }
+
+  /// Returns the frame size in bytes.
+  std::size_t
+  max_frame() const   { return size_; }
+
+  /// Finds the first frame in [@a data, @a data + @a size).
+  std::size_t
+  parse(char const* data, std::size_t size, asio::const_buffer& frame) const;
+
+  /// Returns the bytes of @a data that finish an incomplete frame.
+  std::size_t
+  complete(char const* head, std::size_t used,
+           char const* data, std::size_t size) const;
+
+private:
+  std::size_t size_;
+};
+
+/// @}
+//---------------------------------------------------------------------------
+/// @brief  Reassembles frames from a byte stream.
+/// @tparam Framer  Framer type.
+///
+/// Complete frames are delivered straight from the buffer passed to
+/// read().  Only the part of a frame that spans two reads is copied,
+/// into a buffer that grows as needed; once that frame is finished, the
+/// rest of the read is again parsed in place.  The framer's maximum frame size
+/// bounds the buffered data to about one frame plus one read.
+template<typename Framer>
+class frame_reader
+{
+public:
+
+  /// Constructor.
+  explicit
+  frame_reader(Framer framer=Framer())
+  : framer_(std::move(framer))
+  , buffer_()
+  , begin_(0)
+  , end_(0)
+  {}
+
+  /// @brief  Passes each complete frame in the stream to @a on_frame.
+  /// @param  [in]  data      Next bytes of the stream.
+  /// @param  [in]  size      Number of bytes.
+  /// @param  [in]  on_frame  Called as `on_frame(asio::const_buffer)`;
+  ///                         the buffer is valid only during the call.
+  /// @return `false` if a frame exceeds the maximum size, in which case
+  ///         buffered data is discarded and the stream cannot be resumed.
+  template<typename Handler>
+  bool
+  read(char const* data, std::size_t size, Handler&& on_frame);
+
+  /// Returns the number of bytes buffered toward the next frame.
+  std::size_t
+  buffered() const    { return (end_ - begin_); }
+
+  /// Discards buffered data.
+  void
+  clear()             { begin_ = end_ = 0; }
+
+  /// Returns the framer.
+  Framer const&
+  framer() const      { return framer_; }
+
+private:
+
+  // Delivers complete frames; returns bytes consumed or frame_overflow.
+  template<typename Handler>
+  std::size_t split(char const* data, std::size_t size, Handler& on_frame);
+
+  void append(char const* data, std::size_t size);
+
+  Framer            framer_;
+  std::vector<char> buffer_;    // partial frame in [begin_, end_)
+  std::size_t       begin_;
+  std::size_t       end_;
+};
+
+//---------------------------------------------------------------------------
+/// @brief  Read handler that delivers whole frames.
+///
+/// Usable as a connection::buffer_handler, in which case a connection
+/// that sends an oversized frame is stopped, or as a
+/// client::buffer_handler, in which case an oversized frame throws
+/// `std::length_error` out of client::run().
+///
+/// Each connection holds its own copy of the handler, and so its own
+/// reassembly state.  Create with framed().
+template<typename Framer, typename Handler>
+class framed_handler
+{
+public:
+
+  framed_handler(Framer framer, Handler handler)
+  : reader_(std::move(framer))
+  , handler_(std::move(handler))
+  {}
+
+  void
+  operator()(asio::const_buffer const& buf, connection_ptr con)
+  {
+    if (!reader_.read(asio::buffer_cast<char const*>(buf),
+                      asio::buffer_size(buf),
+                      [this, &con](asio::const_buffer const& frame)
+                      {
+                        handler_(frame, con);
+                      }))
+    {
+      con->stop();
+    }
+  }
+
+  void
+  operator()(asio::const_buffer const& buf)
+  {
+    if (!reader_.read(asio::buffer_cast<char const*>(buf),
+                      asio::buffer_size(buf), handler_))
+    {
+      throw std::length_error("utl::io::tcp: frame exceeds maximum size");
+    }
+  }
+
+private:
+  frame_reader<Framer>  reader_;
+  Handler               handler_;
+};
+
+/// @brief  Returns a read handler that passes each complete frame to
+///         @a handler.
+/// @param  [in]  framer    Framer that defines the frames.
+/// @param  [in]  handler   Called as `handler(frame, con)` for a
+///                         connection, or `handler(frame)` for a client.
+///
+/// Example usage:
+/// ```
+///   utl::io::tcp::server server(port, 8192, utl::io::tcp::framed(
+///       utl::io::tcp::length_framer<std::uint32_t>(1 << 20),
+///       [](asio::const_buffer const& frame, utl::io::tcp::connection_ptr)
+///       {
+///         // ...
+///       }));
+/// ```
+template<typename Framer, typename Handler>
+inline framed_handler<Framer, typename std::decay<Handler>::type>
+framed(Framer framer, Handler&& handler)
+{
+  return framed_handler<Framer, typename std::decay<Handler>::type>(
+      std::move(framer), std::forward<Handler>(handler));
+}
+
+/// @}
+
+//===========================================================================//
+// Implementation
+
+inline std::size_t
+delimited_framer::parse(char const* data, std::size_t size,
+                        asio::const_buffer& frame) const
+{
+  std::size_t const n = ((size <= max_frame_) ? size : (max_frame_ + 1));
+  char const* end = static_cast<char const*>(std::memchr(data, delim_, n));
+  if (end == nullptr)
+  {
+    return ((size > max_frame_) ? frame_overflow : 0);
+  }
+  frame = asio::const_buffer(data, end - data);
+  return ((end - data) + 1);
+}
+
+inline std::size_t
+delimited_framer::complete(char const*, std::size_t used,
+                           char const* data, std::size_t size) const
+{
+  // The buffered bytes hold no delimiter, so the frame ends at the first
+  // one in data.  Take no more than enough to detect an overflow.
+  std::size_t const limit = ((used <= max_frame_) ? (max_frame_ + 1 - used)
+                                                  : 1);
+  std::size_t const n = ((size <= limit) ? size : limit);
+  char const* end = static_cast<char const*>(std::memchr(data, delim_, n));
+  return ((end == nullptr) ? n : ((end - data) + 1));
+}
+
+//---------------------------------------------------------------------------
+
+template<typename Length, byte_order Order>
+constexpr std::size_t length_framer<Length, Order>::header_size;
+
+template<typename Length, byte_order Order>
+inline std::size_t
+length_framer<Length, Order>::parse(char const* data, std::size_t size,
+                                    asio::const_buffer& frame) const
+{
+  if (size < header_size) { return 0; }
+  unsigned char const* p = reinterpret_cast<unsigned char const*>(data);
+  std::size_t length = 0;
+  for (std::size_t i = 0; i != header_size; ++i)
+  {
+    std::size_t const k = ((Order == byte_order::big) ? i
+                                                      : (header_size - 1 - i));
+    length = (length << 8) | p[k];
+  }
+  if (length > max_frame_)            { return frame_overflow; }
+  if ((size - header_size) < length)  { return 0; }
+  frame = asio::const_buffer(data + header_size, length);
+  return (header_size + length);
+}
+
+template<typename Length, byte_order Order>
+inline std::size_t
+length_framer<Length, Order>::complete(char const* head, std::size_t used,
+                                       char const*, std::size_t size) const
+{
+  // Finish the header first; the payload length is then known.
+  std::size_t n = (header_size - used);
+  if (used >= header_size)
+  {
+    unsigned char const* p = reinterpret_cast<unsigned char const*>(head);
+    std::size_t length = 0;
+    for (std::size_t i = 0; i != header_size; ++i)
+    {
+      std::size_t const k = ((Order == byte_order::big) ? i
+                                                        : (header_size - 1 - i));
+      length = (length << 8) | p[k];
+    }
+    n = (header_size + length - used);
+  }
+  return ((size <= n) ? size : n);
+}
+
+template<typename Length, byte_order Order>
+inline void
+length_framer<Length, Order>::put_header(char* out, Length size)
+{
+  for (std::size_t i = 0; i != header_size; ++i)
+  {
+    std::size_t const k = ((Order == byte_order::big) ? (header_size - 1 - i)
+                                                      : i);
+    out[k] = static_cast<char>((size >> (8 * i)) & 0xFF);
+  }
+}
+
+//---------------------------------------------------------------------------
+
+inline std::size_t
+fixed_framer::parse(char const* data, std::size_t size,
+                    asio::const_buffer& frame) const
+{
+  if (size < size_) { return 0; }
+  frame = asio::const_buffer(data, size_);
+  return size_;
+}
+
+inline std::size_t
+fixed_framer::complete(char const*, std::size_t used,
+                       char const*, std::size_t size) const
+{
+  std::size_t const n = (size_ - used);
+  return ((size <= n) ? size : n);
+}
+
+//---------------------------------------------------------------------------
+
+template<typename Framer>
+template<typename Handler>
+inline bool
+frame_reader<Framer>::read(char const* data, std::size_t size,
+                           Handler&& on_frame)
+{
+  // Copy only what finishes the buffered frame, one framer step at a time.
+  while ((begin_ != end_) && (size != 0))
+  {
+    std::size_t const k = framer_.complete(buffer_.data() + begin_,
+                                           end_ - begin_, data, size);
+    append(data, k);
+    data += k;
+    size -= k;
+    std::size_t const n = split(buffer_.data() + begin_, end_ - begin_,
+                                on_frame);
+    if (n == frame_overflow)
+    {
+      clear();
+      return false;
+    }
+    begin_ += n;
+    if (begin_ == end_) { clear(); }
+  }
+
+  // Nothing buffered:  parse in place, and keep only the remainder.
+  std::size_t const n = split(data, size, on_frame);
+  if (n == frame_overflow) { return false; }
+  append(data + n, size - n);
+  return true;
+}
+
+template<typename Framer>
+template<typename Handler>
+inline std::size_t
+frame_reader<Framer>::split(char const* data, std::size_t size,
+                            Handler& on_frame)
+{
+  std::size_t total = 0;
+  for (;;)
+  {
+    asio::const_buffer frame;
+    std::size_t const n = framer_.parse(data + total, size - total, frame);
+    if (n == frame_overflow)  { return frame_overflow; }
+    if (n == 0)               { return total; }
+    on_frame(frame);
+    total += n;
+  }
+}
+
+template<typename Framer>
+inline void
+frame_reader<Framer>::append(char const* data, std::size_t size)
+{
+  if (size == 0) { return; }
+  if ((end_ + size) > buffer_.size())
+  {
+    // Move the partial frame to the front, growing if it still won't fit.
+    std::size_t const used = end_ - begin_;
+    if ((used + size) > buffer_.size())
+    {
+      std::size_t capacity = (buffer_.size() * 2);
+      if (capacity < (used + size)) { capacity = (used + size); }
+      std::vector<char> grown(capacity);
+      if (used != 0) { std::memcpy(grown.data(), buffer_.data() + begin_, used); }
+      buffer_.swap(grown);
+    }
+    else if (used != 0)
+    {
+      std::memmove(buffer_.data(), buffer_.data() + begin_, used);
+    }
+    begin_ = 0;
+    end_   = used;
+  }
+  std::memcpy(buffer_.data() + end_, data, size);
+  end_ += size;
+}
+
+} } } // utl::io::tcp
+
+#endif // UTL_IO_TCP_FRAMING_HPP
+//===========================================================================//
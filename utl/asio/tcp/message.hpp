@@ -0,0 +1,108 @@
+/*
+Licensed under the MIT License <http://opensource.org/licenses/MIT>
+
+Copyright 2018 Nathan Lucas <nathan.lucas@wayne.edu>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+//===========================================================================//
+/// @file
+/// @brief    TCP binary messages.
+/// @details  Length-prefixed frames whose payload is a utl::serialize
+///           encoding.
+/// @author   Nathan Lucas
+/// @date     2018
+//===========================================================================//
+#ifndef UTL_IO_TCP_MESSAGE_HPP
+#define UTL_IO_TCP_MESSAGE_HPP
+
+#ifndef __cplusplus
+#error must be compiled as C++
+#endif
+
+#include <utl/asio/tcp/buffer.hpp>    // utl::io::tcp::shared_buffer
+#include <utl/asio/tcp/framing.hpp>   // utl::io::tcp::length_framer
+#include <utl/serialize.hpp>          // utl::encode, utl::decode
+
+#include <cstddef>      // std::size_t
+#include <limits>       // std::numeric_limits
+#include <stdexcept>    // std::length_error
+#include <string>       // std::string
+#include <utility>      // std::move
+
+namespace utl { namespace io { namespace tcp {
+
+/// @addtogroup utl_asio
+/// @{
+
+/// @brief  Returns a frame whose payload is the encoding of @a v.
+/// @tparam Framer  A length_framer type.
+/// @throw  std::length_error if the encoding does not fit the length
+///         prefix.
+///
+/// The frame is encoded straight into the buffer that is queued for
+/// writing, without an intermediate copy or text formatting.
+///
+/// Example usage:
+/// ```
+///   using framer = utl::io::tcp::length_framer<std::uint32_t>;
+///   client.write(utl::io::tcp::encode_frame<framer>(quote));
+/// ```
+template<typename Framer, typename T>
+inline shared_buffer
+encode_frame(T const& v)
+{
+  using length_type = typename Framer::length_type;
+  std::size_t const n = utl::encoded_size(v);
+  if (n > std::numeric_limits<length_type>::max())
+  {
+    throw std::length_error("utl::io::tcp: message exceeds length prefix");
+  }
+  std::string buf(Framer::header_size + n, '\0');
+  Framer::put_header(&buf[0], static_cast<length_type>(n));
+  utl::encode(&buf[Framer::header_size], v);
+  return make_shared_buffer(std::move(buf));
+}
+
+/// @brief  Decodes @a v from the payload of @a frame, in place.
+/// @return `false` if the payload is not exactly one encoding of @a v.
+///
+/// Example usage:
+/// ```
+///   utl::io::tcp::framed(framer(),
+///       [](asio::const_buffer const& frame, utl::io::tcp::connection_ptr)
+///       {
+///         quote q;
+///         if (utl::io::tcp::decode_frame(frame, q)) { ... }
+///       });
+/// ```
+template<typename T>
+inline bool
+decode_frame(asio::const_buffer const& frame, T& v)
+{
+  return utl::decode(asio::buffer_cast<char const*>(frame),
+                     asio::buffer_size(frame), v);
+}
+
+/// @}
+
+} } } // utl::io::tcp
+
+#endif // UTL_IO_TCP_MESSAGE_HPP
+//===========================================================================//
@@ -34,6 +34,8 @@ SOFTWARE.
 #error must be compiled as C++
 #endif
 
+#include <utl/asio/detail/socket.hpp>
+#include <utl/asio/io_service_pool.hpp>
 #include <utl/asio/tcp/connection.hpp>
 
 //-----------------------------------------------------------
@@ -48,32 +50,119 @@ SOFTWARE.
 #pragma GCC diagnostic pop
 //-----------------------------------------------------------
 
+#include <mutex>        // std::lock_guard, std::mutex
 #include <string>       // std::string
 
 namespace utl { namespace io { namespace tcp {
+
+namespace detail {  //-------------------------------------------------------
+
+// Returns the endpoint to listen on.
+template<typename Endpoint>
+inline Endpoint const&
+listen_endpoint(Endpoint const& ep)
+{
+  return ep;
+}
+
+#if defined(ASIO_HAS_LOCAL_SOCKETS)
+// Removes a socket file left behind by a previous server.
+inline asio::local::stream_protocol::endpoint const&
+listen_endpoint(asio::local::stream_protocol::endpoint const& ep)
+{
+  io::detail::remove_stale_socket<asio::local::stream_protocol>(ep);
+  return ep;
+}
+#endif
+
+} // detail -----------------------------------------------------------------
+
 /// @addtogroup utl_asio
 /// @{
 
-/// TCP server that asynchronously accepts
-/// connections, reads data, and writes data.
-class server
+/// @brief  Stream socket server that asynchronously accepts
+///         connections, reads data, and writes data.
+/// @tparam Protocol  Stream protocol, such as `asio::ip::tcp` or
+///                   `asio::local::stream_protocol`.
+///
+/// A server can run on several threads, each with its own io_service.
+/// Accepted connections are assigned to the threads in turn, and the
+/// handlers of a connection always run on its thread.
+template<typename Protocol>
+class basic_server
 {
 public:
 
   using read_handler = connection::read_handler;
+  using buffer_handler = connection::buffer_handler;
+  using endpoint_type = typename Protocol::endpoint;
+
+  /// @brief  Construct a TCP server that discards received messages.
+  /// @param  [in]  port    TCP port number.
+  explicit
+  basic_server(unsigned short port)
+  : basic_server(endpoint_type(asio::ip::tcp::v4(), port))
+  {}
 
   /// @brief  Construct a TCP server.
   /// @param  [in]  port    TCP port number.
-  /// @param  [in]  handler Callback to process received messages.
+  /// @param  [in]  handler Callback to process a copy of received messages.
+  basic_server(unsigned short port, read_handler handler)
+  : basic_server(endpoint_type(asio::ip::tcp::v4(), port), std::move(handler))
+  {}
+
+  /// @brief  Construct a TCP server.
+  /// @param  [in]  port        TCP port number.
+  /// @param  [in]  buffer_size Size of the read buffer of each connection.
+  /// @param  [in]  handler     Callback to process received messages in
+  ///                           place, without allocation.
+  /// @param  [in]  threads     Number of threads run by run(), or `0` for
+  ///                           one per hardware thread.  With more than
+  ///                           one, @a handler is called concurrently for
+  ///                           different connections.
+  basic_server(unsigned short port, std::size_t buffer_size,
+               buffer_handler handler, std::size_t threads=1)
+  : basic_server(endpoint_type(asio::ip::tcp::v4(), port), buffer_size,
+                 std::move(handler), threads)
+  {}
+
+  /// @brief  Construct a server that discards received messages.
+  /// @param  [in]  ep      Endpoint to listen on.
   explicit
-  server(unsigned short port,
-         read_handler handler = [](std::string const&, connection_ptr){})
-  : io_service_()
-  , work_(io_service_)
-  , acceptor_(io_service_, asio::ip::tcp::endpoint(asio::ip::tcp::v4(), port))
+  basic_server(endpoint_type const& ep)
+  : basic_server(ep, connection::default_buffer_size,
+                 [](asio::const_buffer const&, connection_ptr){})
+  {}
+
+  /// @brief  Construct a server.
+  /// @param  [in]  ep      Endpoint to listen on.
+  /// @param  [in]  handler Callback to process a copy of received messages.
+  basic_server(endpoint_type const& ep, read_handler handler)
+  : basic_server(ep, connection::default_buffer_size,
+                 connection::copy_to(std::move(handler)))
+  {}
+
+  /// @brief  Construct a server.
+  /// @param  [in]  ep          Endpoint to listen on.  A Unix domain
+  ///                           socket file left at its path is removed
+  ///                           if no socket is bound to it.
+  /// @param  [in]  buffer_size Size of the read buffer of each connection.
+  /// @param  [in]  handler     Callback to process received messages in
+  ///                           place, without allocation.
+  /// @param  [in]  threads     Number of threads run by run(), or `0` for
+  ///                           one per hardware thread.
+  /// @throw  std::invalid_argument if @a buffer_size is `0`.
+  /// @throw  asio::system_error if @a ep is in use, including a Unix
+  ///         domain path held by a live socket or by another file.
+  basic_server(endpoint_type const& ep, std::size_t buffer_size,
+               buffer_handler handler, std::size_t threads=1)
+  : pool_(threads)
+  , acceptor_(pool_.get(0), detail::listen_endpoint(ep))
   , connections_()
-  , socket_(io_service_)
-  , handler_(handler)
+  , socket_(pool_.get(0))
+  , handler_(std::move(handler))
+  , buffer_size_(detail::checked_buffer_size(buffer_size))
+  , limits_()
   {
     // Endpoint to associated with sockets.
     // Will listen on the specified port for IP version 4 (IPv4).
@@ -94,31 +183,33 @@ public:
   ///
   /// The run() function blocks until stop() is called to discontinue
   /// accepting client connections and close all open connections.
+  /// The calling thread and `threads - 1` new threads run the server.
   void
   run()
   {
     // io_service::run() will block until all asynchronous
     // operations have finished, including the asynchronous
     // accept call waiting for new incoming connections.
-    io_service_.run();
+    pool_.run();
   }
 
   /// @brief  Stop accepting client connections and close all open connections.
   ///
   /// Cancels all outstanding asynchronous operations.  Once all
   /// operations have finished the io_service::run() call can exit.
+  /// Called before run(), run() returns as soon as it is called.
   void
   stop()
   {
-    acceptor_.close();
-    connections_.stop_all();
+    if (!pool_.running())
+    {
+      // No thread owns the acceptor and socket, so close them here.
+      close();
+      return;
+    }
 
-    // Initiate graceful connection closure.
-    // Shutdown both send and receive on the socket.
-    asio::error_code ignored_ec;
-    socket_.shutdown(asio::ip::tcp::socket::shutdown_both, ignored_ec);
-    socket_.close(ignored_ec);
-    io_service_.stop();
+    // The acceptor and socket belong to the accepting thread.
+    pool_.get(0).dispatch([this]() { close(); });
   }
 
   /// @brief  Returns the number of open connections.
@@ -135,19 +226,87 @@ public:
     connections_.write(str);
   }
 
-  /// Get the Asio io_service associated with the object.
+  /// @brief  Writes the specified shared data to all open connections,
+  ///         without copying it per connection.
+  void
+  write(shared_buffer const& buf)
+  {
+    connections_.write(buf);
+  }
+
+  /// @brief  Writes the specified shared data to one connection.
+  /// @return `false` if there is no connection with the specified ID.
+  bool
+  write(shared_buffer const& buf, connection_id id)
+  {
+    return connections_.write(buf, id);
+  }
+
+  /// @brief  Closes one connection.
+  /// @return `false` if there is no connection with the specified ID.
+  bool
+  disconnect(connection_id id)
+  {
+    return connections_.stop(id);
+  }
+
+  /// Returns the write queue limits of new connections.
+  write_limits
+  limits() const
+  {
+    std::lock_guard<std::mutex> lock(limits_mutex_);
+    return limits_;
+  }
+
+  /// @brief  Sets the write queue limits of new connections.
+  ///
+  /// With a high watermark, a broadcast holds at most that many bytes
+  /// for each connection, however slowly its client reads.
+  void
+  limits(write_limits const& val)
+  {
+    std::lock_guard<std::mutex> lock(limits_mutex_);
+    limits_ = val;
+  }
+
+  /// Get the Asio io_service that accepts connections.
   asio::io_service&
   io_service()
   {
-    return io_service_;
+    return pool_.get(0);
+  }
+
+  /// Returns the number of threads that run the server.
+  std::size_t
+  thread_count() const
+  {
+    return pool_.size();
   }
 
 private:
 
+  // Closes the acceptor and all connections, then lets run() return once
+  // the closes and the operations they cancel have finished.
+  void
+  close()
+  {
+    acceptor_.close();
+    connections_.stop_all();
+
+    // Initiate graceful connection closure.
+    // Shutdown both send and receive on the socket.
+    asio::error_code ignored_ec;
+    socket_.shutdown(socket_type::shutdown_both, ignored_ec);
+    socket_.close(ignored_ec);
+    pool_.release();
+  }
+
   // Asynchronously accept client connections.
   void
   do_accept()
   {
+    // Each connection gets the next io_service in turn.
+    socket_ = socket_type(pool_.next());
     acceptor_.async_accept(socket_,
         [this](std::error_code ec)
         {
@@ -159,21 +318,30 @@ private:
           if (!ec)
           {
             connections_.start(std::make_shared<connection>(
-                std::move(socket_), connections_ , handler_));
+                std::move(socket_), connections_ , handler_, buffer_size_,
+                limits()));
           }
           do_accept();
         });
   }
 
-  asio::io_service        io_service_;   // To perform asynchronous operations
-  asio::io_service::work  work_;         // Inform when work starts & finishes
-  asio::ip::tcp::acceptor acceptor_;     // Accepts incoming TCP connections
+  using acceptor_type = typename Protocol::acceptor;
+  using socket_type = typename Protocol::socket;
+
+  io_service_pool         pool_;         // To perform asynchronous operations
+  acceptor_type           acceptor_;     // Accepts incoming connections
   connection_manager      connections_;  // Owns all live connections
-  asio::ip::tcp::socket   socket_;       // Socket to be accepted
-  read_handler            handler_;      // Callback to read messages
+  socket_type             socket_;       // Socket to be accepted
+  buffer_handler          handler_;      // Callback to read messages
+  std::size_t             buffer_size_;  // Read buffer size per connection
+  write_limits            limits_;       // Write queue limits per connection
+  mutable std::mutex      limits_mutex_;
 
 };
 
+/// TCP server.
+using server = basic_server<asio::ip::tcp>;
+
 /// @}
 } } } // utl::io::tcp
 
@@ -0,0 +1,75 @@
+/*
+Licensed under the MIT License <http://opensource.org/licenses/MIT>
+
+Copyright 2018 Nathan Lucas <nathan.lucas@wayne.edu>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+//===========================================================================//
+/// @file
+/// @brief    UDP server and client.
+/// @details  Datagram transport with the same handler, write, run, and
+///           stop interface as utl::io::tcp, including multicast.
+/// @author   Nathan Lucas
+/// @date     2018
+//===========================================================================//
+#ifndef UTL_IO_UDP_HPP
+#define UTL_IO_UDP_HPP
+
+#ifndef __cplusplus
+#error must be compiled as C++
+#endif
+
+#include <utl/asio/datagram.hpp>  // utl::io::datagram::basic_server,
+                                  // utl::io::datagram::basic_client
+
+namespace utl { namespace io { namespace udp {
+
+/// @addtogroup utl_asio
+/// @{
+
+/// UDP endpoint:  an IP address and port.
+using endpoint = asio::ip::udp::endpoint;
+
+/// @brief  UDP server.
+///
+/// Example of multicast fan-out, receiving on every subscriber:
+/// @code
+/// utl::io::udp::server server(30001, handler);
+/// server.join(asio::ip::address::from_string("239.255.0.1"));
+/// @endcode
+/// and sending from a publisher:
+/// @code
+/// utl::io::udp::client client("239.255.0.1", "30001");
+/// client.write(telemetry);
+/// @endcode
+using server = datagram::basic_server<asio::ip::udp>;
+
+/// UDP client.
+using client = datagram::basic_client<asio::ip::udp>;
+
+using datagram::shared_buffer;
+using datagram::make_shared_buffer;
+
+/// @}
+
+} } } // utl::io::udp
+
+#endif // UTL_IO_UDP_HPP
+//===========================================================================//
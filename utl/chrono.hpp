@@ -107,8 +107,11 @@ SOFTWARE.
 
 #include "chrono/chrono_clock.hpp"
 #include "chrono/chrono_datetime.hpp"
+#include "chrono/chrono_latency.hpp"
+#include "chrono/chrono_pacer.hpp"
 #include "chrono/chrono_timer.hpp"
 #include "chrono/chrono_timestamp.hpp"
+#include "chrono/chrono_tsc_clock.hpp"
 
 
 #endif // UTL_CHRONO_HPP
@@ -38,6 +38,7 @@ SOFTWARE.
 
 #include <chrono>       // std::chrono
 #include <ctime>        // std::time_t, std::tm, std::localtime
+#include <time.h>       // localtime_r, localtime_s
 #include <string>       // std::string
 #include <sstream>      // std::ostringstream
 #include <iomanip>      // std::setfill std::setw
@@ -195,6 +196,17 @@ now_t()     { return std::chrono::system_clock::to_time_t(
                        std::chrono::system_clock::now()); }
 
 
+/// @brief  Converts a time value to local calendar time.
+/// @param  [in]  tt  Time value.
+/// @return Time structure.
+///
+/// Thread-safe alternative to `std::localtime`, using `localtime_s` on
+/// Windows and `localtime_r` elsewhere.
+inline
+std::tm
+local_tm(std::time_t const& tt);
+
+
 /// @brief  Returns current time in the frame of @em Clock.
 /// @tparam Clock   A clock class, such as `std::system_clock`,
 ///                 `std::steady_clock`, `std::high_resolution_clock`,
@@ -204,8 +216,7 @@ now_t()     { return std::chrono::system_clock::to_time_t(
 template<typename Clock>
 /*inline*/
 std::tm
-now_tm()    { std::time_t tt = Clock::to_time_t(Clock::now());
-              return *std::localtime(&tt); }
+now_tm()    { return utl::chrono::local_tm(Clock::to_time_t(Clock::now())); }
 
 
 /// @brief  By default returns current time in the
@@ -245,6 +256,26 @@ inline std::string
 segment(std::chrono::milliseconds const& msec);
 
 
+/// Precision of the fraction of a second in a time representation.
+enum class fraction : unsigned char
+{
+  none  = 0,    ///< Whole seconds:  `hh:mm:ss`.
+  ms    = 3,    ///< Milliseconds:   `hh:mm:ss.mmm`.
+  us    = 6,    ///< Microseconds:   `hh:mm:ss.uuuuuu`.
+  ns    = 9     ///< Nanoseconds:    `hh:mm:ss.nnnnnnnnn`.
+};
+
+
+/// @brief  Parses nanosecond value into a string representation
+///         of hours, minutes, seconds, and fraction of a second.
+/// @param  [in]  nsec        Nanosecond value.
+/// @param  [in]  precision   Fraction of a second.
+/// @return String format `HH:MM:SS`, `HH:MM:SS.mmm`, `HH:MM:SS.uuuuuu`,
+///         or `HH:MM:SS.nnnnnnnnn`.
+inline std::string
+segment(std::chrono::nanoseconds const& nsec, fraction precision);
+
+
 /// @brief  Parses millisecond value into hours,
 ///         minutes, seconds, and milliseconds.
 /// @param  [out] hr    Hours
@@ -323,6 +354,19 @@ clock_precision()
 //typedef std::chrono::nanoseconds nanoseconds, ns;
 
 
+inline std::tm
+local_tm(std::time_t const& tt)
+{
+  std::tm t = std::tm();
+#if defined(_WIN32)
+  localtime_s(&t, &tt);
+#else
+  localtime_r(&tt, &t);
+#endif
+  return t;
+}
+
+
 inline std::string
 segment(std::chrono::milliseconds const& msec)
 {
@@ -348,6 +392,36 @@ segment(std::chrono::milliseconds const& msec)
 }
 
 
+inline std::string
+segment(std::chrono::nanoseconds const& nsec, fraction precision)
+{
+  using std::chrono::hours;
+  using std::chrono::minutes;
+  using std::chrono::seconds;
+  using std::chrono::nanoseconds;
+
+  // split into hours, minutes, seconds, and nanoseconds
+  hours       hh(std::chrono::duration_cast<hours>(nsec));
+  minutes     mm(std::chrono::duration_cast<minutes>(nsec % hours(1)));
+  seconds     ss(std::chrono::duration_cast<seconds>(nsec % minutes(1)));
+  nanoseconds ns(nsec % seconds(1));
+
+  std::ostringstream oss;
+  oss << std::setfill('0')
+      << std::setw(2) << hh.count() << ":"
+      << std::setw(2) << mm.count() << ":"
+      << std::setw(2) << ss.count();
+  unsigned const digits = static_cast<unsigned>(precision);
+  if (digits != 0)
+  {
+    long long f = ns.count();
+    for (unsigned d = digits; d != 9; ++d) { f /= 10; }
+    oss << "." << std::setw(digits) << f;
+  }
+  return oss.str();
+}
+
+
 inline void
 segment(std::chrono::hours& hr, std::chrono::minutes& min,
         std::chrono::seconds& sec, std::chrono::milliseconds& ms,
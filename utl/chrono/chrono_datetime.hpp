@@ -32,11 +32,16 @@ SOFTWARE.
 #ifndef UTL_CHRONO_DATETIME_HPP
 #define UTL_CHRONO_DATETIME_HPP
 
-#ifndef __cplusplus
-#error must be compiled as C++
+#ifndef __cplusplus
+#error must be compiled as C++
 #endif
 
-#include <ctime>        // std::tm
+#include <utl/chrono/chrono_clock.hpp>  // utl::chrono::local_tm
+
+#include <atomic>       // std::atomic
+#include <chrono>       // std::chrono::system_clock
+#include <cstdint>      // std::int64_t, std::uint32_t
+#include <ctime>        // std::time_t, std::tm
 #include <string>       // std::string
 
 /// @ingroup  utl_chrono
@@ -161,6 +166,107 @@ inline bool
 is_dst(std::tm const& t)  { return (t.tm_isdst == 1); }
 
 
+/// @}
+//---------------------------------------------------------------------------
+/// @name Civil Calendar Functions
+/// Date and time conversion by integer arithmetic on
+/// `std::chrono::system_clock` time points, without `std::tm`.
+///
+/// The calendar algorithms are those of Howard Hinnant
+/// (http://howardhinnant.github.io/date_algorithms.html), for the
+/// proleptic Gregorian calendar.  They are valid for years within
+/// +/-10^16, about +/-3.65 * 10^18 days, beyond which the products of
+/// 400-year eras and their 146097 days overflow `std::int64_t`.  Time
+/// points count from the Unix epoch, as every `system_clock`
+/// implementation does.
+/// @{
+
+/// Calendar date.
+struct civil_date
+{
+  std::int64_t  year;     ///< Year.
+  unsigned      month;    ///< Month of the year: `1`-`12`.
+  unsigned      day;      ///< Day of the month: `1`-`31`.
+};
+
+
+/// Calendar date and time of day.
+struct civil_time
+{
+  std::int64_t  year;         ///< Year.
+  unsigned      month;        ///< Month of the year: `1`-`12`.
+  unsigned      day;          ///< Day of the month: `1`-`31`.
+  unsigned      hour;         ///< Hours since midnight: `0`-`23`.
+  unsigned      minute;       ///< Minutes: `0`-`59`.
+  unsigned      second;       ///< Seconds: `0`-`59`.
+  std::uint32_t nanosecond;   ///< Nanoseconds: `0`-`999999999`.
+  unsigned      weekday;      ///< Days since Sunday: `0`-`6`.
+};
+
+
+/// @brief  Days since 1970-01-01 of a calendar date.
+/// @param  [in]  y   Year, within +/-10^16.
+/// @param  [in]  m   Month of the year: `1`-`12`.
+/// @param  [in]  d   Day of the month: `1`-`31`.
+/// @return Days since 1970-01-01, negative for earlier dates.
+constexpr std::int64_t
+days_from_civil(std::int64_t y, unsigned m, unsigned d) noexcept;
+
+
+/// @brief  Calendar date of a number of days since 1970-01-01.
+/// @param  [in]  z   Days since 1970-01-01, within +/-3.65 * 10^18.
+/// @return Calendar date.
+constexpr civil_date
+civil_from_days(std::int64_t z) noexcept;
+
+
+/// @brief  Day of the week of a number of days since 1970-01-01.
+/// @param  [in]  z   Days since 1970-01-01.
+/// @return Days since Sunday: `0`-`6`.
+constexpr unsigned
+weekday_from_days(std::int64_t z) noexcept;
+
+
+/// @brief  Calendar date and time of a time point.
+/// @param  [in]  tp      Time point.
+/// @param  [in]  offset  Offset from UTC; e.g., utl::chrono::utc_offset.
+/// @return Calendar date and time at UTC plus @a offset.
+inline civil_time
+to_civil(std::chrono::system_clock::time_point const& tp,
+         std::chrono::seconds const& offset=std::chrono::seconds(0));
+
+
+/// @brief  Local calendar date and time of a time point.
+/// @param  [in]  tp  Time point.
+/// @return Calendar date and time in the local time zone.
+///
+/// Equivalent to `to_civil(tp, utc_offset(tp))`.
+inline civil_time
+local_civil(std::chrono::system_clock::time_point const& tp);
+
+
+/// @brief  Offset of local time from UTC.
+/// @param  [in]  tp  Time point.
+/// @return Offset of local time from UTC at @a tp; e.g., `-18000`
+///         seconds for US Eastern Standard Time.
+///
+/// The offset is computed with utl::chrono::local_tm once per quarter
+/// hour, the finest interval at which time zones change offset, and
+/// cached for all threads.  Calls for time points in the same quarter
+/// hour as the previous call are pure integer arithmetic.
+inline std::chrono::seconds
+utc_offset(std::chrono::system_clock::time_point const& tp=
+             std::chrono::system_clock::now());
+
+
+/// @brief  Time structure of a calendar date and time.
+/// @param  [in]  ct  Calendar date and time.
+/// @return Time structure for use with the `std::tm` functions above;
+///         `tm_isdst` is `-1` (unknown).
+inline std::tm
+to_tm(civil_time const& ct);
+
+
 /// @}
 //---------------------------------------------------------------------------
 
@@ -249,6 +355,191 @@ mon_str(std::tm const& t, bool cap)
 }
 
 
+namespace detail {  //-------------------------------------------------------
+
+// Floor division for negative numerators.
+constexpr std::int64_t
+floor_div(std::int64_t a, std::int64_t b) noexcept
+{
+  return (((a >= 0) ? a : (a - b + 1)) / b);
+}
+
+// days_from_civil steps, written as single-expression functions
+// for C++11 constexpr.
+
+constexpr std::int64_t
+civil_doy(unsigned m, unsigned d) noexcept   // day of year from March 1
+{
+  return ((((153 * ((m > 2) ? (m - 3) : (m + 9))) + 2) / 5) + d - 1);
+}
+
+constexpr std::int64_t
+civil_doe(std::int64_t yoe, std::int64_t doy) noexcept  // day of era
+{
+  return ((yoe * 365) + (yoe / 4) - (yoe / 100) + doy);
+}
+
+constexpr std::int64_t
+days_from_era(std::int64_t era, std::int64_t yoe, unsigned m, unsigned d) noexcept
+{
+  return ((era * 146097) + civil_doe(yoe, civil_doy(m, d)) - 719468);
+}
+
+constexpr std::int64_t
+days_from_year(std::int64_t y, unsigned m, unsigned d) noexcept  // March-based
+{
+  return days_from_era(floor_div(y, 400), y - (floor_div(y, 400) * 400), m, d);
+}
+
+// civil_from_days steps.
+
+constexpr civil_date
+civil_from_mp(std::int64_t y, std::int64_t doy, std::int64_t mp) noexcept
+{
+  return civil_date{ y + ((mp >= 10) ? 1 : 0),
+                     static_cast<unsigned>((mp < 10) ? (mp + 3) : (mp - 9)),
+                     static_cast<unsigned>(doy - (((153 * mp) + 2) / 5) + 1) };
+}
+
+constexpr civil_date
+civil_from_doy(std::int64_t y, std::int64_t doy) noexcept
+{
+  return civil_from_mp(y, doy, ((5 * doy) + 2) / 153);
+}
+
+constexpr civil_date
+civil_from_yoe(std::int64_t era, std::int64_t doe, std::int64_t yoe) noexcept
+{
+  return civil_from_doy(yoe + (era * 400), doe - civil_doe(yoe, 0));
+}
+
+constexpr civil_date
+civil_from_doe(std::int64_t era, std::int64_t doe) noexcept
+{
+  return civil_from_yoe(era, doe,
+      (doe - (doe / 1460) + (doe / 36524) - (doe / 146096)) / 365);
+}
+
+constexpr civil_date
+civil_from_era(std::int64_t era, std::int64_t z) noexcept
+{
+  return civil_from_doe(era, z - (era * 146097));
+}
+
+// Cached UTC offset:  quarter hour index in the high bits, and
+// offset seconds plus 2^19 in the low 20 bits.
+inline std::atomic<std::int64_t>&
+utc_offset_cache()
+{
+  static std::atomic<std::int64_t> cache{-1};
+  return cache;
+}
+
+} // detail -----------------------------------------------------------------
+
+
+constexpr std::int64_t
+days_from_civil(std::int64_t y, unsigned m, unsigned d) noexcept
+{
+  return detail::days_from_year(y - ((m <= 2) ? 1 : 0), m, d);
+}
+
+
+constexpr civil_date
+civil_from_days(std::int64_t z) noexcept
+{
+  return detail::civil_from_era(detail::floor_div(z + 719468, 146097),
+                                z + 719468);
+}
+
+
+constexpr unsigned
+weekday_from_days(std::int64_t z) noexcept
+{
+  return static_cast<unsigned>((z >= -4) ? ((z + 4) % 7) : (((z + 5) % 7) + 6));
+}
+
+
+inline civil_time
+to_civil(std::chrono::system_clock::time_point const& tp,
+         std::chrono::seconds const& offset)
+{
+  std::int64_t const ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            tp.time_since_epoch()).count();
+  std::int64_t const s    = detail::floor_div(ns, 1000000000) + offset.count();
+  std::int64_t const days = detail::floor_div(s, 86400);
+  std::int64_t const sod  = s - (days * 86400);   // seconds of day
+  civil_date const date = civil_from_days(days);
+
+  civil_time ct;
+  ct.year       = date.year;
+  ct.month      = date.month;
+  ct.day        = date.day;
+  ct.hour       = static_cast<unsigned>(sod / 3600);
+  ct.minute     = static_cast<unsigned>((sod % 3600) / 60);
+  ct.second     = static_cast<unsigned>(sod % 60);
+  ct.nanosecond = static_cast<std::uint32_t>(
+                    ns - (detail::floor_div(ns, 1000000000) * 1000000000));
+  ct.weekday    = weekday_from_days(days);
+  return ct;
+}
+
+
+inline civil_time
+local_civil(std::chrono::system_clock::time_point const& tp)
+{
+  return to_civil(tp, utc_offset(tp));
+}
+
+
+inline std::chrono::seconds
+utc_offset(std::chrono::system_clock::time_point const& tp)
+{
+  std::int64_t const s = detail::floor_div(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          tp.time_since_epoch()).count(), 1000000000);
+  std::int64_t const quarter = detail::floor_div(s, 900);
+
+  std::atomic<std::int64_t>& cache = detail::utc_offset_cache();
+  std::int64_t const c = cache.load(std::memory_order_relaxed);
+  if ((c >= 0) && ((c >> 20) == quarter))
+  {
+    return std::chrono::seconds((c & 0xFFFFF) - (1 << 19));
+  }
+
+  // Local time as if it were UTC, minus UTC.
+  std::tm const t = utl::chrono::local_tm(static_cast<std::time_t>(s));
+  std::int64_t const local =
+      (days_from_civil(t.tm_year + 1900, t.tm_mon + 1, t.tm_mday) * 86400) +
+      (t.tm_hour * 3600) + (t.tm_min * 60) + t.tm_sec;
+  std::int64_t const offset = local - s;
+  if (quarter >= 0)
+  {
+    cache.store((quarter << 20) | (offset + (1 << 19)),
+                std::memory_order_relaxed);
+  }
+  return std::chrono::seconds(offset);
+}
+
+
+inline std::tm
+to_tm(civil_time const& ct)
+{
+  std::tm t = std::tm();
+  t.tm_year  = static_cast<int>(ct.year - 1900);
+  t.tm_mon   = static_cast<int>(ct.month) - 1;
+  t.tm_mday  = static_cast<int>(ct.day);
+  t.tm_hour  = static_cast<int>(ct.hour);
+  t.tm_min   = static_cast<int>(ct.minute);
+  t.tm_sec   = static_cast<int>(ct.second);
+  t.tm_wday  = static_cast<int>(ct.weekday);
+  t.tm_yday  = static_cast<int>(days_from_civil(ct.year, ct.month, ct.day) -
+                                days_from_civil(ct.year, 1, 1));
+  t.tm_isdst = -1;
+  return t;
+}
+
+
 } } // utl::chrono
 
 #endif // UTL_CHRONO_DATETIME_HPP
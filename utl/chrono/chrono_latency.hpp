@@ -0,0 +1,228 @@
+/*
+Licensed under the MIT License <http://opensource.org/licenses/MIT>
+
+Copyright 2018 Nathan Lucas <nathan.lucas@wayne.edu>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+//===========================================================================//
+/// @file
+/// @brief    Latency histogram.
+/// @details  Header-only library providing a fixed-memory histogram
+///           of `std::chrono` durations.
+/// @author   Nathan Lucas
+/// @date     2018
+//===========================================================================//
+#ifndef UTL_CHRONO_LATENCY_HPP
+#define UTL_CHRONO_LATENCY_HPP
+
+#ifndef __cplusplus
+#error must be compiled as C++
+#endif
+
+#include <utl/chrono/chrono_clock.hpp>  // utl::chrono::fraction,
+                                        // utl::chrono::segment
+#include <utl/statistics.hpp>           // utl::quantile_histogram
+
+#include <chrono>       // std::chrono::duration, std::chrono::duration_cast
+#include <cstdint>      // std::uint64_t
+#include <ostream>      // std::ostream
+#include <string>       // std::string, std::to_string
+
+/// @ingroup  utl_chrono
+/// @defgroup utl_chrono_latency  chrono_latency
+/// @brief    Latency histogram.
+/// @details  Header-only library providing a fixed-memory histogram
+///   of `std::chrono` durations.
+
+namespace utl { namespace chrono {
+
+/// @addtogroup utl_chrono_latency
+/// @{
+
+//---------------------------------------------------------------------------
+/// @brief  Records the distribution of durations.
+/// @tparam Duration  Resolution of recorded durations.
+/// @tparam SubBits   Relative precision of `2^-SubBits` per bucket.
+///
+/// Durations are counted in log-linear buckets of a
+/// utl::quantile_histogram, as in HDR histograms:  recording takes
+/// constant time and never allocates, and percentiles are within
+/// `2^-(SubBits+1)` (1.6% by default) of the true value, from one tick
+/// of @a Duration up to centuries.  Negative durations are recorded as
+/// zero.
+///
+/// A histogram is not shared between threads.  Give each thread its own
+/// histogram and merge them for reporting.
+///
+/// Example usage:
+/// ```
+///   utl::chrono::latency_histogram<> h;
+///   for (;;)
+///   {
+///     utl::chrono::timer tmr;
+///     process();
+///     h.add(tmr.elapsed<utl::chrono::timer::ns>());
+///   }
+///   std::cout << h << '\n';
+///   utl::file::csv_writer(fw) << utl::chrono::csv(h) << "\n";
+/// ```
+template<typename Duration = std::chrono::nanoseconds, unsigned SubBits = 5>
+class latency_histogram
+{
+public:
+
+  typedef Duration duration;
+
+  /// @brief  Records duration @a d.
+  template<typename Rep, typename Period>
+  void
+  add(std::chrono::duration<Rep, Period> const& d)  { add(d, 1); }
+
+  /// @brief  Records duration @a d, @a n times.
+  template<typename Rep, typename Period>
+  void
+  add(std::chrono::duration<Rep, Period> const& d, std::uint64_t n)
+  {
+    auto const c = std::chrono::duration_cast<Duration>(d).count();
+    std::uint64_t const v = ((c > 0) ? static_cast<std::uint64_t>(c) : 0);
+    hist_.add(v, n);
+    total_ += (v * n);
+  }
+
+  /// @brief  Adds the durations recorded by @a other.
+  void
+  merge(latency_histogram const& other)
+  {
+    hist_.merge(other.hist_);
+    total_ += other.total_;
+  }
+
+  /// @brief  Discards all recorded durations.
+  void
+  clear()     { hist_.clear(); total_ = 0; }
+
+  /// @brief  Returns the number of recorded durations.
+  std::uint64_t
+  count() const     { return hist_.count(); }
+
+  /// @brief  Returns the sum of recorded durations.
+  Duration
+  total() const     { return Duration(total_); }
+
+  /// @brief  Returns the mean duration.
+  Duration
+  mean() const      { return Duration(count() ? (total_ / count()) : 0); }
+
+  /// @brief  Returns the minimum duration.
+  Duration
+  min() const       { return Duration(hist_.min()); }
+
+  /// @brief  Returns the maximum duration.
+  Duration
+  max() const       { return Duration(hist_.max()); }
+
+  /// @brief  Returns the duration not exceeded by fraction @a q
+  ///         of recorded durations.
+  /// @param  [in]  q   Quantile in `[0, 1]`; e.g., `0.99`.
+  Duration
+  quantile(double q) const  { return Duration(hist_.quantile(q)); }
+
+  /// @brief  Returns the underlying histogram of duration counts.
+  utl::quantile_histogram<std::uint64_t, SubBits> const&
+  histogram() const { return hist_; }
+
+private:
+  utl::quantile_histogram<std::uint64_t, SubBits> hist_;
+  std::uint64_t                                   total_ = 0;
+};
+
+//---------------------------------------------------------------------------
+/// @name Output Functions
+/// @{
+
+/// @brief  Writes count and percentiles in `HH:MM:SS.uuuuuu` format.
+///
+/// Output format:
+/// `Latency[N] p50 = .., p90 = .., p99 = .., p99.9 = .., max = ..`
+template<typename Duration, unsigned SubBits>
+inline std::ostream&
+operator<<(std::ostream& os, latency_histogram<Duration, SubBits> const& h);
+
+/// @brief  Returns count and percentiles as comma-separated values.
+///
+/// Returns `N,p50,p90,p99,p999,max`, with durations in microseconds.
+/// Column names are given by utl::chrono::csv_latency_header.
+template<typename Duration, unsigned SubBits>
+inline std::string
+csv(latency_histogram<Duration, SubBits> const& h);
+
+/// @brief  Returns the column names of utl::chrono::csv.
+inline std::string
+csv_latency_header()  { return "N,p50_us,p90_us,p99_us,p999_us,max_us"; }
+
+/// @}
+//---------------------------------------------------------------------------
+
+/// @}
+
+
+//===========================================================================//
+// Implementation
+
+
+template<typename Duration, unsigned SubBits>
+inline std::ostream&
+operator<<(std::ostream& os, latency_histogram<Duration, SubBits> const& h)
+{
+  auto seg = [](Duration d)
+  {
+    return utl::chrono::segment(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(d), fraction::us);
+  };
+  return os << "Latency[" << h.count() << "] p50 = " << seg(h.quantile(0.5))
+            << ", p90 = "   << seg(h.quantile(0.9))
+            << ", p99 = "   << seg(h.quantile(0.99))
+            << ", p99.9 = " << seg(h.quantile(0.999))
+            << ", max = "   << seg(h.max());
+}
+
+
+template<typename Duration, unsigned SubBits>
+inline std::string
+csv(latency_histogram<Duration, SubBits> const& h)
+{
+  auto us = [](Duration d)
+  {
+    return std::to_string(
+        std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(
+            d).count());
+  };
+  return (std::to_string(h.count()) + "," +
+          us(h.quantile(0.5)) + "," +
+          us(h.quantile(0.9)) + "," +
+          us(h.quantile(0.99)) + "," +
+          us(h.quantile(0.999)) + "," +
+          us(h.max()));
+}
+
+} } // utl::chrono
+
+#endif // UTL_CHRONO_LATENCY_HPP
+//===========================================================================//
@@ -0,0 +1,326 @@
+/*
+Licensed under the MIT License <http://opensource.org/licenses/MIT>
+
+Copyright 2018 Nathan Lucas <nathan.lucas@wayne.edu>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+//===========================================================================//
+/// @file
+/// @brief    Frame pacing and rate limiting.
+/// @details  Header-only library providing a fixed-frequency loop pacer
+///           and a token bucket rate limiter built on `<chrono>`.
+/// @author   Nathan Lucas
+/// @date     2018
+//===========================================================================//
+#ifndef UTL_CHRONO_PACER_HPP
+#define UTL_CHRONO_PACER_HPP
+
+#ifndef __cplusplus
+#error must be compiled as C++
+#endif
+
+#include <utl/chrono/chrono_latency.hpp>  // utl::chrono::latency_histogram
+
+#include <atomic>       // std::atomic
+#include <chrono>       // std::chrono
+#include <cmath>        // std::llround
+#include <cstdint>      // std::int64_t, std::uint64_t
+#include <stdexcept>    // std::invalid_argument
+#include <thread>       // std::this_thread
+
+/// @ingroup  utl_chrono
+/// @defgroup utl_chrono_pacer  chrono_pacer
+/// @brief    Frame pacing and rate limiting.
+/// @details  Header-only library providing a fixed-frequency loop pacer
+///   and a token bucket rate limiter built on `<chrono>`.
+
+namespace utl { namespace chrono {
+
+/// @addtogroup utl_chrono_pacer
+/// @{
+
+//---------------------------------------------------------------------------
+/// @brief  Paces a loop at a fixed frequency.
+///
+/// Each call to wait() returns at the next of a series of absolute
+/// deadlines one period apart, so time spent in the loop body does not
+/// accumulate as drift the way a fixed `sleep_for` does.  The thread
+/// sleeps until shortly before the deadline, then spins for the final
+/// approach, because sleeping threads often wake late by tens of
+/// microseconds on Linux and by milliseconds on Windows.
+///
+/// If the loop falls more than one period behind, the missed deadlines
+/// are skipped rather than run back to back.
+///
+/// Example usage:
+/// ```
+///   utl::chrono::pacer pace(std::chrono::microseconds(16667));  // 60 Hz
+///   while (running)
+///   {
+///     render();
+///     pace.wait();
+///   }
+///   std::cout << pace.jitter() << '\n';
+/// ```
+class pacer
+{
+public:
+
+  typedef std::chrono::steady_clock clock;
+  typedef std::chrono::nanoseconds  nanoseconds;
+
+  /// @brief  Constructor.
+  /// @param  [in]  period  Time between deadlines.
+  /// @param  [in]  spin    Time before each deadline to stop sleeping and
+  ///                       spin.  Larger values lower jitter at the cost
+  ///                       of processor time.
+  /// @throw  std::invalid_argument if @a period is not positive.
+  ///
+  /// The first deadline is one @a period after construction.
+  template<typename Rep, typename Period>
+  explicit
+  pacer(std::chrono::duration<Rep, Period> const& period,
+        nanoseconds const& spin=std::chrono::microseconds(200))
+  : period_(std::chrono::duration_cast<nanoseconds>(period))
+  , spin_(spin)
+  , deadline_(clock::now())
+  , missed_(0)
+  , jitter_()
+  {
+    if (period_.count() <= 0)
+    {
+      throw std::invalid_argument("utl::chrono::pacer: period must be positive");
+    }
+  }
+
+  /// @brief  Blocks until the next deadline.
+  void
+  wait();
+
+  /// @brief  Restarts the deadlines from the current time and
+  ///         discards jitter statistics.
+  void
+  reset();
+
+  /// Returns the time between deadlines.
+  nanoseconds
+  period() const    { return period_; }
+
+  /// Returns the next deadline.
+  clock::time_point
+  deadline() const  { return (deadline_ + period_); }
+
+  /// Returns the number of deadlines skipped because the loop fell
+  /// behind.
+  std::uint64_t
+  missed() const    { return missed_; }
+
+  /// Returns the distribution of wake-up times after each deadline.
+  latency_histogram<> const&
+  jitter() const    { return jitter_; }
+
+private:
+  nanoseconds         period_;
+  nanoseconds         spin_;
+  clock::time_point   deadline_;    // previous deadline
+  std::uint64_t       missed_;
+  latency_histogram<> jitter_;
+};
+
+//---------------------------------------------------------------------------
+/// @brief  Limits the rate of an activity, such as bytes written.
+///
+/// Token bucket:  tokens accumulate at a fixed rate up to a burst
+/// capacity, and each unit of activity consumes one token.  The bucket
+/// is kept as a single theoretical arrival time (the generic cell rate
+/// algorithm), so a rate_limiter may be shared between threads without
+/// locking.
+///
+/// Example usage:
+/// ```
+///   utl::chrono::rate_limiter limit(10e6, 64 * 1024);   // 10 MB/s
+///   limit.acquire(msg.size());
+///   write(msg);
+/// ```
+class rate_limiter
+{
+public:
+
+  typedef std::chrono::steady_clock clock;
+  typedef std::chrono::nanoseconds  nanoseconds;
+
+  /// @brief  Constructor.
+  /// @param  [in]  rate    Tokens added per second.
+  /// @param  [in]  burst   Capacity of the bucket, in tokens.  The
+  ///                       bucket starts full.
+  /// @throw  std::invalid_argument if @a rate is not positive or @a burst
+  ///         is negative.
+  rate_limiter(double rate, double burst);
+
+  /// @brief  Takes @a n tokens if available.
+  /// @return `true` if the tokens were taken, `false` otherwise.
+  bool
+  try_acquire(std::uint64_t n=1);
+
+  /// @brief  Takes @a n tokens, blocking until they are available.
+  ///
+  /// Concurrent callers are served in order of arrival.  Requests
+  /// larger than the burst capacity are allowed, and wait for the
+  /// whole amount to accumulate.
+  void
+  acquire(std::uint64_t n=1);
+
+  /// @brief  Returns the time until @a n tokens are available,
+  ///         or zero if they are available now.
+  nanoseconds
+  delay(std::uint64_t n=1) const;
+
+  /// Returns the rate in tokens per second.
+  double
+  rate() const      { return rate_; }
+
+private:
+
+  std::int64_t
+  cost(std::uint64_t n) const
+  {
+    return static_cast<std::int64_t>(std::llround(n * ns_per_token_));
+  }
+
+  static std::int64_t
+  now_ns()
+  {
+    return std::chrono::duration_cast<nanoseconds>(
+             clock::now().time_since_epoch()).count();
+  }
+
+  double                    rate_;
+  double                    ns_per_token_;
+  std::int64_t              tolerance_;   // burst capacity in nanoseconds
+  std::atomic<std::int64_t> tat_;         // theoretical arrival time
+};
+
+//---------------------------------------------------------------------------
+
+/// @}
+
+
+//===========================================================================//
+// Implementation
+
+
+inline void
+pacer::wait()
+{
+  deadline_ += period_;
+  clock::time_point now = clock::now();
+  if (now > (deadline_ + period_))
+  {
+    // Fell behind:  skip missed deadlines.
+    std::int64_t const behind = (now - deadline_) / period_;
+    missed_   += static_cast<std::uint64_t>(behind);
+    deadline_ += (behind * period_);
+  }
+  if ((deadline_ - now) > spin_)
+  {
+    std::this_thread::sleep_until(deadline_ - spin_);
+  }
+  while ((now = clock::now()) < deadline_) {}   // final approach
+  jitter_.add(now - deadline_);
+}
+
+
+inline void
+pacer::reset()
+{
+  deadline_ = clock::now();
+  missed_   = 0;
+  jitter_.clear();
+}
+
+//---------------------------------------------------------------------------
+
+inline
+rate_limiter::rate_limiter(double rate, double burst)
+: rate_(rate)
+, ns_per_token_((rate > 0) ? (1e9 / rate) : 0)
+, tolerance_(0)
+, tat_(now_ns())
+{
+  // Negated comparisons also reject NaN.
+  if (!(rate > 0))
+  {
+    throw std::invalid_argument("utl::chrono::rate_limiter: rate must be positive");
+  }
+  if (!(burst >= 0))
+  {
+    throw std::invalid_argument("utl::chrono::rate_limiter: burst is negative");
+  }
+  tolerance_ = static_cast<std::int64_t>(std::llround(burst * ns_per_token_));
+}
+
+
+inline bool
+rate_limiter::try_acquire(std::uint64_t n)
+{
+  std::int64_t const now = now_ns();
+  std::int64_t tat = tat_.load(std::memory_order_relaxed);
+  for (;;)
+  {
+    std::int64_t const next = ((tat > now) ? tat : now) + cost(n);
+    if ((next - now) > tolerance_) { return false; }
+    if (tat_.compare_exchange_weak(tat, next, std::memory_order_relaxed))
+    {
+      return true;
+    }
+  }
+}
+
+
+inline void
+rate_limiter::acquire(std::uint64_t n)
+{
+  std::int64_t const now = now_ns();
+  std::int64_t tat = tat_.load(std::memory_order_relaxed);
+  std::int64_t next;
+  do
+  {
+    next = ((tat > now) ? tat : now) + cost(n);
+  } while (!tat_.compare_exchange_weak(tat, next, std::memory_order_relaxed));
+
+  std::int64_t const wait = (next - tolerance_) - now;
+  if (wait > 0) { std::this_thread::sleep_for(nanoseconds(wait)); }
+}
+
+
+inline rate_limiter::nanoseconds
+rate_limiter::delay(std::uint64_t n) const
+{
+  std::int64_t const now = now_ns();
+  std::int64_t const tat = tat_.load(std::memory_order_relaxed);
+  std::int64_t const wait = ((tat > now) ? tat : now) + cost(n)
+                          - tolerance_ - now;
+  return nanoseconds((wait > 0) ? wait : 0);
+}
+
+} } // utl::chrono
+
+#endif // UTL_CHRONO_PACER_HPP
+//===========================================================================//
@@ -36,6 +36,8 @@ SOFTWARE.
 #error must be compiled as C++
 #endif
 
+#include <utl/chrono/chrono_tsc_clock.hpp>  // utl::chrono::tsc_clock
+
 #include <chrono>       // std::chrono
 
 /// @ingroup  utl_chrono
@@ -52,25 +54,30 @@ namespace utl { namespace chrono {
 
 //---------------------------------------------------------------------------
 /// @brief  Uses a steady monotonic clock to compute time intervals.
+/// @tparam Clock   A steady clock class, such as `std::steady_clock`
+///                 or utl::chrono::tsc_clock.
 /// @details
 /// Example: @n
 /// ```
-/// utl::timer tmr;
+/// utl::chrono::timer tmr;
 /// compute();
 /// std::cout << "compute time:\n  "
-///           << tmr.elapsed<utl::timer::s>().count()
+///           << tmr.elapsed<utl::chrono::timer::s>().count()
 ///           << " seconds, or\n  "
-///           << tmr.elapsed<utl::timer::ms>().count()
+///           << tmr.elapsed<utl::chrono::timer::ms>().count()
 ///           << " microseconds" << std::endl;
 /// ```
 /// GNU GCC (g++) compiler settings: @n
 ///   Compiler flags:  `-std=C++0x` @n
 ///   Other options:   `-std=gnu++11`
 ///
-class timer
+template<typename Clock = std::chrono::steady_clock>
+class basic_timer
 {
 public:
 
+  typedef Clock clock;
+
   typedef std::chrono::duration<double> seconds, s;
   typedef std::chrono::milliseconds milliseconds, ms;
   typedef std::chrono::microseconds microseconds, us;
@@ -80,8 +87,8 @@ public:
   ///
   /*inline*/
 //  explicit                            // direct initialization only
-  timer()
-  : t0_(std::chrono::steady_clock::now())
+  basic_timer()
+  : t0_(Clock::now())
   {} // do nothing
 
   /// @brief  Returns time elapsed since instantiation or last reset.
@@ -93,7 +100,7 @@ public:
   Duration
   elapsed() const
   {
-    auto t  = std::chrono::steady_clock::now();
+    auto t  = Clock::now();
     auto dt = std::chrono::duration_cast<Duration>(t - t0_);
     return dt;
   }
@@ -103,19 +110,25 @@ public:
   void
   reset()
   {
-    t0_ = std::chrono::steady_clock::now();
+    t0_ = Clock::now();
   }
 
 //private:  // member functions
-//  timer(timer const&);              ///< Disallow copying.
-//  timer& operator=(timer const&);   ///< Disallow assignment.
+//  basic_timer(basic_timer const&);              ///< Disallow copying.
+//  basic_timer& operator=(basic_timer const&);   ///< Disallow assignment.
 
 private:  // data members
 
-  std::chrono::steady_clock::time_point t0_;
+  typename Clock::time_point t0_;
 
 };
 
+/// Timer using `std::chrono::steady_clock`.
+typedef basic_timer<> timer;
+
+/// Timer using utl::chrono::tsc_clock.
+typedef basic_timer<tsc_clock> tsc_timer;
+
 
 //---------------------------------------------------------------------------
 /// @name Timer Functions
@@ -39,8 +39,13 @@ SOFTWARE.
 #error must be compiled as C++
 #endif
 
+#include <utl/chrono/chrono_clock.hpp>  // utl::chrono::fraction,
+                                        // utl::chrono::local_tm
+
 #include <chrono>       // std::chrono
-#include <ctime>        // std::tm
+#include <cstddef>      // std::size_t
+#include <cstring>      // std::memcpy
+#include <ctime>        // std::time_t, std::tm
 #include <string>       // std::string
 #include <sstream>      // std::ostringstream
 #include <iomanip>      // std::setfill, std::setw
@@ -116,6 +121,106 @@ std::string
 datetime_ISO_8601(bool extended=false);
 
 
+/// @}
+//---------------------------------------------------------------------------
+/// @name Timestamp Formatting
+///
+/// Allocation-free timestamps for high-rate logging.  A formatter caches
+/// the date, hour, and minute of the last time point it formatted, so
+/// each call within the same minute renders only the seconds and the
+/// fraction of a second.
+/// @{
+
+/// @brief  Formats `std::chrono::system_clock` time points
+///         as local date and time.
+///
+/// Writes timestamps such as `2018-05-14T23:25:33.123` into a caller
+/// buffer.  Local time is computed with utl::chrono::local_tm only when
+/// the minute changes.  A formatter is not shared between threads;
+/// use one formatter per thread, or utl::chrono::timestamp.
+///
+/// Example usage:
+/// ```
+///   utl::chrono::timestamp_formatter fmt(utl::chrono::fraction::us);
+///   char buf[32];
+///   std::size_t len = fmt.format(buf, sizeof(buf));
+/// ```
+class timestamp_formatter
+{
+public:
+
+  typedef std::chrono::system_clock clock;
+
+  /// @brief  Constructor.
+  /// @param  [in]  precision   Fraction of a second.
+  /// @param  [in]  delim       Delimiter between date and time.
+  /// @param  [in]  date_delim  Delimiter between year, month, and day.
+  /// @param  [in]  time_delim  Delimiter between hour, minute, and second.
+  ///
+  /// The default parameter values give ISO 8601 extended format.
+  explicit
+  timestamp_formatter(fraction precision=fraction::none,
+                      std::string const& delim="T",
+                      std::string const& date_delim="-",
+                      std::string const& time_delim=":");
+
+  /// Returns the length of each timestamp, not including the
+  /// terminating null character.
+  std::size_t
+  size() const;
+
+  /// @brief  Writes a null-terminated timestamp of @a tp to @a buf.
+  /// @param  [out] buf   Output buffer.
+  /// @param  [in]  len   Size of @a buf, at least `size() + 1`.
+  /// @param  [in]  tp    Time point.
+  /// @return Number of characters written, not including the
+  ///         terminating null character, or `0` if @a buf is too small.
+  std::size_t
+  format(char* buf, std::size_t len, clock::time_point const& tp);
+
+  /// @brief  Writes a null-terminated timestamp of the current time.
+  /// @param  [out] buf   Output buffer.
+  /// @param  [in]  len   Size of @a buf, at least `size() + 1`.
+  /// @return Number of characters written, not including the
+  ///         terminating null character, or `0` if @a buf is too small.
+  std::size_t
+  format(char* buf, std::size_t len)  { return format(buf, len, clock::now()); }
+
+  /// Returns the timestamp of @a tp.
+  std::string
+  operator()(clock::time_point const& tp);
+
+  /// Returns the timestamp of the current time.
+  std::string
+  operator()()                        { return (*this)(clock::now()); }
+
+private:
+
+  void
+  update(std::time_t tt);
+
+  std::string date_delim_;
+  std::string delim_;
+  std::string time_delim_;
+  unsigned    digits_;        // digits in fraction of a second
+  std::time_t minute_;        // first second of cached minute
+  std::string prefix_;        // date, hour, and minute of cached minute
+};
+
+
+/// @brief  Writes a null-terminated ISO 8601 extended format
+///         timestamp of the current local time.
+/// @param  [out] buf         Output buffer.
+/// @param  [in]  len         Size of @a buf.
+/// @param  [in]  precision   Fraction of a second.
+/// @return Number of characters written, not including the
+///         terminating null character, or `0` if @a buf is too small.
+///
+/// Thread-safe; uses a timestamp_formatter cached per thread.
+inline std::size_t
+timestamp(char* buf, std::size_t len, fraction precision=fraction::none);
+
+
 /// @}
 //---------------------------------------------------------------------------
 
@@ -125,9 +230,129 @@ datetime_ISO_8601(bool extended=false);
 //===========================================================================//
 // Implementation
 
-// TODO -- fractions of second:  YYYY-MM-DDThh:mm:ss.msec
 // TODO -- eliminate dependence on std::ostringstream
 
+namespace detail {  //-------------------------------------------------------
+
+// Writes n decimal digits of v, with leading zeros.
+inline void
+put_digits(char* p, unsigned long v, unsigned n)
+{
+  for (char* q = p + n; q != p; v /= 10) { *--q = static_cast<char>('0' + (v % 10)); }
+}
+
+} // detail -----------------------------------------------------------------
+
+
+inline
+timestamp_formatter::timestamp_formatter(fraction precision,
+                                         std::string const& delim,
+                                         std::string const& date_delim,
+                                         std::string const& time_delim)
+: date_delim_(date_delim)
+, delim_(delim)
+, time_delim_(time_delim)
+, digits_(static_cast<unsigned>(precision))
+, minute_(0)
+, prefix_()
+{
+  update(0);
+}
+
+
+inline std::size_t
+timestamp_formatter::size() const
+{
+  return (prefix_.size() + 2 + (digits_ ? (digits_ + 1) : 0));
+}
+
+
+inline std::size_t
+timestamp_formatter::format(char* buf, std::size_t len,
+                            clock::time_point const& tp)
+{
+  // Split into whole seconds and nanoseconds, rounding toward
+  // negative infinity so the fraction is never negative.
+  typedef std::chrono::nanoseconds ns;
+  long long const count = std::chrono::duration_cast<ns>(
+                            tp.time_since_epoch()).count();
+  long long sec  = count / 1000000000;
+  long long frac = count % 1000000000;
+  if (frac < 0) { --sec; frac += 1000000000; }
+
+  std::time_t const tt = static_cast<std::time_t>(sec);
+  if ((tt < minute_) || (tt >= (minute_ + 60))) { update(tt); }
+
+  std::size_t const n = size();
+  if (len <= n) { return 0; }
+
+  char* p = buf;
+  std::memcpy(p, prefix_.data(), prefix_.size());
+  p += prefix_.size();
+  detail::put_digits(p, static_cast<unsigned long>(tt - minute_), 2);
+  p += 2;
+  if (digits_ != 0)
+  {
+    unsigned long f = static_cast<unsigned long>(frac);
+    for (unsigned d = digits_; d != 9; ++d) { f /= 10; }
+    *p++ = '.';
+    detail::put_digits(p, f, digits_);
+    p += digits_;
+  }
+  *p = '\0';
+  return n;
+}
+
+
+inline std::string
+timestamp_formatter::operator()(clock::time_point const& tp)
+{
+  std::string s(size() + 1, '\0');
+  s.resize(format(&s[0], s.size(), tp));
+  return s;
+}
+
+
+inline void
+timestamp_formatter::update(std::time_t tt)
+{
+  std::tm const t = utl::chrono::local_tm(tt);
+  int const sec = ((t.tm_sec < 60) ? t.tm_sec : 59);  // leap second
+  minute_ = tt - sec;
+
+  char digits[4];
+  prefix_.clear();
+  detail::put_digits(digits, static_cast<unsigned long>(t.tm_year + 1900), 4);
+  prefix_.append(digits, 4);
+  prefix_ += date_delim_;
+  detail::put_digits(digits, static_cast<unsigned long>(t.tm_mon + 1), 2);
+  prefix_.append(digits, 2);
+  prefix_ += date_delim_;
+  detail::put_digits(digits, static_cast<unsigned long>(t.tm_mday), 2);
+  prefix_.append(digits, 2);
+  prefix_ += delim_;
+  detail::put_digits(digits, static_cast<unsigned long>(t.tm_hour), 2);
+  prefix_.append(digits, 2);
+  prefix_ += time_delim_;
+  detail::put_digits(digits, static_cast<unsigned long>(t.tm_min), 2);
+  prefix_.append(digits, 2);
+  prefix_ += time_delim_;
+}
+
+
+inline std::size_t
+timestamp(char* buf, std::size_t len, fraction precision)
+{
+  thread_local timestamp_formatter fmt[4] =
+  {
+    timestamp_formatter(fraction::none),
+    timestamp_formatter(fraction::ms),
+    timestamp_formatter(fraction::us),
+    timestamp_formatter(fraction::ns)
+  };
+  return fmt[static_cast<unsigned>(precision) / 3].format(buf, len);
+}
+
 
 inline std::string
 date(std::string const& delim)
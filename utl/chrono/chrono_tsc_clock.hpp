@@ -0,0 +1,272 @@
+/*
+Licensed under the MIT License <http://opensource.org/licenses/MIT>
+
+Copyright 2018 Nathan Lucas <nathan.lucas@wayne.edu>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+//===========================================================================//
+/// @file
+/// @brief    Time stamp counter clock.
+/// @details  Header-only library providing a low-overhead steady clock
+///           that reads the processor time stamp counter.
+/// @author   Nathan Lucas
+/// @date     2018
+//===========================================================================//
+#ifndef UTL_CHRONO_TSC_CLOCK_HPP
+#define UTL_CHRONO_TSC_CLOCK_HPP
+
+#ifndef __cplusplus
+#error must be compiled as C++
+#endif
+
+#include <chrono>       // std::chrono
+#include <cstdint>      // std::int64_t, std::uint64_t
+
+#if defined(__x86_64__) || defined(__i386__)
+#define UTL_CHRONO_TSC 1
+#include <cpuid.h>      // __get_cpuid
+#include <x86intrin.h>  // __rdtsc
+#elif defined(_M_X64) || defined(_M_IX86)
+#define UTL_CHRONO_TSC 1
+#include <intrin.h>     // __cpuid, __rdtsc
+#endif
+
+/// @ingroup  utl_chrono
+/// @defgroup utl_chrono_tsc_clock  chrono_tsc_clock
+/// @brief    Time stamp counter clock.
+/// @details  Header-only library providing a low-overhead steady clock
+///   that reads the processor time stamp counter.
+///
+/// Reading `std::chrono::steady_clock` costs a system call or a vDSO
+/// call (about 20 ns); reading the time stamp counter costs a single
+/// `rdtsc` instruction, which makes timing individual iterations of a
+/// tight loop practical.
+
+namespace utl { namespace chrono {
+
+/// @addtogroup utl_chrono_tsc_clock
+/// @{
+
+//---------------------------------------------------------------------------
+/// @brief  Steady clock based on the processor time stamp counter.
+///
+/// Meets the C++ standard library _Clock_ requirements, so it can be used
+/// with utl::chrono::basic_timer and utl::chrono::now.  On first use the
+/// counter is calibrated against `std::chrono::steady_clock` over a short
+/// interval (utl::chrono::tsc_clock::calibration_ns), and time points share
+/// the epoch of `std::chrono::steady_clock`.
+///
+/// The counter is used only on x86 processors that report an invariant
+/// time stamp counter, which runs at a constant rate on all cores
+/// regardless of power state.  Otherwise the clock falls back to
+/// `std::chrono::steady_clock` (`clock_gettime` on POSIX systems).
+///
+/// `rdtsc` is not serializing:  the processor may execute it before
+/// preceding instructions complete.  Intervals shorter than a few tens
+/// of nanoseconds are therefore approximate.
+///
+/// Example usage:
+/// ```
+///   utl::chrono::tsc_clock::ticks_per_second();   // calibrate at startup
+///   utl::chrono::tsc_timer tmr;
+///   work();
+///   auto dt = tmr.elapsed<utl::chrono::tsc_timer::ns>();
+/// ```
+class tsc_clock
+{
+public:
+
+  typedef std::chrono::nanoseconds                  duration;
+  typedef duration::rep                             rep;
+  typedef duration::period                          period;
+  typedef std::chrono::time_point<tsc_clock>        time_point;
+
+  static constexpr bool is_steady = true;
+
+  /// Calibration interval in nanoseconds.
+  static constexpr std::int64_t calibration_ns = 10000000;
+
+  /// Returns the current time.
+  static time_point
+  now() noexcept;
+
+  /// @brief  Returns the raw counter value.
+  ///
+  /// Time stamp counter ticks, or `std::chrono::steady_clock`
+  /// nanoseconds if the counter is not used.
+  static std::uint64_t
+  ticks() noexcept;
+
+  /// @brief  Returns the measured counter frequency.
+  ///
+  /// Calibrates the clock on first call; call once at startup to keep
+  /// calibration out of the first measurement.
+  static double
+  ticks_per_second();
+
+  /// Returns `true` if the clock reads the time stamp counter,
+  /// or `false` if it falls back to `std::chrono::steady_clock`.
+  static bool
+  is_tsc();
+
+private:
+
+  struct calibration_data
+  {
+    bool          tsc;            // counter in use
+    double        ns_per_tick;    // counter period
+    std::uint64_t tick0;          // counter at calibration
+    std::int64_t  ns0;            // steady_clock time at calibration
+
+    calibration_data();
+  };
+
+  static calibration_data const&
+  data();
+
+  static bool
+  invariant_tsc();
+
+  static std::uint64_t
+  steady_ns() noexcept;
+};
+
+//---------------------------------------------------------------------------
+
+/// @}
+
+
+//===========================================================================//
+// Implementation
+
+
+inline tsc_clock::time_point
+tsc_clock::now() noexcept
+{
+  calibration_data const& d = data();
+#if defined(UTL_CHRONO_TSC)
+  if (d.tsc)
+  {
+    std::int64_t const dt = static_cast<std::int64_t>(__rdtsc() - d.tick0);
+    return time_point(duration(d.ns0 + static_cast<std::int64_t>(
+                                 static_cast<double>(dt) * d.ns_per_tick)));
+  }
+#endif
+  return time_point(duration(static_cast<rep>(steady_ns())));
+}
+
+
+inline std::uint64_t
+tsc_clock::ticks() noexcept
+{
+#if defined(UTL_CHRONO_TSC)
+  if (data().tsc) { return __rdtsc(); }
+#endif
+  return steady_ns();
+}
+
+
+inline double
+tsc_clock::ticks_per_second()
+{
+  return (1e9 / data().ns_per_tick);
+}
+
+
+inline bool
+tsc_clock::is_tsc()
+{
+  return data().tsc;
+}
+
+
+inline tsc_clock::calibration_data const&
+tsc_clock::data()
+{
+  static calibration_data const d;
+  return d;
+}
+
+
+inline
+tsc_clock::calibration_data::calibration_data()
+: tsc(invariant_tsc())
+, ns_per_tick(1)
+, tick0(0)
+, ns0(0)
+{
+#if defined(UTL_CHRONO_TSC)
+  if (tsc)
+  {
+    // Count ticks over the calibration interval.
+    std::uint64_t const t0 = steady_ns();
+    std::uint64_t const c0 = __rdtsc();
+    std::uint64_t const end = t0 + static_cast<std::uint64_t>(calibration_ns);
+    std::uint64_t t1 = t0;
+    while (t1 < end) { t1 = steady_ns(); }
+    std::uint64_t const c1 = __rdtsc();
+    if (c1 > c0)
+    {
+      ns_per_tick = static_cast<double>(t1 - t0) / static_cast<double>(c1 - c0);
+      tick0 = c1;
+      ns0   = static_cast<std::int64_t>(t1);
+      return;
+    }
+    tsc = false;  // counter not advancing
+  }
+#endif
+}
+
+
+inline bool
+tsc_clock::invariant_tsc()
+{
+#if defined(UTL_CHRONO_TSC) && (defined(__x86_64__) || defined(__i386__))
+  unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+  if (!__get_cpuid(0x80000000u, &eax, &ebx, &ecx, &edx) || (eax < 0x80000007u))
+  {
+    return false;
+  }
+  __get_cpuid(0x80000007u, &eax, &ebx, &ecx, &edx);
+  return ((edx & (1u << 8)) != 0);
+#elif defined(UTL_CHRONO_TSC)
+  int r[4];
+  __cpuid(r, 0x80000000);
+  if (static_cast<unsigned>(r[0]) < 0x80000007u) { return false; }
+  __cpuid(r, 0x80000007);
+  return ((r[3] & (1 << 8)) != 0);
+#else
+  return false;
+#endif
+}
+
+
+inline std::uint64_t
+tsc_clock::steady_ns() noexcept
+{
+  return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<duration>(
+          std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} } // utl::chrono
+
+#endif // UTL_CHRONO_TSC_CLOCK_HPP
+//===========================================================================//
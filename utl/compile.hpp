@@ -93,6 +93,77 @@ namespace utl { namespace compile {
 */
 #define SOURCE_LINE __FILE__ ":" SOURCE_LINE_1(__LINE__)
 
+/// @}
+//---------------------------------------------------------------------------
+/// @name Preprocessor iteration
+/// @{
+
+/// @brief  Concatenates two tokens after expanding them.
+#define UTL_PP_CAT(a, b) UTL_PP_CAT_1(a, b)
+
+/// @brief  Inner macro enabling UTL_PP_CAT.
+#define UTL_PP_CAT_1(a, b) a ## b
+
+/// @brief  Number of arguments, from 1 to 32.
+#define UTL_PP_COUNT(...) \
+  UTL_PP_COUNT_N(__VA_ARGS__, \
+                 32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17,\
+                 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+
+/// @brief  Inner macro enabling UTL_PP_COUNT.
+#define UTL_PP_COUNT_N( \
+    _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11,\
+    _12, _13, _14, _15, _16, _17, _18, _19, _20, _21, _22,\
+    _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, N, ...) N
+
+/**
+  @brief  Expands `m(data, x)` for each argument `x`, of which there may
+          be from 1 to 32.
+
+  Usage:
+  ```
+  #define PRINT_FIELD(obj, f) std::cout << #f " = " << obj.f << '\n';
+  UTL_FOR_EACH(PRINT_FIELD, point, x, y, z)
+  ```
+*/
+#define UTL_FOR_EACH(m, data, ...) \
+  UTL_PP_CAT(UTL_FOR_EACH_, UTL_PP_COUNT(__VA_ARGS__))(m, data, __VA_ARGS__)
+
+/// @cond
+#define UTL_FOR_EACH_1(m, d, x) m(d, x)
+#define UTL_FOR_EACH_2(m, d, x, ...) m(d, x) UTL_FOR_EACH_1(m, d, __VA_ARGS__)
+#define UTL_FOR_EACH_3(m, d, x, ...) m(d, x) UTL_FOR_EACH_2(m, d, __VA_ARGS__)
+#define UTL_FOR_EACH_4(m, d, x, ...) m(d, x) UTL_FOR_EACH_3(m, d, __VA_ARGS__)
+#define UTL_FOR_EACH_5(m, d, x, ...) m(d, x) UTL_FOR_EACH_4(m, d, __VA_ARGS__)
+#define UTL_FOR_EACH_6(m, d, x, ...) m(d, x) UTL_FOR_EACH_5(m, d, __VA_ARGS__)
+#define UTL_FOR_EACH_7(m, d, x, ...) m(d, x) UTL_FOR_EACH_6(m, d, __VA_ARGS__)
+#define UTL_FOR_EACH_8(m, d, x, ...) m(d, x) UTL_FOR_EACH_7(m, d, __VA_ARGS__)
+#define UTL_FOR_EACH_9(m, d, x, ...) m(d, x) UTL_FOR_EACH_8(m, d, __VA_ARGS__)
+#define UTL_FOR_EACH_10(m, d, x, ...) m(d, x) UTL_FOR_EACH_9(m, d, __VA_ARGS__)
+#define UTL_FOR_EACH_11(m, d, x, ...) m(d, x) UTL_FOR_EACH_10(m, d, __VA_ARGS__)
+#define UTL_FOR_EACH_12(m, d, x, ...) m(d, x) UTL_FOR_EACH_11(m, d, __VA_ARGS__)
+#define UTL_FOR_EACH_13(m, d, x, ...) m(d, x) UTL_FOR_EACH_12(m, d, __VA_ARGS__)
+#define UTL_FOR_EACH_14(m, d, x, ...) m(d, x) UTL_FOR_EACH_13(m, d, __VA_ARGS__)
+#define UTL_FOR_EACH_15(m, d, x, ...) m(d, x) UTL_FOR_EACH_14(m, d, __VA_ARGS__)
+#define UTL_FOR_EACH_16(m, d, x, ...) m(d, x) UTL_FOR_EACH_15(m, d, __VA_ARGS__)
+#define UTL_FOR_EACH_17(m, d, x, ...) m(d, x) UTL_FOR_EACH_16(m, d, __VA_ARGS__)
+#define UTL_FOR_EACH_18(m, d, x, ...) m(d, x) UTL_FOR_EACH_17(m, d, __VA_ARGS__)
+#define UTL_FOR_EACH_19(m, d, x, ...) m(d, x) UTL_FOR_EACH_18(m, d, __VA_ARGS__)
+#define UTL_FOR_EACH_20(m, d, x, ...) m(d, x) UTL_FOR_EACH_19(m, d, __VA_ARGS__)
+#define UTL_FOR_EACH_21(m, d, x, ...) m(d, x) UTL_FOR_EACH_20(m, d, __VA_ARGS__)
+#define UTL_FOR_EACH_22(m, d, x, ...) m(d, x) UTL_FOR_EACH_21(m, d, __VA_ARGS__)
+#define UTL_FOR_EACH_23(m, d, x, ...) m(d, x) UTL_FOR_EACH_22(m, d, __VA_ARGS__)
+#define UTL_FOR_EACH_24(m, d, x, ...) m(d, x) UTL_FOR_EACH_23(m, d, __VA_ARGS__)
+#define UTL_FOR_EACH_25(m, d, x, ...) m(d, x) UTL_FOR_EACH_24(m, d, __VA_ARGS__)
+#define UTL_FOR_EACH_26(m, d, x, ...) m(d, x) UTL_FOR_EACH_25(m, d, __VA_ARGS__)
+#define UTL_FOR_EACH_27(m, d, x, ...) m(d, x) UTL_FOR_EACH_26(m, d, __VA_ARGS__)
+#define UTL_FOR_EACH_28(m, d, x, ...) m(d, x) UTL_FOR_EACH_27(m, d, __VA_ARGS__)
+#define UTL_FOR_EACH_29(m, d, x, ...) m(d, x) UTL_FOR_EACH_28(m, d, __VA_ARGS__)
+#define UTL_FOR_EACH_30(m, d, x, ...) m(d, x) UTL_FOR_EACH_29(m, d, __VA_ARGS__)
+#define UTL_FOR_EACH_31(m, d, x, ...) m(d, x) UTL_FOR_EACH_30(m, d, __VA_ARGS__)
+#define UTL_FOR_EACH_32(m, d, x, ...) m(d, x) UTL_FOR_EACH_31(m, d, __VA_ARGS__)
+/// @endcond
+
 /// @}
 //---------------------------------------------------------------------------
 
@@ -0,0 +1,60 @@
+/*
+Licensed under the MIT License <http://opensource.org/licenses/MIT>
+
+Copyright 2018 Nathan Lucas <nathan.lucas@wayne.edu>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+//===========================================================================//
+/// @file
+/// @brief    Interprocess communication library.
+/// @details  Header-only library providing same-host transports that
+///           bypass the kernel for each message.
+/// @author   Nathan Lucas
+/// @date     2018
+//===========================================================================//
+#ifndef UTL_IPC_HPP
+#define UTL_IPC_HPP
+
+#ifndef __cplusplus
+#error must be compiled as C++
+#endif
+
+/// @defgroup utl_ipc  ipc
+/// @brief    Interprocess communication library.
+/// @details  Header-only library providing same-host transports that
+///           bypass the kernel for each message.
+
+//---------------------------------------------------------------------------
+/// @namespace  utl::ipc
+/// @brief  Interprocess communication library.
+///
+/// Header-only library providing same-host transports that bypass the
+/// kernel for each message.  For transports between hosts, or where
+/// the kernel is fast enough, see utl::io.
+//---------------------------------------------------------------------------
+
+
+// Modules
+
+#include "ipc/ipc_shm_ring.hpp"
+
+
+#endif // UTL_IPC_HPP
+//===========================================================================//
@@ -0,0 +1,775 @@
+/*
+Licensed under the MIT License <http://opensource.org/licenses/MIT>
+
+Copyright 2018 Nathan Lucas <nathan.lucas@wayne.edu>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+//===========================================================================//
+/// @file
+/// @brief    Shared-memory ring buffer.
+/// @details  Header-only library providing a single-producer,
+///           multi-consumer ring of variable-length records in POSIX
+///           shared memory, with futex wakeups.
+/// @author   Nathan Lucas
+/// @date     2018
+//===========================================================================//
+#ifndef UTL_IPC_SHM_RING_HPP
+#define UTL_IPC_SHM_RING_HPP
+
+#ifndef __cplusplus
+#error must be compiled as C++
+#endif
+
+#if !defined(__linux__)
+#error utl::ipc::shm_ring requires Linux futexes
+#endif
+
+#include <atomic>       // std::atomic, ATOMIC_INT_LOCK_FREE
+#include <chrono>       // std::chrono::nanoseconds
+#include <climits>      // INT_MAX
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint32_t, std::uint64_t
+#include <cstring>      // std::memcpy
+#include <functional>   // std::function
+#include <new>          // placement new
+#include <stdexcept>    // std::length_error, std::runtime_error
+#include <string>       // std::string
+#include <system_error> // std::system_error
+
+#include <cerrno>           // errno, EEXIST, ENOENT, ESRCH
+#include <fcntl.h>          // O_CREAT, O_EXCL, O_RDONLY, O_RDWR
+#include <linux/futex.h>    // FUTEX_WAIT, FUTEX_WAKE
+#include <signal.h>         // kill
+#include <sys/mman.h>       // mmap, munmap, shm_open, shm_unlink
+#include <sys/stat.h>       // fstat
+#include <sys/syscall.h>    // SYS_futex
+#include <unistd.h>         // close, ftruncate, getpid, syscall
+
+/// @ingroup  utl_ipc
+/// @defgroup utl_ipc_shm_ring  ipc_shm_ring
+/// @brief    Shared-memory ring buffer.
+/// @details  Header-only library providing a single-producer,
+///   multi-consumer ring of variable-length records in POSIX
+///   shared memory, with futex wakeups.
+///
+/// Publishing a record copies it once into shared memory, or not at
+/// all when it is written in place with reserve() and commit().  Each
+/// reader receives every record, in order, in place in shared memory.
+/// The writer never overwrites a record that a reader has not yet
+/// received; it waits for the slowest reader instead.  Neither side
+/// makes a system call unless the other is asleep.
+///
+/// Example:
+/// ```
+/// // Producer process
+/// utl::ipc::shm_ring ring("/gaze", 1 << 20);
+/// ring.write(sample, sizeof(sample));
+///
+/// // Consumer process
+/// utl::ipc::shm_ring_reader reader("/gaze",
+///     [](char const* data, std::size_t size) { /* ... */ });
+/// reader.run();
+/// ```
+/// Link with `-lrt` on glibc older than 2.17.
+
+namespace utl { namespace ipc {
+
+//---------------------------------------------------------------------------
+// Implementation
+
+namespace detail {  //-------------------------------------------------------
+
+static_assert((ATOMIC_INT_LOCK_FREE == 2) && (ATOMIC_LLONG_LOCK_FREE == 2),
+              "shared memory requires address-free atomics");
+
+constexpr std::uint64_t shm_ring_magic = 0x75746c72696e6702ull;
+constexpr std::uint32_t shm_ring_pad = 0xffffffffu;  // skip to ring start
+
+enum : std::uint32_t { slot_free = 0, slot_active = 1 };
+
+// Position of one reader.  A slot is owned by the process whose ID is
+// swapped into pid, and only its owner changes its state and cursor,
+// so a process that dies at any point can be detected and replaced.
+struct alignas(64) shm_ring_slot
+{
+  std::atomic<std::uint32_t>  state;
+  std::atomic<std::int32_t>   pid;      // owner, or 0 if unowned
+  std::atomic<std::uint64_t>  cursor;   // next byte to read
+};
+
+// Start of the shared region, followed by the reader slots and data.
+struct shm_ring_header
+{
+  std::atomic<std::uint64_t>  magic;
+  std::uint64_t               capacity;     // power of two
+  std::uint32_t               max_readers;
+  std::atomic<std::uint32_t>  closed;       // writer has gone
+  std::atomic<std::int32_t>   writer_pid;   // to check for liveness
+
+  alignas(64)
+  std::atomic<std::uint64_t>  write_pos;    // end of published records
+
+  alignas(64)
+  std::atomic<std::uint32_t>  data_seq;     // futex:  records published
+  std::atomic<std::uint32_t>  data_waiters;
+
+  alignas(64)
+  std::atomic<std::uint32_t>  space_seq;    // futex:  records consumed
+  std::atomic<std::uint32_t>  space_waiters;
+};
+
+// Returns size rounded up to a multiple of 8.
+inline std::uint64_t
+align8(std::uint64_t size)
+{
+  return ((size + 7) & ~std::uint64_t(7));
+}
+
+// Shared memory object names begin with one slash.
+inline std::string
+shm_name(std::string const& name)
+{
+  return ((!name.empty() && (name[0] == '/')) ? name : ('/' + name));
+}
+
+inline std::size_t
+shm_size(std::uint64_t capacity, std::uint32_t max_readers)
+{
+  return (sizeof(shm_ring_header) + (max_readers * sizeof(shm_ring_slot))
+          + capacity);
+}
+
+// Returns false if process pid has exited.
+inline bool
+process_alive(std::int32_t pid)
+{
+  return !((::kill(pid, 0) == -1) && (errno == ESRCH));
+}
+
+// Returns true if the object at name is a ring, or one still being
+// created, whose writer has exited.  Anything else, including a ring
+// whose writer is not yet known, is left alone.
+inline bool
+writer_exited(std::string const& name)
+{
+  int const fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd == -1)
+  {
+    return (errno == ENOENT);   // removed since
+  }
+  void* addr = MAP_FAILED;
+  struct stat st;
+  if ((::fstat(fd, &st) == 0) &&
+      (static_cast<std::size_t>(st.st_size) >= sizeof(shm_ring_header)))
+  {
+    addr = ::mmap(nullptr, sizeof(shm_ring_header), PROT_READ, MAP_SHARED,
+                  fd, 0);
+  }
+  ::close(fd);
+  if (addr == MAP_FAILED)
+  {
+    return false;
+  }
+  auto const header = static_cast<shm_ring_header const*>(addr);
+  std::uint64_t const magic = header->magic.load();
+  std::int32_t const pid = header->writer_pid.load();
+  ::munmap(addr, sizeof(shm_ring_header));
+  return (((magic == shm_ring_magic) || (magic == 0)) &&
+          (pid != 0) && !process_alive(pid));
+}
+
+// Sleeps while word equals expected, for at most timeout.
+inline void
+futex_wait(std::atomic<std::uint32_t>& word, std::uint32_t expected,
+           std::chrono::nanoseconds timeout)
+{
+  timespec ts;
+  ts.tv_sec = static_cast<time_t>(timeout.count() / 1000000000);
+  ts.tv_nsec = static_cast<long>(timeout.count() % 1000000000);
+  ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word),
+            FUTEX_WAIT, expected, &ts, nullptr, 0);
+}
+
+// Changes word and wakes every process sleeping on it.
+inline void
+futex_wake(std::atomic<std::uint32_t>& word)
+{
+  word.fetch_add(1);
+  ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word),
+            FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+// Wakes processes sleeping on word, if there are any.
+inline void
+futex_notify(std::atomic<std::uint32_t>& word,
+             std::atomic<std::uint32_t> const& waiters)
+{
+  if (waiters.load() != 0)
+  {
+    futex_wake(word);
+  }
+}
+
+// Shared memory object mapped into this process.
+class shm_mapping
+{
+public:
+  // Creates an object, replacing one left by a ring writer that has
+  // exited.  Fails with EEXIST if the name is in use by anything else.
+  shm_mapping(std::string const& name, std::size_t size)
+  : name_(shm_name(name))
+  , size_(size)
+  , addr_(nullptr)
+  {
+    int fd = ::shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if ((fd == -1) && (errno == EEXIST))
+    {
+      if (!writer_exited(name_))
+      {
+        throw std::system_error(EEXIST, std::system_category(),
+                                "shm_open " + name_);
+      }
+      ::shm_unlink(name_.c_str());
+      fd = ::shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    }
+    if (fd == -1)
+    {
+      throw std::system_error(errno, std::system_category(),
+                              "shm_open " + name_);
+    }
+    if (::ftruncate(fd, static_cast<off_t>(size_)) == -1)
+    {
+      int const ec = errno;
+      ::close(fd);
+      ::shm_unlink(name_.c_str());
+      throw std::system_error(ec, std::system_category(), "ftruncate");
+    }
+    map(fd);
+  }
+
+  // Opens an existing object.
+  explicit
+  shm_mapping(std::string const& name)
+  : name_(shm_name(name))
+  , size_(0)
+  , addr_(nullptr)
+  {
+    int fd = ::shm_open(name_.c_str(), O_RDWR, 0);
+    if (fd == -1)
+    {
+      throw std::system_error(errno, std::system_category(),
+                              "shm_open " + name_);
+    }
+    struct stat st;
+    if (::fstat(fd, &st) == -1)
+    {
+      int const ec = errno;
+      ::close(fd);
+      throw std::system_error(ec, std::system_category(), "fstat");
+    }
+    size_ = static_cast<std::size_t>(st.st_size);
+    map(fd);
+  }
+
+  ~shm_mapping()
+  {
+    ::munmap(addr_, size_);
+  }
+
+  shm_mapping(shm_mapping const&) = delete;
+  shm_mapping& operator=(shm_mapping const&) = delete;
+
+  void unlink() const         { ::shm_unlink(name_.c_str()); }
+
+  std::string const& name() const  { return name_; }
+  std::size_t size() const          { return size_; }
+  char* data() const                { return static_cast<char*>(addr_); }
+
+private:
+  void
+  map(int fd)
+  {
+    addr_ = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    int const ec = errno;
+    ::close(fd);
+    if (addr_ == MAP_FAILED)
+    {
+      throw std::system_error(ec, std::system_category(), "mmap");
+    }
+  }
+
+  std::string name_;
+  std::size_t size_;
+  void*       addr_;
+};
+
+} // detail -----------------------------------------------------------------
+
+/// @addtogroup utl_ipc_shm_ring
+/// @{
+
+//---------------------------------------------------------------------------
+/// @brief  Writer of a shared-memory ring.
+///
+/// Creates the shared memory object, and removes it when destroyed.
+/// Only one thread may write.
+class shm_ring
+{
+public:
+
+  /// @brief  Creates a ring, replacing any left by a writer that has
+  ///         exited without closing it.
+  /// @param  [in]  name        Shared memory object name, such as "/gaze".
+  /// @param  [in]  capacity    Size of the ring in bytes, rounded up to a
+  ///                           power of two.
+  /// @param  [in]  max_readers Maximum number of readers at one time.
+  /// @throws std::system_error if the object cannot be created, with
+  ///         error code `EEXIST` if @a name is in use by a live writer
+  ///         or by an object that is not a ring.
+  shm_ring(std::string const& name, std::size_t capacity,
+           std::size_t max_readers=8)
+  : capacity_(round_up(capacity))
+  , mapping_(name, detail::shm_size(capacity_,
+                                    static_cast<std::uint32_t>(max_readers)))
+  , header_(new (mapping_.data()) detail::shm_ring_header())
+  , slots_(reinterpret_cast<detail::shm_ring_slot*>(
+        mapping_.data() + sizeof(detail::shm_ring_header)))
+  , data_(reinterpret_cast<char*>(slots_ + max_readers))
+  , pos_(0)
+  , record_pos_(0)
+  {
+    // Counters and slots start at zero.
+    header_->capacity = capacity_;
+    header_->max_readers = static_cast<std::uint32_t>(max_readers);
+    header_->writer_pid.store(static_cast<std::int32_t>(::getpid()));
+    for (std::size_t i = 0; i != max_readers; ++i)
+    {
+      new (&slots_[i]) detail::shm_ring_slot();
+    }
+    // Readers may attach once the magic number is set.
+    header_->magic.store(detail::shm_ring_magic);
+  }
+
+  /// Closes the ring, letting readers finish, and removes its name.
+  ~shm_ring()
+  {
+    header_->closed.store(1);
+    detail::futex_wake(header_->data_seq);
+    mapping_.unlink();
+  }
+
+  shm_ring(shm_ring const&) = delete;
+  shm_ring& operator=(shm_ring const&) = delete;
+
+  /// @brief  Publishes a record, waiting while the slowest reader is a
+  ///         full ring behind.
+  /// @throws std::length_error if @a size exceeds max_record_size().
+  void
+  write(void const* data, std::size_t size)
+  {
+    std::memcpy(reserve(size), data, size);
+    commit(size);
+  }
+
+  /// @brief  Publishes a record.
+  void
+  write(std::string const& str)
+  {
+    write(str.data(), str.size());
+  }
+
+  /// @brief  Publishes a record if there is space for it.
+  /// @return `false` if the slowest reader is too far behind.
+  bool
+  try_write(void const* data, std::size_t size)
+  {
+    char* p = try_reserve(size);
+    if (p == nullptr)
+    {
+      return false;
+    }
+    std::memcpy(p, data, size);
+    commit(size);
+    return true;
+  }
+
+  /// @brief  Returns space in the ring for a record of at most @a size
+  ///         bytes, waiting while the slowest reader is a full ring
+  ///         behind.
+  ///
+  /// The record is published by commit().  Writing a record in place
+  /// avoids copying it at all.
+  char*
+  reserve(std::size_t size)
+  {
+    char* p;
+    while ((p = try_reserve(size)) == nullptr)
+    {
+      // Sleep until a reader advances, then reclaim the slots
+      // of readers whose processes have exited.
+      std::uint32_t const seq = header_->space_seq.load();
+      header_->space_waiters.fetch_add(1);
+      if (!fits(size))
+      {
+        detail::futex_wait(header_->space_seq, seq,
+                           std::chrono::milliseconds(10));
+      }
+      header_->space_waiters.fetch_sub(1);
+      reap();
+    }
+    return p;
+  }
+
+  /// @brief  Returns space in the ring for a record of at most @a size
+  ///         bytes, or `nullptr` if the slowest reader is too far behind.
+  char*
+  try_reserve(std::size_t size)
+  {
+    if (size > max_record_size())
+    {
+      throw std::length_error("shm_ring record too long");
+    }
+    if (!fits(size))
+    {
+      return nullptr;
+    }
+    // Records do not wrap around the end of the ring.
+    std::uint64_t const index = pos_ & (capacity_ - 1);
+    record_pos_ = pos_;
+    if ((capacity_ - index) < detail::align8(4 + size))
+    {
+      std::memcpy(data_ + index, &detail::shm_ring_pad, 4);
+      record_pos_ = pos_ + (capacity_ - index);
+    }
+    return (data_ + (record_pos_ & (capacity_ - 1)) + 4);
+  }
+
+  /// @brief  Publishes the record written to the space returned by
+  ///         reserve(), and wakes any sleeping readers.
+  /// @param  [in]  size  Size of the record, at most the size reserved.
+  void
+  commit(std::size_t size)
+  {
+    std::uint32_t const length = static_cast<std::uint32_t>(size);
+    std::memcpy(data_ + (record_pos_ & (capacity_ - 1)), &length, 4);
+    pos_ = record_pos_ + detail::align8(4 + size);
+    header_->write_pos.store(pos_);
+    detail::futex_notify(header_->data_seq, header_->data_waiters);
+  }
+
+  /// Returns the size of the ring in bytes.
+  std::size_t capacity() const  { return capacity_; }
+
+  /// @brief  Returns the largest record that can be written.
+  ///
+  /// Half the ring, but below `0xffffffff`:  record lengths are stored
+  /// in 32 bits, and that value marks padding.
+  std::size_t
+  max_record_size() const
+  {
+    std::uint64_t const half = ((capacity_ / 2) - 8);
+    std::uint64_t const limit = (detail::shm_ring_pad - 1);
+    return static_cast<std::size_t>((half < limit) ? half : limit);
+  }
+
+  /// Returns the number of attached readers.
+  std::size_t
+  reader_count() const
+  {
+    std::size_t n = 0;
+    for (std::size_t i = 0; i != header_->max_readers; ++i)
+    {
+      n += (slots_[i].state.load() == detail::slot_active);
+    }
+    return n;
+  }
+
+  /// Returns the shared memory object name.
+  std::string const& name() const  { return mapping_.name(); }
+
+private:
+
+  static std::uint64_t
+  round_up(std::size_t capacity)
+  {
+    std::uint64_t c = 64;
+    while (c < capacity) { c *= 2; }
+    return c;
+  }
+
+  // Returns true if every reader is far enough ahead for a record of
+  // the specified size, including any padding to the end of the ring.
+  bool
+  fits(std::size_t size) const
+  {
+    std::uint64_t const index = pos_ & (capacity_ - 1);
+    std::uint64_t need = detail::align8(4 + size);
+    if ((capacity_ - index) < need)
+    {
+      need += (capacity_ - index);
+    }
+    std::uint64_t oldest = pos_;
+    for (std::size_t i = 0; i != header_->max_readers; ++i)
+    {
+      if (slots_[i].state.load() == detail::slot_active)
+      {
+        std::uint64_t const c = slots_[i].cursor.load();
+        if (c < oldest) { oldest = c; }
+      }
+    }
+    return ((pos_ + need - oldest) <= capacity_);
+  }
+
+  // Frees the slots of readers whose processes have exited, including
+  // any that died before becoming active.  The writer takes ownership
+  // while it frees a slot, so that no reader claims it meanwhile.
+  void
+  reap()
+  {
+    std::int32_t const self = static_cast<std::int32_t>(::getpid());
+    for (std::size_t i = 0; i != header_->max_readers; ++i)
+    {
+      std::int32_t pid = slots_[i].pid.load();
+      if ((pid != 0) && !detail::process_alive(pid) &&
+          slots_[i].pid.compare_exchange_strong(pid, self))
+      {
+        slots_[i].state.store(detail::slot_free);
+        slots_[i].pid.store(0);
+      }
+    }
+  }
+
+  std::uint64_t               capacity_;
+  detail::shm_mapping         mapping_;
+  detail::shm_ring_header*    header_;
+  detail::shm_ring_slot*      slots_;
+  char*                       data_;
+  std::uint64_t               pos_;         // End of committed records
+  std::uint64_t               record_pos_;  // Start of reserved record
+};
+
+//---------------------------------------------------------------------------
+/// @brief  Reader of a shared-memory ring.
+///
+/// Receives every record published after it attaches.  Records are
+/// passed to the handler in place in shared memory, and remain valid
+/// until the handler returns.  A reader holds back the writer, so a
+/// stalled reader eventually stalls the writer; the slots of readers
+/// whose processes exit are reclaimed.  A reader whose writer exits
+/// without closing the ring stops once it has read every record.
+class shm_ring_reader
+{
+public:
+
+  /// Handler that receives a copy of each record.
+  using read_handler = std::function<void(std::string const&)>;
+
+  /// Handler that receives each record in place.
+  using buffer_handler = std::function<void(char const*, std::size_t)>;
+
+  /// @brief  Attaches to a ring.
+  /// @param  [in]  name    Shared memory object name used by the writer.
+  /// @param  [in]  handler Callback to process records in place.
+  /// @throws std::system_error if the ring does not exist, or
+  ///         std::runtime_error if all reader slots are taken by live
+  ///         processes.
+  shm_ring_reader(std::string const& name, buffer_handler handler)
+  : mapping_(name)
+  , header_(reinterpret_cast<detail::shm_ring_header*>(mapping_.data()))
+  , slot_(nullptr)
+  , data_(nullptr)
+  , capacity_(0)
+  , cursor_(0)
+  , handler_(std::move(handler))
+  , stopped_(false)
+  {
+    if ((mapping_.size() < sizeof(detail::shm_ring_header)) ||
+        (header_->magic.load() != detail::shm_ring_magic))
+    {
+      throw std::runtime_error(mapping_.name() + " is not a shm_ring");
+    }
+    capacity_ = header_->capacity;
+    auto slots = reinterpret_cast<detail::shm_ring_slot*>(
+        mapping_.data() + sizeof(detail::shm_ring_header));
+    data_ = reinterpret_cast<char*>(slots + header_->max_readers);
+
+    // Claim a free slot, or else one whose reader has exited.
+    std::int32_t const self = static_cast<std::int32_t>(::getpid());
+    for (int pass = 0; (pass != 2) && (slot_ == nullptr); ++pass)
+    {
+      for (std::size_t i = 0; i != header_->max_readers; ++i)
+      {
+        std::int32_t pid = slots[i].pid.load();
+        if (((pass == 0) ? (pid == 0)
+                         : ((pid != 0) && !detail::process_alive(pid))) &&
+            slots[i].pid.compare_exchange_strong(pid, self))
+        {
+          slot_ = &slots[i];
+          break;
+        }
+      }
+    }
+    if (slot_ == nullptr)
+    {
+      throw std::runtime_error(mapping_.name() + " has too many readers");
+    }
+    // Start at the end of published records.  Reading the position
+    // again once active ensures the writer has seen this reader before
+    // it writes over anything after the cursor.
+    slot_->cursor.store(header_->write_pos.load());
+    slot_->state.store(detail::slot_active);
+    cursor_ = header_->write_pos.load();
+    slot_->cursor.store(cursor_);
+  }
+
+  /// @brief  Attaches to a ring.
+  /// @param  [in]  name    Shared memory object name used by the writer.
+  /// @param  [in]  handler Callback to process a copy of each record.
+  shm_ring_reader(std::string const& name, read_handler handler)
+  : shm_ring_reader(name,
+        [handler](char const* data, std::size_t size)
+        {
+          handler(std::string(data, size));
+        })
+  {}
+
+  /// Detaches from the ring, releasing the writer.
+  ~shm_ring_reader()
+  {
+    slot_->state.store(detail::slot_free);
+    slot_->pid.store(0);
+    detail::futex_notify(header_->space_seq, header_->space_waiters);
+  }
+
+  shm_ring_reader(shm_ring_reader const&) = delete;
+  shm_ring_reader& operator=(shm_ring_reader const&) = delete;
+
+  /// @brief  Passes records to the handler until stop() is called,
+  ///         or until the writer has closed the ring or exited and
+  ///         every record has been read.
+  void
+  run()
+  {
+    while (!stopped_.load())
+    {
+      if (poll() != 0)
+      {
+        continue;
+      }
+      if (header_->closed.load() != 0)
+      {
+        if (poll() == 0) { break; }
+        continue;
+      }
+      // Sleep until the writer publishes.
+      header_->data_waiters.fetch_add(1);
+      std::uint32_t const seq = header_->data_seq.load();
+      bool idle = false;
+      if ((header_->write_pos.load() == cursor_) && !stopped_.load() &&
+          (header_->closed.load() == 0))
+      {
+        detail::futex_wait(header_->data_seq, seq,
+                           std::chrono::milliseconds(100));
+        idle = (header_->write_pos.load() == cursor_);
+      }
+      header_->data_waiters.fetch_sub(1);
+
+      // A writer that dies without closing the ring never wakes us.
+      if (idle && !writer_alive())
+      {
+        break;
+      }
+    }
+  }
+
+  /// @brief  Makes run() return.  May be called from any thread,
+  ///         including from the handler.
+  void
+  stop()
+  {
+    stopped_.store(true);
+    detail::futex_wake(header_->data_seq);
+  }
+
+  /// @brief  Passes every record published so far to the handler,
+  ///         without waiting.
+  /// @return Number of records read.
+  std::size_t
+  poll()
+  {
+    std::uint64_t const end = header_->write_pos.load(std::memory_order_acquire);
+    std::uint64_t pos = cursor_;
+    std::size_t n = 0;
+    while ((pos != end) && !stopped_.load(std::memory_order_relaxed))
+    {
+      std::uint64_t const index = pos & (capacity_ - 1);
+      std::uint32_t length;
+      std::memcpy(&length, data_ + index, 4);
+      if (length == detail::shm_ring_pad)
+      {
+        pos += (capacity_ - index);
+        continue;
+      }
+      handler_(data_ + index + 4, length);
+      pos += detail::align8(4 + length);
+      ++n;
+    }
+    if (pos != cursor_)
+    {
+      cursor_ = pos;
+      slot_->cursor.store(pos);
+      detail::futex_notify(header_->space_seq, header_->space_waiters);
+    }
+    return n;
+  }
+
+  /// @brief  Returns `false` if the writer process has exited.
+  ///
+  /// The writer and readers must share a PID namespace.
+  bool
+  writer_alive() const
+  {
+    return detail::process_alive(header_->writer_pid.load());
+  }
+
+  /// Returns the number of published bytes not yet read.
+  std::size_t
+  lag() const
+  {
+    return static_cast<std::size_t>(header_->write_pos.load() - cursor_);
+  }
+
+private:
+  detail::shm_mapping         mapping_;
+  detail::shm_ring_header*    header_;
+  detail::shm_ring_slot*      slot_;
+  char*                       data_;
+  std::uint64_t               capacity_;
+  std::uint64_t               cursor_;    // Next byte to read
+  buffer_handler              handler_;
+  std::atomic<bool>           stopped_;
+};
+
+/// @}
+
+} } // utl::ipc
+
+#endif // UTL_IPC_SHM_RING_HPP
+//===========================================================================//
@@ -45,7 +45,11 @@ SOFTWARE.
 #pragma GCC diagnostic pop
 //-----------------------------------------------------------
 
-#include <vector>
+#include <utl/json/json_reader.hpp>  // utl::json::reader,
+                                     // utl::json::extract
+
+#include <string>   // std::string
+#include <vector>   // std::vector
 
 /// @defgroup utl_json  json
 /// @brief    JSON utility library.
@@ -91,23 +95,32 @@ is_type<std::string>(nlohmann::json const& j)   { return j.is_string(); }
 
 //---------------------------------------------------------------------------
 
+/// @brief  Returns the value of @a key in object @a j, or `nullptr` if
+///         @a j is not an object or has no such key.
+///
+/// Unlike `nlohmann::json::find()` and `count()`, which take the key by
+/// value, the key is neither copied nor looked up more than once.
+inline nlohmann::json const*
+find(nlohmann::json const& j, std::string const& key)
+{
+  auto obj = j.get_ptr<nlohmann::json::object_t const*>();
+  if (!obj) { return nullptr; }
+  auto it = obj->find(key);
+  return ((it != obj->end()) ? &it->second : nullptr);
+}
+
 // bool, int, unsigned, float, double
 template<typename T>
 inline bool
 value(nlohmann::json const& j, std::string const& key, T& val)
 {
-  if (j.count(key))
+  nlohmann::json const* j_val = utl::json::find(j, key);
+  if (j_val && utl::json::is_type<T>(*j_val))
   {
-    nlohmann::json j_val = j[key];
-    if (utl::json::is_type<T>(j_val))
-    {
-      val = j_val.get<T>();
-      return true;
-    }
-    //else { /* wrong type */ }
+    val = j_val->get<T>();
+    return true;
   }
-  //else { /* key not found */ }
-  return false;
+  return false;   // key not found, or wrong type
 }
 
 
@@ -116,18 +129,13 @@ template<typename T>
 inline bool
 value(nlohmann::json const& j, std::string const& key, std::vector<T>& val)
 {
-  if (j.count(key))
+  nlohmann::json const* j_val = utl::json::find(j, key);
+  if (j_val && j_val->is_array())
   {
-    nlohmann::json j_val = j[key];
-    if (j_val.is_array())
-    {
-      val = j_val.get<std::vector<T>>();
-      return true;
-    }
-    //else { /* wrong type */ }
+    val = j_val->get<std::vector<T>>();
+    return true;
   }
-  //else { /* key not found */ }
-  return false;
+  return false;   // key not found, or wrong type
 }
 
 
@@ -135,14 +143,11 @@ value(nlohmann::json const& j, std::string const& key, std::vector<T>& val)
 inline bool
 value(nlohmann::json const& j, std::string const& key, nlohmann::json& val)
 {
-  if (j.count(key))
+  nlohmann::json const* obj = utl::json::find(j, key);
+  if (obj && obj->is_object())
   {
-    nlohmann::json obj = j[key];
-    if (obj.is_object())
-    {
-      val = obj;
-      return true;
-    }
+    val = *obj;
+    return true;
   }
   return false;
 }
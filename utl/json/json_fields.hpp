@@ -0,0 +1,766 @@
+/*
+Licensed under the MIT License <http://opensource.org/licenses/MIT>
+
+Copyright 2018 Nathan Lucas <nathan.lucas@wayne.edu>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+//===========================================================================//
+/// @file
+/// @brief    JSON struct binding.
+/// @details  Generates JSON decoding and encoding for the listed members
+///           of a struct.
+/// @author   Nathan Lucas
+/// @date     2018
+//===========================================================================//
+#ifndef UTL_JSON_FIELDS_HPP
+#define UTL_JSON_FIELDS_HPP
+
+#ifndef __cplusplus
+#error must be compiled as C++
+#endif
+
+#include <utl/compile.hpp>            // UTL_FOR_EACH, UTL_PP_COUNT
+#include <utl/json.hpp>               // nlohmann::json
+#include <utl/json/json_reader.hpp>   // utl::json::reader
+
+#include <array>        // std::array
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::int64_t, std::uint32_t, std::uint64_t
+#include <cstring>      // std::memcmp, std::strlen
+#include <limits>       // std::numeric_limits
+#include <stdexcept>    // std::invalid_argument
+#include <string>       // std::string, std::to_string
+#include <type_traits>  // std::enable_if, std::is_arithmetic,
+                        // std::is_floating_point, std::is_integral,
+                        // std::is_same, std::is_signed
+#include <utility>      // std::move
+#include <vector>       // std::vector
+
+namespace utl { namespace json {
+
+/// @addtogroup utl_json
+/// @{
+
+//---------------------------------------------------------------------------
+/// @name Struct Binding
+/// @{
+
+/// Member that could not be decoded.
+struct field_error
+{
+  /// Reasons a member could not be decoded.
+  enum class kind
+  {
+    missing,      ///< Key not found
+    wrong_type    ///< Value has the wrong type or is out of range
+  };
+
+  std::string path;   ///< Keys separated by `.`, with `[i]` for elements
+  kind        reason; ///< Why the member was not decoded
+};
+
+/// Exception listing every member that could not be decoded.
+class decode_error : public std::invalid_argument
+{
+public:
+  /// Constructor.
+  explicit
+  decode_error(std::vector<field_error> errors);
+
+  /// Returns the members that could not be decoded.
+  std::vector<field_error> const&
+  errors() const  { return errors_; }
+
+private:
+  static std::string message(std::vector<field_error> const& errors);
+
+  std::vector<field_error> errors_;
+};
+
+/// @brief  Members of @a T bound to JSON keys.
+///
+/// Defined for a struct by UTL_JSON_FIELDS.
+template<typename T, typename Enable=void>
+struct fields {};
+
+/// @brief  Decodes @a v from the JSON object in [@a first, @a last) in
+///         one pass.
+/// @param  [in]  first   Beginning of JSON text.
+/// @param  [in]  last    End of JSON text.
+/// @param  [out] v       Assigned the value of each member found.
+/// @param  [out] errors  Cleared, then assigned every member that is
+///                       missing or has the wrong type.
+/// @return `true` if every member was decoded.
+/// @throw  std::invalid_argument if the text is malformed.
+///
+/// Members that are missing or have the wrong type keep their values, so
+/// @a v may be initialized with defaults.  A vector keeps its value if
+/// any element has an error, though every such error is listed.
+/// Unlisted keys are ignored.
+template<typename T>
+bool
+decode(char const* first, char const* last, T& v,
+       std::vector<field_error>& errors);
+
+/// @copydoc decode(char const*, char const*, T&, std::vector<field_error>&)
+template<typename T>
+bool
+decode(std::string const& text, T& v, std::vector<field_error>& errors);
+
+/// @copydoc decode(char const*, char const*, T&, std::vector<field_error>&)
+template<typename T>
+bool
+decode(char const* text, T& v, std::vector<field_error>& errors);
+
+/// @brief  Decodes @a v from JSON object @a j in one pass.
+/// @copydetails decode(char const*, char const*, T&, std::vector<field_error>&)
+template<typename T>
+bool
+decode(nlohmann::json const& j, T& v, std::vector<field_error>& errors);
+
+/// @brief  Decodes @a v from JSON @a text.
+/// @throw  utl::json::decode_error listing every member that is missing
+///         or has the wrong type.
+/// @throw  std::invalid_argument if the text is malformed.
+template<typename T>
+void
+decode(std::string const& text, T& v);
+
+/// @copydoc decode(std::string const&, T&)
+template<typename T>
+void
+decode(char const* text, T& v);
+
+/// @brief  Decodes @a v from JSON object @a j.
+/// @throw  utl::json::decode_error listing every member that is missing
+///         or has the wrong type.
+template<typename T>
+void
+decode(nlohmann::json const& j, T& v);
+
+/// Returns @a v as a JSON object.
+template<typename T>
+nlohmann::json
+encode(T const& v);
+
+/// @}
+//---------------------------------------------------------------------------
+
+/// @}
+
+//===========================================================================//
+// Implementation
+
+namespace detail {  //-------------------------------------------------------
+
+// FNV-1a hash of a member name, computed at compile time.
+constexpr std::uint32_t
+name_hash(char const* s, std::uint32_t h = 2166136261u)
+{
+  return ((*s == '\0') ? h
+          : name_hash(s + 1, (h ^ static_cast<unsigned char>(*s)) * 16777619u));
+}
+
+// FNV-1a hash of a key.
+inline std::uint32_t
+key_hash(char const* s, std::size_t n)
+{
+  std::uint32_t h = 2166136261u;
+  for (std::size_t i = 0; i != n; ++i)
+  {
+    h = (h ^ static_cast<unsigned char>(s[i])) * 16777619u;
+  }
+  return h;
+}
+
+// Path of the value being decoded, and the errors found so far.
+struct decode_state
+{
+  std::vector<field_error>& errors;
+  std::string               path;
+
+  void
+  error(field_error::kind reason)
+  {
+    errors.push_back(field_error{ path, reason });
+  }
+
+  // Appends a key to the path and returns the previous length.
+  std::size_t
+  push(char const* name)
+  {
+    std::size_t const size = path.size();
+    if (size != 0) { path += '.'; }
+    path += name;
+    return size;
+  }
+
+  // Appends an element index to the path and returns the previous length.
+  std::size_t
+  push(std::size_t index)
+  {
+    std::size_t const size = path.size();
+    path += '[' + std::to_string(index) + ']';
+    return size;
+  }
+};
+
+// Bound member of struct T.
+template<typename T>
+struct member
+{
+  char const*   name;
+  std::size_t   length;
+  std::uint32_t hash;
+  void        (*read)(reader&, T&, decode_state&);
+  void        (*convert)(nlohmann::json const&, T&, decode_state&);
+  void        (*write)(T const&, nlohmann::json&);
+};
+
+// True if T has members bound by UTL_JSON_FIELDS.
+template<typename T, typename Enable=void>
+struct is_bound : std::false_type {};
+
+template<typename T>
+struct is_bound<T, typename std::enable_if<
+    (sizeof(fields<T>::members()) != 0)>::type> : std::true_type {};
+
+// Open addressing table of the member names of T, indexed by hash.
+// The hashes are constants; the table is filled on first use.
+template<typename T>
+class key_table
+{
+public:
+
+  static key_table const&
+  get()
+  {
+    static key_table const table;
+    return table;
+  }
+
+  member<T> const*
+  find(char const* key, std::size_t size) const
+  {
+    std::uint32_t const h = key_hash(key, size);
+    for (std::size_t i = (h & mask_); slots_[i] != 0; i = ((i + 1) & mask_))
+    {
+      member<T> const& m = fields<T>::members()[slots_[i] - 1];
+      if ((m.hash == h) && (m.length == size) &&
+          (std::memcmp(m.name, key, size) == 0))
+      {
+        return &m;
+      }
+    }
+    return nullptr;
+  }
+
+private:
+
+  // At most half full, so probe sequences are short.
+  static constexpr std::size_t capacity = 64;
+  static_assert((2 * fields<T>::size) <= capacity, "too many members");
+
+  key_table()
+  : mask_(3)
+  , slots_()
+  {
+    while ((mask_ + 1) < (2 * fields<T>::size)) { mask_ = (2 * mask_) + 1; }
+    slots_.fill(0);
+    for (std::size_t k = 0; k != fields<T>::size; ++k)
+    {
+      std::size_t i = (fields<T>::members()[k].hash & mask_);
+      while (slots_[i] != 0) { i = ((i + 1) & mask_); }
+      slots_[i] = static_cast<unsigned char>(k + 1);
+    }
+  }
+
+  std::size_t                           mask_;
+  std::array<unsigned char, capacity>   slots_;   // Member index + 1
+};
+
+//-----------------------------------------------------------
+// Conversion of nlohmann::json values, like reader::number()
+// and read_value().
+
+inline bool
+json_value(nlohmann::json const& j, bool& v)
+{
+  if (!j.is_boolean()) { return false; }
+  v = j.get<bool>();
+  return true;
+}
+
+inline bool
+json_value(nlohmann::json const& j, std::string& v)
+{
+  if (!j.is_string()) { return false; }
+  v = j.get_ref<std::string const&>();
+  return true;
+}
+
+inline bool
+json_value(nlohmann::json const& j, nlohmann::json& v)
+{
+  v = j;
+  return true;
+}
+
+template<typename T>
+inline typename std::enable_if<std::is_integral<T>::value &&
+                               !std::is_same<T, bool>::value, bool>::type
+json_value(nlohmann::json const& j, T& v)
+{
+  if (j.is_number_unsigned())
+  {
+    std::uint64_t const u = j.get<std::uint64_t>();
+    if (u > static_cast<std::uint64_t>(std::numeric_limits<T>::max()))
+    {
+      return false;
+    }
+    v = static_cast<T>(u);
+    return true;
+  }
+  if (j.is_number_integer())
+  {
+    std::int64_t const i = j.get<std::int64_t>();
+    if ((i < 0) && !std::is_signed<T>::value) { return false; }
+    if (std::is_signed<T>::value &&
+        ((i < static_cast<std::int64_t>(std::numeric_limits<T>::min())) ||
+         (i > static_cast<std::int64_t>(std::numeric_limits<T>::max()))))
+    {
+      return false;
+    }
+    v = static_cast<T>(i);
+    return true;
+  }
+  return false;
+}
+
+template<typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value, bool>::type
+json_value(nlohmann::json const& j, T& v)
+{
+  if (!j.is_number()) { return false; }
+  double const d = j.get<double>();
+  if ((d > std::numeric_limits<T>::max()) ||
+      (d < -std::numeric_limits<T>::max()))
+  {
+    return false;
+  }
+  v = static_cast<T>(d);
+  return true;
+}
+
+template<typename T, typename Allocator>
+inline bool
+json_value(nlohmann::json const& j, std::vector<T, Allocator>& v)
+{
+  if (!j.is_array()) { return false; }
+  std::vector<T, Allocator> elements;
+  elements.reserve(j.size());
+  for (nlohmann::json const& e : j)
+  {
+    T x{};
+    if (!json_value(e, x)) { return false; }
+    elements.push_back(std::move(x));
+  }
+  v.swap(elements);
+  return true;
+}
+
+//-----------------------------------------------------------
+// Decoding and encoding of members.  The overloads for bound
+// structs, and vectors of them, recurse through the members.
+
+template<typename T>
+typename std::enable_if<!is_bound<T>::value>::type
+read_field(reader& r, T& v, decode_state& s);
+
+template<typename T>
+typename std::enable_if<is_bound<T>::value>::type
+read_field(reader& r, T& v, decode_state& s);
+
+template<typename T, typename Allocator>
+typename std::enable_if<is_bound<T>::value>::type
+read_field(reader& r, std::vector<T, Allocator>& v, decode_state& s);
+
+template<typename T>
+typename std::enable_if<!is_bound<T>::value>::type
+convert_field(nlohmann::json const& j, T& v, decode_state& s);
+
+template<typename T>
+typename std::enable_if<is_bound<T>::value>::type
+convert_field(nlohmann::json const& j, T& v, decode_state& s);
+
+template<typename T, typename Allocator>
+typename std::enable_if<is_bound<T>::value>::type
+convert_field(nlohmann::json const& j, std::vector<T, Allocator>& v,
+              decode_state& s);
+
+template<typename T>
+typename std::enable_if<!is_bound<T>::value>::type
+write_field(T const& v, nlohmann::json& j);
+
+template<typename T>
+typename std::enable_if<is_bound<T>::value>::type
+write_field(T const& v, nlohmann::json& j);
+
+template<typename T, typename Allocator>
+typename std::enable_if<is_bound<T>::value>::type
+write_field(std::vector<T, Allocator> const& v, nlohmann::json& j);
+
+// Member functions referenced by the table of struct T.
+
+template<typename T, typename M, M T::*P>
+inline void
+read_member(reader& r, T& v, decode_state& s)
+{
+  read_field(r, v.*P, s);
+}
+
+template<typename T, typename M, M T::*P>
+inline void
+convert_member(nlohmann::json const& j, T& v, decode_state& s)
+{
+  convert_field(j, v.*P, s);
+}
+
+template<typename T, typename M, M T::*P>
+inline void
+write_member(T const& v, nlohmann::json& j)
+{
+  write_field(v.*P, j);
+}
+
+// Reports the members of T not marked in seen as missing.
+template<typename T>
+inline void
+report_missing(std::uint32_t seen, decode_state& s)
+{
+  for (std::size_t k = 0; k != fields<T>::size; ++k)
+  {
+    if (!(seen & (std::uint32_t(1) << k)))
+    {
+      std::size_t const size = s.push(fields<T>::members()[k].name);
+      s.error(field_error::kind::missing);
+      s.path.resize(size);
+    }
+  }
+}
+
+template<typename T>
+inline typename std::enable_if<!is_bound<T>::value>::type
+read_field(reader& r, T& v, decode_state& s)
+{
+  if (!read_value(r, v)) { s.error(field_error::kind::wrong_type); }
+}
+
+template<typename T>
+inline typename std::enable_if<is_bound<T>::value>::type
+read_field(reader& r, T& v, decode_state& s)
+{
+  using token = reader::token;
+  if (r.current() != token::object_begin)
+  {
+    r.skip();
+    s.error(field_error::kind::wrong_type);
+    return;
+  }
+  key_table<T> const& table = key_table<T>::get();
+  std::uint32_t seen = 0;
+  while (r.next() != token::object_end)
+  {
+    member<T> const* m = table.find(r.data(), r.size());
+    r.next();
+    if (!m)
+    {
+      r.skip();
+      continue;
+    }
+    seen |= (std::uint32_t(1) << (m - fields<T>::members()));
+    std::size_t const size = s.push(m->name);
+    m->read(r, v, s);
+    s.path.resize(size);
+  }
+  report_missing<T>(seen, s);
+}
+
+template<typename T, typename Allocator>
+inline typename std::enable_if<is_bound<T>::value>::type
+read_field(reader& r, std::vector<T, Allocator>& v, decode_state& s)
+{
+  using token = reader::token;
+  if (r.current() != token::array_begin)
+  {
+    r.skip();
+    s.error(field_error::kind::wrong_type);
+    return;
+  }
+  std::size_t const errors = s.errors.size();
+  std::vector<T, Allocator> elements;
+  while (r.next() != token::array_end)
+  {
+    elements.emplace_back();
+    std::size_t const size = s.push(elements.size() - 1);
+    read_field(r, elements.back(), s);
+    s.path.resize(size);
+  }
+  if (s.errors.size() == errors) { v.swap(elements); }
+}
+
+template<typename T>
+inline typename std::enable_if<!is_bound<T>::value>::type
+convert_field(nlohmann::json const& j, T& v, decode_state& s)
+{
+  if (!json_value(j, v)) { s.error(field_error::kind::wrong_type); }
+}
+
+template<typename T>
+inline typename std::enable_if<is_bound<T>::value>::type
+convert_field(nlohmann::json const& j, T& v, decode_state& s)
+{
+  auto obj = j.get_ptr<nlohmann::json::object_t const*>();
+  if (!obj)
+  {
+    s.error(field_error::kind::wrong_type);
+    return;
+  }
+  key_table<T> const& table = key_table<T>::get();
+  std::uint32_t seen = 0;
+  for (auto const& kv : *obj)
+  {
+    member<T> const* m = table.find(kv.first.data(), kv.first.size());
+    if (!m) { continue; }
+    seen |= (std::uint32_t(1) << (m - fields<T>::members()));
+    std::size_t const size = s.push(m->name);
+    m->convert(kv.second, v, s);
+    s.path.resize(size);
+  }
+  report_missing<T>(seen, s);
+}
+
+template<typename T, typename Allocator>
+inline typename std::enable_if<is_bound<T>::value>::type
+convert_field(nlohmann::json const& j, std::vector<T, Allocator>& v,
+              decode_state& s)
+{
+  if (!j.is_array())
+  {
+    s.error(field_error::kind::wrong_type);
+    return;
+  }
+  std::size_t const errors = s.errors.size();
+  std::vector<T, Allocator> elements(j.size());
+  for (std::size_t i = 0; i != elements.size(); ++i)
+  {
+    std::size_t const size = s.push(i);
+    convert_field(j[i], elements[i], s);
+    s.path.resize(size);
+  }
+  if (s.errors.size() == errors) { v.swap(elements); }
+}
+
+template<typename T>
+inline typename std::enable_if<!is_bound<T>::value>::type
+write_field(T const& v, nlohmann::json& j)
+{
+  j = v;
+}
+
+template<typename T>
+inline typename std::enable_if<is_bound<T>::value>::type
+write_field(T const& v, nlohmann::json& j)
+{
+  j = nlohmann::json::object();
+  for (std::size_t k = 0; k != fields<T>::size; ++k)
+  {
+    member<T> const& m = fields<T>::members()[k];
+    m.write(v, j[m.name]);
+  }
+}
+
+template<typename T, typename Allocator>
+inline typename std::enable_if<is_bound<T>::value>::type
+write_field(std::vector<T, Allocator> const& v, nlohmann::json& j)
+{
+  j = nlohmann::json::array();
+  for (T const& x : v)
+  {
+    nlohmann::json element;
+    write_field(x, element);
+    j.push_back(std::move(element));
+  }
+}
+
+} // detail -----------------------------------------------------------------
+
+inline
+decode_error::decode_error(std::vector<field_error> errors)
+: std::invalid_argument(message(errors))
+, errors_(std::move(errors))
+{}
+
+inline std::string
+decode_error::message(std::vector<field_error> const& errors)
+{
+  std::string s = "utl::json:";
+  for (field_error const& e : errors)
+  {
+    s += ((e.reason == field_error::kind::missing) ? " missing "
+                                                   : " wrong type ");
+    s += (e.path.empty() ? std::string("value") : ('"' + e.path + '"'));
+    s += ';';
+  }
+  s.pop_back();
+  return s;
+}
+
+template<typename T>
+inline bool
+decode(char const* first, char const* last, T& v,
+       std::vector<field_error>& errors)
+{
+  static_assert(detail::is_bound<T>::value, "T requires UTL_JSON_FIELDS");
+  errors.clear();
+  detail::decode_state s{ errors, std::string() };
+  reader r(first, last);
+  r.next();
+  detail::read_field(r, v, s);
+  r.next();   // Check for text after the object
+  return errors.empty();
+}
+
+template<typename T>
+inline bool
+decode(std::string const& text, T& v, std::vector<field_error>& errors)
+{
+  return decode(text.data(), text.data() + text.size(), v, errors);
+}
+
+template<typename T>
+inline bool
+decode(char const* text, T& v, std::vector<field_error>& errors)
+{
+  return decode(text, text + std::strlen(text), v, errors);
+}
+
+template<typename T>
+inline bool
+decode(nlohmann::json const& j, T& v, std::vector<field_error>& errors)
+{
+  static_assert(detail::is_bound<T>::value, "T requires UTL_JSON_FIELDS");
+  errors.clear();
+  detail::decode_state s{ errors, std::string() };
+  detail::convert_field(j, v, s);
+  return errors.empty();
+}
+
+template<typename T>
+inline void
+decode(std::string const& text, T& v)
+{
+  std::vector<field_error> errors;
+  if (!decode(text, v, errors)) { throw decode_error(std::move(errors)); }
+}
+
+template<typename T>
+inline void
+decode(char const* text, T& v)
+{
+  std::vector<field_error> errors;
+  if (!decode(text, v, errors)) { throw decode_error(std::move(errors)); }
+}
+
+template<typename T>
+inline void
+decode(nlohmann::json const& j, T& v)
+{
+  std::vector<field_error> errors;
+  if (!decode(j, v, errors)) { throw decode_error(std::move(errors)); }
+}
+
+template<typename T>
+inline nlohmann::json
+encode(T const& v)
+{
+  static_assert(detail::is_bound<T>::value, "T requires UTL_JSON_FIELDS");
+  nlohmann::json j;
+  detail::write_field(v, j);
+  return j;
+}
+
+} } // utl::json
+
+//---------------------------------------------------------------------------
+/// @ingroup  utl_json
+/// @brief    Defines utl::json::fields for struct @a Type, binding each
+///           listed member to the key of the same name.
+///
+/// Use at global scope, with @a Type fully qualified.  Up to 32 members
+/// may be listed.  A member may be `bool`, an arithmetic type,
+/// `std::string`, `nlohmann::json`, a `std::vector` of these, or another
+/// bound struct or a `std::vector` of them.
+///
+/// Key hashes are computed at compile time, so decoding looks up each key
+/// of an object once, and in constant time.
+///
+/// Example usage:
+/// ```
+///   struct server_config
+///   {
+///     std::string host;
+///     int         port = 80;
+///     bool        verbose = false;
+///   };
+///   UTL_JSON_FIELDS(server_config, host, port, verbose)
+///
+///   server_config c;
+///   std::vector<utl::json::field_error> errors;
+///   if (!utl::json::decode(text, c, errors)) { /* report errors */ }
+///   nlohmann::json j = utl::json::encode(c);
+/// ```
+#define UTL_JSON_FIELDS(Type, ...) \
+  namespace utl { namespace json { \
+  template<> \
+  struct fields<Type> \
+  { \
+    enum : std::size_t { size = UTL_PP_COUNT(__VA_ARGS__) }; \
+    static detail::member<Type> const* \
+    members() \
+    { \
+      static detail::member<Type> const m[] = { \
+        UTL_FOR_EACH(UTL_JSON_FIELDS_MEMBER_, Type, __VA_ARGS__) \
+      }; \
+      return m; \
+    } \
+  }; \
+  } }
+
+/// @cond
+#define UTL_JSON_FIELDS_MEMBER_(Type, m) \
+  { #m, (sizeof(#m) - 1), ::utl::json::detail::name_hash(#m), \
+    &::utl::json::detail::read_member<Type, decltype(Type::m), &Type::m>, \
+    &::utl::json::detail::convert_member<Type, decltype(Type::m), &Type::m>, \
+    &::utl::json::detail::write_member<Type, decltype(Type::m), &Type::m> },
+/// @endcond
+
+#endif // UTL_JSON_FIELDS_HPP
+//===========================================================================//
@@ -0,0 +1,797 @@
+/*
+Licensed under the MIT License <http://opensource.org/licenses/MIT>
+
+Copyright 2018 Nathan Lucas <nathan.lucas@wayne.edu>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+//===========================================================================//
+/// @file
+/// @brief    Streaming JSON reader.
+/// @details  Reads JSON text token by token without building a document,
+///           and extracts known keys into typed fields in one pass.
+/// @author   Nathan Lucas
+/// @date     2018
+//===========================================================================//
+#ifndef UTL_JSON_READER_HPP
+#define UTL_JSON_READER_HPP
+
+#ifndef __cplusplus
+#error must be compiled as C++
+#endif
+
+#include <cmath>            // std::isinf
+#include <cstddef>          // std::size_t
+#include <cstdint>          // std::uint32_t, std::uint64_t
+#include <cstdlib>          // std::strtod
+#include <cstring>          // std::memcmp, std::memcpy, std::strlen
+#include <initializer_list> // std::initializer_list
+#include <limits>           // std::numeric_limits
+#include <stdexcept>        // std::invalid_argument
+#include <string>           // std::string, std::to_string
+#include <type_traits>      // std::enable_if, std::is_arithmetic,
+                            // std::is_floating_point, std::is_integral,
+                            // std::is_same, std::is_signed
+#include <utility>          // std::move
+#include <vector>           // std::vector
+
+namespace utl { namespace json {
+
+/// @addtogroup utl_json
+/// @{
+
+//---------------------------------------------------------------------------
+/// @brief  Streaming JSON reader.
+///
+/// Reads one token per call to next(), checking the syntax as it goes.
+/// Nothing is allocated per token:  strings without escape sequences
+/// and numbers refer to the input text, and strings with escape
+/// sequences are decoded into a buffer that is reused.  The text must
+/// remain valid while the reader is used.
+///
+/// Malformed text throws `std::invalid_argument`, as does
+/// `nlohmann::json::parse()`.
+///
+/// Example usage:
+/// ```
+///   utl::json::reader r(text);
+///   using token = utl::json::reader::token;
+///   for (token t = r.next(); t != token::end; t = r.next())
+///   {
+///     if ((t == token::key) && (r.str() == "port"))
+///     {
+///       r.next();
+///       r.number(port);
+///     }
+///   }
+/// ```
+class reader
+{
+public:
+
+  /// Kinds of token.
+  enum class token
+  {
+    object_begin,   ///< `{`
+    object_end,     ///< `}`
+    array_begin,    ///< `[`
+    array_end,      ///< `]`
+    key,            ///< Member name, followed by its value
+    string,         ///< String value
+    number,         ///< Number value
+    boolean,        ///< `true` or `false`
+    null,           ///< `null`
+    end             ///< End of the document
+  };
+
+  /// Construct a reader of the text in [@a first, @a last).
+  reader(char const* first, char const* last);
+
+  /// Construct a reader of null-terminated @a text.
+  explicit
+  reader(char const* text);
+
+  /// Construct a reader of @a text.
+  explicit
+  reader(std::string const& text);
+
+  /// The text must outlive the reader.
+  reader(std::string&&) = delete;
+
+  /// @brief  Reads the next token.
+  /// @throw  std::invalid_argument if the text is malformed.
+  token next();
+
+  /// Returns the current token.
+  token current() const   { return token_; }
+
+  /// @brief  Skips the value that begins with the current token, or
+  ///         the value of the current key.
+  ///
+  /// Afterwards, the current token is the last token of the value.
+  void skip();
+
+  /// Returns the number of containers that enclose the current token.
+  std::size_t depth() const   { return stack_.size(); }
+
+  /// Returns the text where the current token begins.
+  char const* token_begin() const   { return token_begin_; }
+
+  /// Returns the text following the current token.
+  char const* position() const      { return p_; }
+
+  //-----------------------------------------------------------
+  /// @name Token Values
+  /// @{
+
+  /// Characters of the current key or string, valid until next().
+  char const* data() const    { return str_; }
+
+  /// Number of characters of the current key or string.
+  std::size_t size() const    { return str_size_; }
+
+  /// Returns a copy of the current key or string.
+  std::string str() const     { return std::string(str_, str_size_); }
+
+  /// Returns the value of the current boolean.
+  bool boolean() const        { return bool_; }
+
+  /// Returns `true` if the current number has no fraction or exponent.
+  bool is_integer() const     { return integer_; }
+
+  /// @brief  Converts the current number to an integer.
+  /// @return `false` if the number is not an integer or is out of range
+  ///         of @a T, in which case @a v is unchanged.
+  template<typename T>
+  typename std::enable_if<std::is_integral<T>::value, bool>::type
+  number(T& v) const;
+
+  /// @brief  Converts the current number to floating point.
+  /// @return `false` if the number is out of range of @a T, in which
+  ///         case @a v is unchanged.  Numbers too small to represent
+  ///         become subnormal or zero.
+  template<typename T>
+  typename std::enable_if<std::is_floating_point<T>::value, bool>::type
+  number(T& v) const;
+
+  /// @}
+  //-----------------------------------------------------------
+
+private:
+
+  [[noreturn]] void error(char const* what) const;
+
+  token value();
+  void  read_string();
+  void  read_unicode();
+  void  read_number();
+  void  read_literal(char const* word, std::size_t n);
+  void  skip_space();
+
+  char const*       first_;
+  char const*       last_;
+  char const*       p_;             // Next character
+  char const*       token_begin_;
+  token             token_;
+  std::vector<char> stack_;         // Open containers:  '{' or '['
+  bool              after_value_;   // Expect ',' or a closing bracket
+  bool              in_member_;     // Expect the value of a key
+  char const*       str_;
+  std::size_t       str_size_;
+  std::string       unescaped_;     // String with escapes decoded
+  bool              bool_;
+  bool              integer_;
+};
+
+//---------------------------------------------------------------------------
+/// @brief  Key and destination of a value to extract.
+///
+/// The destination may be `bool`, an arithmetic type, `std::string`,
+/// a `std::vector` of these, or `nlohmann::json` for any value.  The
+/// key may be a path through nested objects, such as `"log.level"`.
+class field
+{
+public:
+
+  /// @brief  Constructor.
+  /// @param  [in]  path    Key, or keys separated by `.`.
+  /// @param  [out] target  Assigned the value if it has a matching type.
+  template<typename T>
+  field(char const* path, T& target)
+  : path_(path)
+  , size_(std::strlen(path))
+  , target_(&target)
+  , read_(&field::read<T>)
+  {}
+
+  /// Returns the path of the field.
+  char const* path() const    { return path_; }
+
+  /// @brief  Reads the value that begins with the current token of @a r
+  ///         into the target.
+  /// @return `false` if the value has the wrong type, in which case it
+  ///         is skipped and the target is unchanged.
+  bool read(reader& r) const  { return read_(r, target_); }
+
+  /// Returns `true` if the path of the field is @a path.
+  bool
+  matches(char const* path, std::size_t size) const
+  {
+    return ((size == size_) && (std::memcmp(path, path_, size) == 0));
+  }
+
+  /// Returns `true` if the path of the field is within @a path.
+  bool
+  within(char const* path, std::size_t size) const
+  {
+    return ((size < size_) && (path_[size] == '.') &&
+            (std::memcmp(path, path_, size) == 0));
+  }
+
+private:
+
+  template<typename T>
+  static bool read(reader& r, void* target);
+
+  char const* path_;
+  std::size_t size_;
+  void*       target_;
+  bool      (*read_)(reader&, void*);
+};
+
+/// @brief  Assigns the values of the listed fields from a JSON object in
+///         one pass, without building a document.
+/// @param  [in]  first   Beginning of JSON text.
+/// @param  [in]  last    End of JSON text.
+/// @param  [in]  fields  Fields to extract.
+/// @return Number of values assigned.  A field whose key is missing or
+///         whose value has the wrong type is left unchanged.
+/// @throw  std::invalid_argument if the text is malformed.
+///
+/// Other members are skipped without being decoded, and objects are
+/// entered only if a field lies within them.
+///
+/// Example usage:
+/// ```
+///   int port = 80;
+///   std::string host;
+///   std::vector<double> gains;
+///   utl::json::extract(text, {
+///       { "host", host },
+///       { "port", port },
+///       { "filter.gains", gains } });
+/// ```
+std::size_t
+extract(char const* first, char const* last,
+        std::initializer_list<field> fields);
+
+/// @copydoc extract(char const*, char const*, std::initializer_list<field>)
+std::size_t
+extract(std::string const& text, std::initializer_list<field> fields);
+
+/// @}
+
+//===========================================================================//
+// Implementation
+
+inline
+reader::reader(char const* first, char const* last)
+: first_(first)
+, last_(last)
+, p_(first)
+, token_begin_(first)
+, token_(token::end)
+, stack_()
+, after_value_(false)
+, in_member_(false)
+, str_(first)
+, str_size_(0)
+, unescaped_()
+, bool_(false)
+, integer_(false)
+{}
+
+inline
+reader::reader(char const* text)
+: reader(text, text + std::strlen(text))
+{}
+
+inline
+reader::reader(std::string const& text)
+: reader(text.data(), text.data() + text.size())
+{}
+
+inline reader::token
+reader::next()
+{
+  skip_space();
+  token_begin_ = p_;
+
+  if (stack_.empty())
+  {
+    if (!after_value_)  { return (token_ = value()); }
+    if (p_ != last_)    { error("unexpected text after document"); }
+    return (token_ = token::end);
+  }
+
+  char const close = ((stack_.back() == '{') ? '}' : ']');
+  if (after_value_)
+  {
+    if (p_ == last_)  { error("unexpected end"); }
+    if (*p_ == close)
+    {
+      ++p_;
+      stack_.pop_back();
+      return (token_ = ((close == '}') ? token::object_end
+                                       : token::array_end));
+    }
+    if (*p_ != ',')   { error("expected ',' or closing bracket"); }
+    ++p_;
+    skip_space();
+    token_begin_ = p_;
+    after_value_ = false;
+  }
+  else if (!in_member_ && (p_ != last_) && (*p_ == close))
+  {
+    // Empty container
+    ++p_;
+    stack_.pop_back();
+    after_value_ = true;
+    return (token_ = ((close == '}') ? token::object_end
+                                     : token::array_end));
+  }
+  if ((close == ']') || in_member_)
+  {
+    in_member_ = false;
+    return (token_ = value());
+  }
+
+  // Member name
+  if ((p_ == last_) || (*p_ != '"'))  { error("expected key"); }
+  read_string();
+  skip_space();
+  if ((p_ == last_) || (*p_ != ':'))  { error("expected ':'"); }
+  ++p_;
+  in_member_ = true;
+  return (token_ = token::key);
+}
+
+inline void
+reader::skip()
+{
+  if (token_ == token::key) { next(); }
+  if ((token_ == token::object_begin) || (token_ == token::array_begin))
+  {
+    std::size_t const depth = stack_.size();
+    while (stack_.size() >= depth) { next(); }
+  }
+}
+
+template<typename T>
+inline typename std::enable_if<std::is_integral<T>::value, bool>::type
+reader::number(T& v) const
+{
+  if (!integer_) { return false; }
+  char const* p = str_;
+  char const* const end = str_ + str_size_;
+  bool const negative = (*p == '-');
+  if (negative) { ++p; }
+  std::uint64_t u = 0;
+  for (; p != end; ++p)
+  {
+    std::uint64_t const d = static_cast<std::uint64_t>(*p - '0');
+    if (u > ((std::numeric_limits<std::uint64_t>::max() - d) / 10))
+    {
+      return false;
+    }
+    u = (u * 10) + d;
+  }
+  if (negative)
+  {
+    if (u == 0) { v = 0; return true; }
+    std::uint64_t const limit = std::is_signed<T>::value
+        ? (static_cast<std::uint64_t>(std::numeric_limits<T>::max()) + 1)
+        : 0;
+    if (u > limit) { return false; }
+    v = static_cast<T>(-static_cast<std::int64_t>(u - 1) - 1);
+    return true;
+  }
+  if (u > static_cast<std::uint64_t>(std::numeric_limits<T>::max()))
+  {
+    return false;
+  }
+  v = static_cast<T>(u);
+  return true;
+}
+
+template<typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value, bool>::type
+reader::number(T& v) const
+{
+  // strtod() needs a terminated copy; numbers are short.
+  char buf[64];
+  std::string long_number;
+  char const* s = buf;
+  if (str_size_ < sizeof(buf))
+  {
+    std::memcpy(buf, str_, str_size_);
+    buf[str_size_] = '\0';
+  }
+  else
+  {
+    long_number.assign(str_, str_size_);
+    s = long_number.c_str();
+  }
+  // Overflow gives infinity.  Underflow, though it sets ERANGE, gives
+  // a subnormal or zero, which is accepted.
+  double const d = std::strtod(s, nullptr);
+  if (std::isinf(d) ||
+      (d >  std::numeric_limits<T>::max()) ||
+      (d < -std::numeric_limits<T>::max()))
+  {
+    return false;
+  }
+  v = static_cast<T>(d);
+  return true;
+}
+
+// private ----------------------------------------------------
+
+inline void
+reader::error(char const* what) const
+{
+  throw std::invalid_argument(std::string("utl::json: ") + what +
+                              " at offset " + std::to_string(p_ - first_));
+}
+
+inline reader::token
+reader::value()
+{
+  if (p_ == last_) { error("unexpected end"); }
+  after_value_ = true;
+  switch (*p_)
+  {
+  case '{':
+  case '[':
+    stack_.push_back(*p_);
+    ++p_;
+    after_value_ = false;
+    return ((stack_.back() == '{') ? token::object_begin
+                                   : token::array_begin);
+  case '"':
+    read_string();
+    return token::string;
+  case 't':
+    read_literal("true", 4);
+    bool_ = true;
+    return token::boolean;
+  case 'f':
+    read_literal("false", 5);
+    bool_ = false;
+    return token::boolean;
+  case 'n':
+    read_literal("null", 4);
+    return token::null;
+  default:
+    read_number();
+    return token::number;
+  }
+}
+
+inline void
+reader::read_string()
+{
+  char const* const begin = ++p_;
+  while ((p_ != last_) && (*p_ != '"') && (*p_ != '\\'))
+  {
+    if (static_cast<unsigned char>(*p_) < 0x20)
+    {
+      error("control character in string");
+    }
+    ++p_;
+  }
+  if (p_ == last_) { error("unterminated string"); }
+  if (*p_ == '"')
+  {
+    str_ = begin;
+    str_size_ = static_cast<std::size_t>(p_ - begin);
+    ++p_;
+    return;
+  }
+
+  // Decode escape sequences into the reused buffer.
+  unescaped_.assign(begin, p_);
+  for (;;)
+  {
+    if (p_ == last_) { error("unterminated string"); }
+    char const c = *p_++;
+    if (c == '"') { break; }
+    if (static_cast<unsigned char>(c) < 0x20)
+    {
+      error("control character in string");
+    }
+    if (c != '\\')
+    {
+      unescaped_ += c;
+      continue;
+    }
+    if (p_ == last_) { error("unterminated string"); }
+    switch (*p_++)
+    {
+    case '"':   unescaped_ += '"';    break;
+    case '\\':  unescaped_ += '\\';   break;
+    case '/':   unescaped_ += '/';    break;
+    case 'b':   unescaped_ += '\b';   break;
+    case 'f':   unescaped_ += '\f';   break;
+    case 'n':   unescaped_ += '\n';   break;
+    case 'r':   unescaped_ += '\r';   break;
+    case 't':   unescaped_ += '\t';   break;
+    case 'u':   read_unicode();       break;
+    default:    error("invalid escape sequence");
+    }
+  }
+  str_ = unescaped_.data();
+  str_size_ = unescaped_.size();
+}
+
+// Decodes the code point of a \u escape, or a surrogate pair of them,
+// and appends it as UTF-8.
+inline void
+reader::read_unicode()
+{
+  auto hex4 = [this]() -> std::uint32_t
+  {
+    if ((last_ - p_) < 4) { error("invalid \\u escape"); }
+    std::uint32_t u = 0;
+    for (int i = 0; i != 4; ++i)
+    {
+      char const c = *p_++;
+      u <<= 4;
+      if      ((c >= '0') && (c <= '9'))  { u |= (c - '0'); }
+      else if ((c >= 'a') && (c <= 'f'))  { u |= (c - 'a' + 10); }
+      else if ((c >= 'A') && (c <= 'F'))  { u |= (c - 'A' + 10); }
+      else { error("invalid \\u escape"); }
+    }
+    return u;
+  };
+
+  std::uint32_t cp = hex4();
+  if ((cp >= 0xD800) && (cp <= 0xDBFF))
+  {
+    if (((last_ - p_) < 2) || (p_[0] != '\\') || (p_[1] != 'u'))
+    {
+      error("missing low surrogate");
+    }
+    p_ += 2;
+    std::uint32_t const low = hex4();
+    if ((low < 0xDC00) || (low > 0xDFFF)) { error("invalid low surrogate"); }
+    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+  }
+  else if ((cp >= 0xDC00) && (cp <= 0xDFFF))
+  {
+    error("unexpected low surrogate");
+  }
+
+  if (cp < 0x80)
+  {
+    unescaped_ += static_cast<char>(cp);
+  }
+  else if (cp < 0x800)
+  {
+    unescaped_ += static_cast<char>(0xC0 | (cp >> 6));
+    unescaped_ += static_cast<char>(0x80 | (cp & 0x3F));
+  }
+  else if (cp < 0x10000)
+  {
+    unescaped_ += static_cast<char>(0xE0 | (cp >> 12));
+    unescaped_ += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    unescaped_ += static_cast<char>(0x80 | (cp & 0x3F));
+  }
+  else
+  {
+    unescaped_ += static_cast<char>(0xF0 | (cp >> 18));
+    unescaped_ += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+    unescaped_ += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    unescaped_ += static_cast<char>(0x80 | (cp & 0x3F));
+  }
+}
+
+inline void
+reader::read_number()
+{
+  auto digit = [this]() { return ((p_ != last_) && (*p_ >= '0') && (*p_ <= '9')); };
+
+  char const* const begin = p_;
+  integer_ = true;
+  if (*p_ == '-') { ++p_; }
+  if (!digit()) { error("unexpected character"); }
+  if (*p_ == '0') { ++p_; }
+  else            { while (digit()) { ++p_; } }
+  if ((p_ != last_) && (*p_ == '.'))
+  {
+    integer_ = false;
+    ++p_;
+    if (!digit()) { error("invalid number"); }
+    while (digit()) { ++p_; }
+  }
+  if ((p_ != last_) && ((*p_ == 'e') || (*p_ == 'E')))
+  {
+    integer_ = false;
+    ++p_;
+    if ((p_ != last_) && ((*p_ == '+') || (*p_ == '-'))) { ++p_; }
+    if (!digit()) { error("invalid number"); }
+    while (digit()) { ++p_; }
+  }
+  str_ = begin;
+  str_size_ = static_cast<std::size_t>(p_ - begin);
+}
+
+inline void
+reader::read_literal(char const* word, std::size_t n)
+{
+  if ((static_cast<std::size_t>(last_ - p_) < n) ||
+      (std::memcmp(p_, word, n) != 0))
+  {
+    error("unexpected character");
+  }
+  p_ += n;
+}
+
+inline void
+reader::skip_space()
+{
+  while ((p_ != last_) &&
+         ((*p_ == ' ') || (*p_ == '\n') || (*p_ == '\r') || (*p_ == '\t')))
+  {
+    ++p_;
+  }
+}
+
+//---------------------------------------------------------------------------
+
+namespace detail {  //-------------------------------------------------------
+
+// Each overload reads the value that begins with the current token,
+// and returns false, skipping the value, if its type does not match.
+
+inline bool
+read_value(reader& r, bool& v)
+{
+  if (r.current() != reader::token::boolean) { r.skip(); return false; }
+  v = r.boolean();
+  return true;
+}
+
+inline bool
+read_value(reader& r, std::string& v)
+{
+  if (r.current() != reader::token::string) { r.skip(); return false; }
+  v.assign(r.data(), r.size());
+  return true;
+}
+
+template<typename T>
+inline typename std::enable_if<std::is_arithmetic<T>::value &&
+                               !std::is_same<T, bool>::value, bool>::type
+read_value(reader& r, T& v)
+{
+  if (r.current() != reader::token::number) { r.skip(); return false; }
+  return r.number(v);
+}
+
+template<typename Json>
+inline auto
+read_value(reader& r, Json& v) -> decltype(Json::parse(std::string()), true)
+{
+  char const* const begin = r.token_begin();
+  r.skip();
+  v = Json::parse(std::string(begin, r.position()));
+  return true;
+}
+
+template<typename T, typename Allocator>
+inline bool
+read_value(reader& r, std::vector<T, Allocator>& v)
+{
+  if (r.current() != reader::token::array_begin) { r.skip(); return false; }
+  std::vector<T, Allocator> elements;
+  bool ok = true;
+  while (r.next() != reader::token::array_end)
+  {
+    T x{};
+    if (read_value(r, x)) { elements.push_back(std::move(x)); }
+    else                  { ok = false; }
+  }
+  if (ok) { v.swap(elements); }
+  return ok;
+}
+
+} // detail -----------------------------------------------------------------
+
+template<typename T>
+inline bool
+field::read(reader& r, void* target)
+{
+  return detail::read_value(r, *static_cast<T*>(target));
+}
+
+inline std::size_t
+extract(char const* first, char const* last,
+        std::initializer_list<field> fields)
+{
+  using token = reader::token;
+  reader r(first, last);
+  if (r.next() != token::object_begin)
+  {
+    r.skip();
+    r.next();
+    return 0;
+  }
+
+  std::size_t assigned = 0;
+  std::string path;                       // Keys to the current member
+  std::vector<std::size_t> prefix(1, 0);  // Path length of each object
+  while (!prefix.empty())
+  {
+    if (r.next() == token::object_end)
+    {
+      prefix.pop_back();
+      continue;
+    }
+
+    // Key:  find a field with its path, or within it.
+    path.resize(prefix.back());
+    if (!path.empty()) { path += '.'; }
+    path.append(r.data(), r.size());
+    field const* match = nullptr;
+    bool enter = false;
+    for (field const& f : fields)
+    {
+      if (f.matches(path.data(), path.size())) { match = &f; break; }
+      enter = (enter || f.within(path.data(), path.size()));
+    }
+
+    r.next();
+    if (match)
+    {
+      if (match->read(r)) { ++assigned; }
+    }
+    else if (enter && (r.current() == token::object_begin))
+    {
+      prefix.push_back(path.size());
+    }
+    else
+    {
+      r.skip();
+    }
+  }
+  r.next();   // Check for text after the object
+  return assigned;
+}
+
+inline std::size_t
+extract(std::string const& text, std::initializer_list<field> fields)
+{
+  return extract(text.data(), text.data() + text.size(), fields);
+}
+
+} } // utl::json
+
+#endif // UTL_JSON_READER_HPP
+//===========================================================================//
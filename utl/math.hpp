@@ -308,5 +308,12 @@ private:
 
 } } // utl::math
 
+
+//===========================================================================//
+// Modules
+
+#include <utl/math/math_batch.hpp>
+
+
 #endif // UTL_MATH_HPP
 //===========================================================================//
@@ -0,0 +1,628 @@
+/*
+Licensed under the MIT License <http://opensource.org/licenses/MIT>
+
+Copyright 2018 Nathan Lucas <nathan.lucas@wayne.edu>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+//===========================================================================//
+/// @file
+/// @brief    Batch math utility library.
+/// @details  Header-only library providing math functions applied to
+///           arrays of values in structure-of-arrays (SoA) layout.
+/// @author   Nathan Lucas
+/// @date     2018
+//===========================================================================//
+#ifndef UTL_MATH_BATCH_HPP
+#define UTL_MATH_BATCH_HPP
+
+#ifndef __cplusplus
+#error must be compiled as C++
+#endif
+
+#include <utl/math.hpp>   // utl::math scalar functions
+
+#include <cstddef>        // std::size_t
+#include <cstdint>        // std::uint32_t
+#include <cstring>        // std::memcpy
+#include <type_traits>    // std::is_arithmetic
+
+// Vector instructions are selected at compile time from the target flags
+// (e.g., `-mavx`, `-msse4.1`).  Define UTL_MATH_NO_SIMD to force the
+// portable scalar implementation.
+#if !defined(UTL_MATH_NO_SIMD)
+#  if defined(__AVX__)
+#    define UTL_MATH_SIMD_AVX
+#    include <immintrin.h>
+#  elif defined(__SSE2__) || defined(_M_X64)
+#    define UTL_MATH_SIMD_SSE
+#    include <emmintrin.h>
+#    if defined(__SSE4_1__)
+#      define UTL_MATH_SIMD_SSE4_1
+#      include <smmintrin.h>
+#    endif
+#  endif
+#endif
+
+/// @ingroup  math
+/// @defgroup math_batch  math_batch
+/// @brief    Batch math utilities.
+/// @details  Header-only library providing math functions applied to
+///           arrays of values in structure-of-arrays (SoA) layout.
+///
+/// Each batch function applies the scalar function of the same name
+/// to @a n elements.  Points are passed as separate arrays of x and
+/// y coordinates (e.g., `xs[i]`, `ys[i]` is the i-th point).
+///
+/// The `float` and `double` overloads use AVX or SSE instructions when
+/// the compiler targets them, and fall back to scalar loops otherwise.
+/// Other arithmetic types always use the scalar loop.  Input and output
+/// arrays need not be aligned.  An output array may be the same as
+/// the input array, but may not otherwise overlap it.
+///
+/// The vector `standard_deg` computes the remainder as
+/// `t - 360 * trunc(t / 360)`, which matches `std::fmod` except for
+/// `float` angles beyond about ±10⁶ degrees, where the quotient loses
+/// precision.
+
+namespace utl { namespace math {
+
+/// @addtogroup math_batch
+/// @{
+
+//---------------------------------------------------------------------------
+/// @name   Batch angle functions
+/// @{
+
+/// @brief  Normalize @a n angles to be within `[-180, 180]` degrees.
+/// @param  [in]  angles  Angles in degrees.
+/// @param  [in]  n       Number of angles.
+/// @param  [out] out     Normalized angles.
+template<typename T>
+inline void
+standard_deg(T const* angles, std::size_t n, T* out);
+
+/// @brief  Convert @a n angles from degrees to radians.
+/// @param  [in]  angles  Angles in degrees.
+/// @param  [in]  n       Number of angles.
+/// @param  [out] out     Angles in radians.
+template<typename T>
+inline void
+deg_to_rad(T const* angles, std::size_t n, double* out);
+
+/// @brief  Checks if points are within radial limit @a r.
+/// @param  [in]  xs    X coordinates.
+/// @param  [in]  ys    Y coordinates.
+/// @param  [in]  n     Number of points.
+/// @param  [in]  r     Radial limit.
+/// @param  [out] out   `true` for each point within @a r, `false` otherwise.
+/// @return Number of points within @a r.
+template<typename T>
+inline std::size_t
+in_radius(T const* xs, T const* ys, std::size_t n, T r, bool* out);
+
+/// @}
+//---------------------------------------------------------------------------
+/// @name   Batch displacement functions
+/// @{
+
+/// @brief  Squared Euclidean distance from point (@a x , @a y ) to
+///         each of @a n points.
+/// @param  [in]  xs    X coordinates.
+/// @param  [in]  ys    Y coordinates.
+/// @param  [in]  n     Number of points.
+/// @param  [in]  x     X coordinate of reference point.
+/// @param  [in]  y     Y coordinate of reference point.
+/// @param  [out] out   Squared Euclidean distances.
+template<typename T>
+inline void
+squared_distance(T const* xs, T const* ys, std::size_t n, T x, T y, T* out);
+
+/// @}
+//---------------------------------------------------------------------------
+/// @name   Batch minimum, maximum, and difference functions
+/// @{
+
+/// @brief  Applies an upper and lower bound to @a n values.
+/// @param  [in]  xs    Values for which to apply bounds.
+/// @param  [in]  n     Number of values.
+/// @param  [in]  min   Lower bound.
+/// @param  [in]  max   Upper bound.
+/// @param  [out] out   Bounded values.
+///
+/// Each value is the same as bound(x, min, max) gives, even if
+/// @a min > @a max.
+template<typename T>
+inline void
+bound(T const* xs, std::size_t n, T min, T max, T* out);
+
+/// @}
+//---------------------------------------------------------------------------
+
+/// @}
+
+
+//===========================================================================//
+// Implementation
+
+namespace detail {  //-------------------------------------------------------
+
+// Scalar fallbacks, also used for the elements remaining
+// after the last full vector register.
+
+template<typename T>
+inline void
+standard_deg_scalar(T const* angles, std::size_t n, T* out)
+{
+  for (std::size_t i = 0; i != n; ++i)
+  {
+    out[i] = utl::math::standard_deg(angles[i]);
+  }
+}
+
+template<typename T>
+inline void
+deg_to_rad_scalar(T const* angles, std::size_t n, double* out)
+{
+  for (std::size_t i = 0; i != n; ++i)
+  {
+    out[i] = utl::math::deg_to_rad(angles[i]);
+  }
+}
+
+template<typename T>
+inline std::size_t
+in_radius_scalar(T const* xs, T const* ys, std::size_t n, T r, bool* out)
+{
+  std::size_t count = 0;
+  for (std::size_t i = 0; i != n; ++i)
+  {
+    out[i] = utl::math::in_radius(xs[i], ys[i], r);
+    count += out[i];
+  }
+  return count;
+}
+
+template<typename T>
+inline void
+squared_distance_scalar(T const* xs, T const* ys, std::size_t n,
+                        T x, T y, T* out)
+{
+  for (std::size_t i = 0; i != n; ++i)
+  {
+    out[i] = utl::math::squared_distance(x, y, xs[i], ys[i]);
+  }
+}
+
+template<typename T>
+inline void
+bound_scalar(T const* xs, std::size_t n, T min, T max, T* out)
+{
+  for (std::size_t i = 0; i != n; ++i)
+  {
+    out[i] = utl::math::bound(xs[i], min, max);
+  }
+}
+
+//---------------------------------------------------------------------------
+// Vector register wrappers.
+//
+// Each pack provides the same set of static functions so the kernels
+// below are written once for every instruction set and element type.
+
+#if defined(UTL_MATH_SIMD_AVX)
+
+struct pack_f
+{
+  typedef float  value_type;
+  typedef __m256 reg;
+  static constexpr std::size_t width = 8;
+  static reg  load(float const* p)        { return _mm256_loadu_ps(p); }
+  static void store(float* p, reg a)      { _mm256_storeu_ps(p, a); }
+  static reg  set1(float v)               { return _mm256_set1_ps(v); }
+  static reg  add(reg a, reg b)           { return _mm256_add_ps(a, b); }
+  static reg  sub(reg a, reg b)           { return _mm256_sub_ps(a, b); }
+  static reg  mul(reg a, reg b)           { return _mm256_mul_ps(a, b); }
+  static reg  div(reg a, reg b)           { return _mm256_div_ps(a, b); }
+  static reg  min(reg a, reg b)           { return _mm256_min_ps(a, b); }
+  static reg  max(reg a, reg b)           { return _mm256_max_ps(a, b); }
+  static reg  trunc(reg a)  { return _mm256_round_ps(a, _MM_FROUND_TO_ZERO |
+                                                        _MM_FROUND_NO_EXC); }
+  static reg  lt(reg a, reg b)  { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+  static reg  ge(reg a, reg b)  { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+  static reg  select(reg m, reg a, reg b) { return _mm256_blendv_ps(b, a, m); }
+  static int  mask(reg m)                 { return _mm256_movemask_ps(m); }
+};
+
+struct pack_d
+{
+  typedef double  value_type;
+  typedef __m256d reg;
+  static constexpr std::size_t width = 4;
+  static reg  load(double const* p)       { return _mm256_loadu_pd(p); }
+  static void store(double* p, reg a)     { _mm256_storeu_pd(p, a); }
+  static reg  set1(double v)              { return _mm256_set1_pd(v); }
+  static reg  add(reg a, reg b)           { return _mm256_add_pd(a, b); }
+  static reg  sub(reg a, reg b)           { return _mm256_sub_pd(a, b); }
+  static reg  mul(reg a, reg b)           { return _mm256_mul_pd(a, b); }
+  static reg  div(reg a, reg b)           { return _mm256_div_pd(a, b); }
+  static reg  min(reg a, reg b)           { return _mm256_min_pd(a, b); }
+  static reg  max(reg a, reg b)           { return _mm256_max_pd(a, b); }
+  static reg  trunc(reg a)  { return _mm256_round_pd(a, _MM_FROUND_TO_ZERO |
+                                                        _MM_FROUND_NO_EXC); }
+  static reg  lt(reg a, reg b)  { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+  static reg  ge(reg a, reg b)  { return _mm256_cmp_pd(a, b, _CMP_GE_OQ); }
+  static reg  select(reg m, reg a, reg b) { return _mm256_blendv_pd(b, a, m); }
+  static int  mask(reg m)                 { return _mm256_movemask_pd(m); }
+};
+
+#elif defined(UTL_MATH_SIMD_SSE)
+
+struct pack_f
+{
+  typedef float  value_type;
+  typedef __m128 reg;
+  static constexpr std::size_t width = 4;
+  static reg  load(float const* p)        { return _mm_loadu_ps(p); }
+  static void store(float* p, reg a)      { _mm_storeu_ps(p, a); }
+  static reg  set1(float v)               { return _mm_set1_ps(v); }
+  static reg  add(reg a, reg b)           { return _mm_add_ps(a, b); }
+  static reg  sub(reg a, reg b)           { return _mm_sub_ps(a, b); }
+  static reg  mul(reg a, reg b)           { return _mm_mul_ps(a, b); }
+  static reg  div(reg a, reg b)           { return _mm_div_ps(a, b); }
+  static reg  min(reg a, reg b)           { return _mm_min_ps(a, b); }
+  static reg  max(reg a, reg b)           { return _mm_max_ps(a, b); }
+  static reg  lt(reg a, reg b)            { return _mm_cmplt_ps(a, b); }
+  static reg  ge(reg a, reg b)            { return _mm_cmpge_ps(a, b); }
+  static reg  select(reg m, reg a, reg b)
+  {
+    return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+  }
+  static int  mask(reg m)                 { return _mm_movemask_ps(m); }
+#if defined(UTL_MATH_SIMD_SSE4_1)
+  static reg  trunc(reg a)  { return _mm_round_ps(a, _MM_FROUND_TO_ZERO |
+                                                     _MM_FROUND_NO_EXC); }
+#else
+  static reg  trunc(reg a)
+  {
+    // Round magnitude to integer by adding and subtracting 2^23,
+    // step back one if that rounded up, then restore the sign.
+    reg const sign = _mm_set1_ps(-0.0f);
+    reg const big  = _mm_set1_ps(8388608.0f);
+    reg ax = _mm_andnot_ps(sign, a);
+    reg r  = _mm_sub_ps(_mm_add_ps(ax, big), big);
+    r = _mm_sub_ps(r, _mm_and_ps(_mm_cmpgt_ps(r, ax), _mm_set1_ps(1.0f)));
+    r = select(_mm_cmplt_ps(ax, big), r, ax);   // already integral
+    return _mm_or_ps(r, _mm_and_ps(a, sign));
+  }
+#endif
+};
+
+struct pack_d
+{
+  typedef double  value_type;
+  typedef __m128d reg;
+  static constexpr std::size_t width = 2;
+  static reg  load(double const* p)       { return _mm_loadu_pd(p); }
+  static void store(double* p, reg a)     { _mm_storeu_pd(p, a); }
+  static reg  set1(double v)              { return _mm_set1_pd(v); }
+  static reg  add(reg a, reg b)           { return _mm_add_pd(a, b); }
+  static reg  sub(reg a, reg b)           { return _mm_sub_pd(a, b); }
+  static reg  mul(reg a, reg b)           { return _mm_mul_pd(a, b); }
+  static reg  div(reg a, reg b)           { return _mm_div_pd(a, b); }
+  static reg  min(reg a, reg b)           { return _mm_min_pd(a, b); }
+  static reg  max(reg a, reg b)           { return _mm_max_pd(a, b); }
+  static reg  lt(reg a, reg b)            { return _mm_cmplt_pd(a, b); }
+  static reg  ge(reg a, reg b)            { return _mm_cmpge_pd(a, b); }
+  static reg  select(reg m, reg a, reg b)
+  {
+    return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b));
+  }
+  static int  mask(reg m)                 { return _mm_movemask_pd(m); }
+#if defined(UTL_MATH_SIMD_SSE4_1)
+  static reg  trunc(reg a)  { return _mm_round_pd(a, _MM_FROUND_TO_ZERO |
+                                                     _MM_FROUND_NO_EXC); }
+#else
+  static reg  trunc(reg a)
+  {
+    // Round magnitude to integer by adding and subtracting 2^52,
+    // step back one if that rounded up, then restore the sign.
+    reg const sign = _mm_set1_pd(-0.0);
+    reg const big  = _mm_set1_pd(4503599627370496.0);
+    reg ax = _mm_andnot_pd(sign, a);
+    reg r  = _mm_sub_pd(_mm_add_pd(ax, big), big);
+    r = _mm_sub_pd(r, _mm_and_pd(_mm_cmpgt_pd(r, ax), _mm_set1_pd(1.0)));
+    r = select(_mm_cmplt_pd(ax, big), r, ax);   // already integral
+    return _mm_or_pd(r, _mm_and_pd(a, sign));
+  }
+#endif
+};
+
+#endif
+
+#if defined(UTL_MATH_SIMD_AVX) || defined(UTL_MATH_SIMD_SSE)
+
+// Returns the index of the first element not processed.
+
+template<typename P>
+inline std::size_t
+standard_deg_simd(typename P::value_type const* angles, std::size_t n,
+                  typename P::value_type* out)
+{
+  typedef typename P::reg reg;
+  // Same as the scalar function:  the half turn is added for
+  // non-negative angles and subtracted for negative angles before
+  // taking the remainder, then removed again afterward.
+  reg const zero = P::set1(0);
+  reg const full = P::set1(360);
+  reg const pos  = P::set1(180);
+  reg const neg  = P::set1(-180);
+  std::size_t i = 0;
+  for (; (i + P::width) <= n; i += P::width)
+  {
+    reg a    = P::load(angles + i);
+    reg half = P::select(P::ge(a, zero), pos, neg);
+    reg t    = P::add(a, half);
+    reg q    = P::trunc(P::div(t, full));   // fmod(t, ±360)
+    P::store(out + i, P::sub(P::sub(t, P::mul(q, full)), half));
+  }
+  return i;
+}
+
+// Expands the low @a width bits of movemask result @a m to one bool
+// per lane, four lanes at a time.  Returns the number of bits set.
+inline std::size_t
+store_mask(bool* out, int m, std::size_t width)
+{
+  static_assert(sizeof(bool) == 1, "bool must be one byte");
+  static std::uint32_t const lanes[16] = {
+    0x00000000, 0x00000001, 0x00000100, 0x00000101,
+    0x00010000, 0x00010001, 0x00010100, 0x00010101,
+    0x01000000, 0x01000001, 0x01000100, 0x01000101,
+    0x01010000, 0x01010001, 0x01010100, 0x01010101 };
+  std::size_t count = 0;
+  for (std::size_t k = 0; k < width; k += 4)
+  {
+    std::uint32_t bytes = lanes[(m >> k) & 0xF];
+    std::memcpy(out + k, &bytes, (width < 4) ? width : 4);
+    count += ((bytes * 0x01010101u) >> 24);
+  }
+  return count;
+}
+
+template<typename P>
+inline std::size_t
+in_radius_simd(typename P::value_type const* xs,
+               typename P::value_type const* ys, std::size_t n,
+               typename P::value_type r, bool* out, std::size_t& count)
+{
+  typedef typename P::reg reg;
+  reg const rr = P::set1(r * r);
+  std::size_t i = 0;
+  for (; (i + P::width) <= n; i += P::width)
+  {
+    reg x = P::load(xs + i);
+    reg y = P::load(ys + i);
+    int m = P::mask(P::lt(P::add(P::mul(x, x), P::mul(y, y)), rr));
+    count += store_mask(out + i, m, P::width);
+  }
+  return i;
+}
+
+template<typename P>
+inline std::size_t
+squared_distance_simd(typename P::value_type const* xs,
+                      typename P::value_type const* ys, std::size_t n,
+                      typename P::value_type x, typename P::value_type y,
+                      typename P::value_type* out)
+{
+  typedef typename P::reg reg;
+  reg const x0 = P::set1(x);
+  reg const y0 = P::set1(y);
+  std::size_t i = 0;
+  for (; (i + P::width) <= n; i += P::width)
+  {
+    reg dx = P::sub(P::load(xs + i), x0);
+    reg dy = P::sub(P::load(ys + i), y0);
+    P::store(out + i, P::add(P::mul(dx, dx), P::mul(dy, dy)));
+  }
+  return i;
+}
+
+template<typename P>
+inline std::size_t
+bound_simd(typename P::value_type const* xs, std::size_t n,
+           typename P::value_type min, typename P::value_type max,
+           typename P::value_type* out)
+{
+  typedef typename P::reg reg;
+  // min(max, max(min, x)) matches the scalar function only if
+  // min <= max; otherwise leave every value to the scalar loop.
+  if (!(min <= max)) { return 0; }
+  reg const lo = P::set1(min);
+  reg const hi = P::set1(max);
+  std::size_t i = 0;
+  for (; (i + P::width) <= n; i += P::width)
+  {
+    // Operand order passes NaN through, as the scalar function does.
+    P::store(out + i, P::min(hi, P::max(lo, P::load(xs + i))));
+  }
+  return i;
+}
+
+inline std::size_t
+deg_to_rad_simd(double const* angles, std::size_t n, double* out)
+{
+  typedef pack_d P;
+  P::reg const k   = P::set1(utl::math::pi);
+  P::reg const deg = P::set1(180);
+  std::size_t i = 0;
+  for (; (i + P::width) <= n; i += P::width)
+  {
+    P::store(out + i, P::div(P::mul(P::load(angles + i), k), deg));
+  }
+  return i;
+}
+
+#endif
+
+//---------------------------------------------------------------------------
+// Dispatch by element type.  Only `float` and `double` have vector paths.
+
+template<typename T>
+struct batch
+{
+  static void
+  standard_deg(T const* a, std::size_t n, T* out)
+  {
+    standard_deg_scalar(a, n, out);
+  }
+
+  static void
+  deg_to_rad(T const* a, std::size_t n, double* out)
+  {
+    deg_to_rad_scalar(a, n, out);
+  }
+
+  static std::size_t
+  in_radius(T const* xs, T const* ys, std::size_t n, T r, bool* out)
+  {
+    return in_radius_scalar(xs, ys, n, r, out);
+  }
+
+  static void
+  squared_distance(T const* xs, T const* ys, std::size_t n,
+                   T x, T y, T* out)
+  {
+    squared_distance_scalar(xs, ys, n, x, y, out);
+  }
+
+  static void
+  bound(T const* xs, std::size_t n, T min, T max, T* out)
+  {
+    bound_scalar(xs, n, min, max, out);
+  }
+};
+
+#if defined(UTL_MATH_SIMD_AVX) || defined(UTL_MATH_SIMD_SSE)
+
+template<typename T, typename P>
+struct batch_simd
+{
+  static void
+  standard_deg(T const* a, std::size_t n, T* out)
+  {
+    std::size_t i = standard_deg_simd<P>(a, n, out);
+    standard_deg_scalar(a + i, n - i, out + i);
+  }
+
+  static std::size_t
+  in_radius(T const* xs, T const* ys, std::size_t n, T r, bool* out)
+  {
+    std::size_t count = 0;
+    std::size_t i = in_radius_simd<P>(xs, ys, n, r, out, count);
+    return count + in_radius_scalar(xs + i, ys + i, n - i, r, out + i);
+  }
+
+  static void
+  squared_distance(T const* xs, T const* ys, std::size_t n,
+                   T x, T y, T* out)
+  {
+    std::size_t i = squared_distance_simd<P>(xs, ys, n, x, y, out);
+    squared_distance_scalar(xs + i, ys + i, n - i, x, y, out + i);
+  }
+
+  static void
+  bound(T const* xs, std::size_t n, T min, T max, T* out)
+  {
+    std::size_t i = bound_simd<P>(xs, n, min, max, out);
+    bound_scalar(xs + i, n - i, min, max, out + i);
+  }
+};
+
+template<>
+struct batch<float> : batch_simd<float, pack_f>
+{
+  static void
+  deg_to_rad(float const* a, std::size_t n, double* out)
+  {
+    deg_to_rad_scalar(a, n, out);
+  }
+};
+
+template<>
+struct batch<double> : batch_simd<double, pack_d>
+{
+  static void
+  deg_to_rad(double const* a, std::size_t n, double* out)
+  {
+    std::size_t i = deg_to_rad_simd(a, n, out);
+    deg_to_rad_scalar(a + i, n - i, out + i);
+  }
+};
+
+#endif
+
+} // detail -----------------------------------------------------------------
+
+
+template<typename T>
+inline void
+standard_deg(T const* angles, std::size_t n, T* out)
+{
+  static_assert(std::is_arithmetic<T>::value, "T must be numeric");
+  detail::batch<T>::standard_deg(angles, n, out);
+}
+
+template<typename T>
+inline void
+deg_to_rad(T const* angles, std::size_t n, double* out)
+{
+  static_assert(std::is_arithmetic<T>::value, "T must be numeric");
+  detail::batch<T>::deg_to_rad(angles, n, out);
+}
+
+template<typename T>
+inline std::size_t
+in_radius(T const* xs, T const* ys, std::size_t n, T r, bool* out)
+{
+  static_assert(std::is_arithmetic<T>::value, "T must be numeric");
+  return detail::batch<T>::in_radius(xs, ys, n, r, out);
+}
+
+template<typename T>
+inline void
+squared_distance(T const* xs, T const* ys, std::size_t n, T x, T y, T* out)
+{
+  static_assert(std::is_arithmetic<T>::value, "T must be numeric");
+  detail::batch<T>::squared_distance(xs, ys, n, x, y, out);
+}
+
+template<typename T>
+inline void
+bound(T const* xs, std::size_t n, T min, T max, T* out)
+{
+  static_assert(std::is_arithmetic<T>::value, "T must be numeric");
+  detail::batch<T>::bound(xs, n, min, max, out);
+}
+
+} } // utl::math
+
+#endif // UTL_MATH_BATCH_HPP
+//===========================================================================//
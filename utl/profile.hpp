@@ -0,0 +1,681 @@
+/*
+Licensed under the MIT License <http://opensource.org/licenses/MIT>
+
+Copyright 2018 Nathan Lucas <nathan.lucas@wayne.edu>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+//===========================================================================//
+/// @file
+/// @brief    Scoped profiling zones.
+/// @details  Header-only library providing scoped timing instrumentation,
+///           hierarchical timing reports, and Chrome trace export.
+/// @author   Nathan Lucas
+/// @date     2018
+//===========================================================================//
+#ifndef UTL_PROFILE_HPP
+#define UTL_PROFILE_HPP
+
+#ifndef __cplusplus
+#error must be compiled as C++
+#endif
+
+// The profiling functions are declared even if UTL_PROFILE is not defined,
+// so code that writes a trace compiles either way; chrome_trace needs json.
+#include <utl/chrono/chrono_tsc_clock.hpp>  // utl::chrono::tsc_clock
+#include <utl/json.hpp>                     // utl::json::json
+#include <utl/statistics.hpp>               // utl::quantile_histogram
+
+#include <algorithm>    // std::sort
+#include <atomic>       // std::atomic
+#include <chrono>       // std::chrono::nanoseconds
+#include <cstddef>      // std::size_t
+#include <cstdint>      // INT64_MAX, std::int64_t, std::uint64_t
+#include <iomanip>      // std::setw
+#include <map>          // std::map
+#include <memory>       // std::unique_ptr
+#include <mutex>        // std::lock_guard, std::mutex
+#include <ostream>      // std::ostream
+#include <string>       // std::string
+#include <vector>       // std::vector
+
+/// @defgroup utl_profile  profile
+/// @brief    Scoped profiling zones.
+/// @details  Header-only library providing scoped timing instrumentation,
+///   hierarchical timing reports, and Chrome trace export.
+///
+/// Zones are marked with UTL_PROFILE_SCOPE, which records the begin and
+/// end time of the enclosing scope.  Each thread appends records to its
+/// own buffer, so recording takes no lock.  Nested zones form a tree per
+/// thread, which utl::profile::report aggregates into count, total,
+/// minimum, maximum, and median and 99th percentile durations.
+///
+/// Profiling is enabled by defining `UTL_PROFILE` before including this
+/// header.  Otherwise the macros expand to nothing and no time is
+/// recorded.  The profiling functions are still declared, and return
+/// empty results.
+///
+/// Each thread keeps at most `UTL_PROFILE_MAX_EVENTS` zones (2^18, about
+/// 8 MiB, unless defined otherwise), so an always-on profiler uses bounded
+/// memory.  Zones that end once a thread's buffer is full are counted as
+/// dropped until utl::profile::clear is called.
+///
+/// The zones of a thread that has exited stay in reports until they have
+/// been read by utl::profile::report or utl::profile::chrome_trace, or
+/// discarded by utl::profile::clear.  Its buffer is then reused by the
+/// next thread to record a zone, so short-lived threads add no memory as
+/// long as their zones are read.
+///
+/// Example usage:
+/// ```
+///   #define UTL_PROFILE
+///   #include <utl/profile.hpp>
+///
+///   void frame()
+///   {
+///     UTL_PROFILE_SCOPE("frame");
+///     {
+///       UTL_PROFILE_SCOPE("draw");
+///       draw();
+///     }
+///   }
+///
+///   int main()
+///   {
+///     UTL_PROFILE_THREAD("main");
+///     for (int i = 0; i != 100; ++i) { frame(); }
+///     std::cout << utl::profile::report();
+///     std::ofstream("trace.json") << utl::profile::chrome_trace();
+///   }
+/// ```
+/// The trace file opens in `chrome://tracing` or https://ui.perfetto.dev.
+
+//---------------------------------------------------------------------------
+/// @name Profiling Macros
+/// @{
+
+#if defined(UTL_PROFILE)
+
+#define UTL_PROFILE_CONCAT_(a, b)   a##b
+#define UTL_PROFILE_CONCAT(a, b)    UTL_PROFILE_CONCAT_(a, b)
+
+/// @brief  Records the enclosing scope as a zone named @a name.
+///
+/// @a name must be a string literal, or another string with static
+/// storage duration.
+#define UTL_PROFILE_SCOPE(name) \
+  ::utl::profile::scope UTL_PROFILE_CONCAT(utl_profile_scope_, __LINE__)(name)
+
+/// Records the enclosing function as a zone.
+#define UTL_PROFILE_FUNCTION()    UTL_PROFILE_SCOPE(__func__)
+
+/// Names the calling thread in reports and traces.
+#define UTL_PROFILE_THREAD(name)  ::utl::profile::thread_name(name)
+
+#else
+
+#define UTL_PROFILE_SCOPE(name)   ((void)0)
+#define UTL_PROFILE_FUNCTION()    ((void)0)
+#define UTL_PROFILE_THREAD(name)  ((void)0)
+
+#endif
+
+#if !defined(UTL_PROFILE_MAX_EVENTS)
+/// Maximum number of zones recorded per thread.
+#define UTL_PROFILE_MAX_EVENTS  (1 << 18)
+#endif
+
+/// @}
+//---------------------------------------------------------------------------
+
+namespace utl { namespace profile {
+
+/// @addtogroup utl_profile
+/// @{
+
+/// Duration type of profiling results.
+typedef std::chrono::nanoseconds nanoseconds;
+
+//---------------------------------------------------------------------------
+/// @brief  Records the lifetime of a scope as a profiling zone.
+///
+/// Usually created by UTL_PROFILE_SCOPE.
+class scope
+{
+public:
+
+  /// @brief  Begins a zone.
+  /// @param  [in]  name  Zone name, with static storage duration.
+  explicit
+  scope(char const* name);
+
+  /// Ends the zone.
+  ~scope();
+
+  scope(scope const&) = delete;
+  scope& operator=(scope const&) = delete;
+
+private:
+  char const*   name_;
+  std::int64_t  begin_;
+};
+
+//---------------------------------------------------------------------------
+/// @brief  Timing statistics of a profiling zone.
+struct zone_stats
+{
+  std::string   thread;   ///< Thread name.
+  std::string   name;     ///< Zone name.
+  unsigned      depth;    ///< Nesting depth; `0` for top-level zones.
+  std::size_t   count;    ///< Number of times the zone was entered.
+  nanoseconds   total;    ///< Total duration.
+  nanoseconds   min;      ///< Minimum duration.
+  nanoseconds   max;      ///< Maximum duration.
+  nanoseconds   p50;      ///< Median duration.
+  nanoseconds   p99;      ///< 99th percentile duration.
+  std::uint64_t dropped;  ///< Zones of the thread dropped when its
+                          ///< buffer was full.
+};
+
+/// @brief  Hierarchical timing report.
+///
+/// Zones are listed depth-first per thread, each followed by the
+/// zones nested inside it, in order of first entry.
+typedef std::vector<zone_stats> report_type;
+
+//---------------------------------------------------------------------------
+/// @name Profiling Functions
+/// @{
+
+/// @brief  Names the calling thread in reports and traces.
+/// @param  [in]  name  Thread name.
+inline void
+thread_name(std::string const& name);
+
+/// @brief  Aggregates the zones recorded so far by all threads.
+///
+/// May be called while other threads are recording; zones that
+/// end during the call may or may not be included.  Zones nested in a
+/// zone that has not yet ended are included once it ends.
+inline report_type
+report();
+
+/// @brief  Returns the zones recorded so far as Chrome trace events.
+///
+/// The result is a JSON object with a `traceEvents` array of complete
+/// (`"ph": "X"`) events, with timestamps and durations in microseconds,
+/// and a thread name metadata event per thread.
+inline utl::json::json
+chrome_trace();
+
+/// @brief  Discards all recorded zones.
+///
+/// Must not be called while any thread is inside a zone.
+inline void
+clear();
+
+/// @}
+//---------------------------------------------------------------------------
+/// @name Output Operators
+/// @{
+
+/// @brief  Writes a report as an indented table with durations in
+///         microseconds.
+inline std::ostream&
+operator<<(std::ostream& os, report_type const& r);
+
+/// @}
+//---------------------------------------------------------------------------
+
+/// @}
+
+
+//===========================================================================//
+// Implementation
+
+namespace detail {  //-------------------------------------------------------
+
+// One completed zone.
+struct zone_event
+{
+  char const*   name;
+  std::int64_t  begin;    // tsc_clock nanoseconds
+  std::int64_t  end;
+  unsigned      depth;
+};
+
+// Fixed-size block of events, appended by one thread and read by any.
+struct event_block
+{
+  static constexpr std::size_t capacity = 4096;
+  static constexpr std::size_t max_blocks =
+      ((UTL_PROFILE_MAX_EVENTS) + capacity - 1) / capacity;
+
+  zone_event                    events[capacity];
+  std::atomic<std::size_t>      size{0};
+  std::atomic<event_block*>     next{nullptr};
+};
+
+// Events recorded by one thread.
+class thread_log
+{
+public:
+
+  explicit
+  thread_log(unsigned id)
+  : id_(id)
+  , name_("thread " + std::to_string(id))
+  , state_(active)
+  , depth_(0)
+  , dropped_(0)
+  , blocks_(1)
+  , head_(new event_block)
+  , tail_(head_)
+  {}
+
+  ~thread_log()
+  {
+    for (event_block* b = head_; b != nullptr; )
+    {
+      event_block* next = b->next.load(std::memory_order_relaxed);
+      delete b;
+      b = next;
+    }
+  }
+
+  thread_log(thread_log const&) = delete;
+  thread_log& operator=(thread_log const&) = delete;
+
+  // Owner thread only.
+  unsigned
+  enter()     { return depth_++; }
+
+  // Owner thread only:  publishes a completed zone.
+  void
+  leave(char const* name, std::int64_t begin, std::int64_t end)
+  {
+    --depth_;
+    std::size_t n = tail_->size.load(std::memory_order_relaxed);
+    if (n == event_block::capacity)
+    {
+      if (blocks_ == event_block::max_blocks)
+      {
+        dropped_.store(dropped_.load(std::memory_order_relaxed) + 1,
+                       std::memory_order_relaxed);
+        return;
+      }
+      ++blocks_;
+      event_block* b = new event_block;
+      tail_->next.store(b, std::memory_order_release);
+      tail_ = b;
+      n = 0;
+    }
+    zone_event& e = tail_->events[n];
+    e.name  = name;
+    e.begin = begin;
+    e.end   = end;
+    e.depth = depth_;
+    tail_->size.store(n + 1, std::memory_order_release);
+  }
+
+  // Any thread:  copies the events published so far.
+  void
+  copy(std::vector<zone_event>& out) const
+  {
+    for (event_block const* b = head_; b != nullptr;
+         b = b->next.load(std::memory_order_acquire))
+    {
+      std::size_t const n = b->size.load(std::memory_order_acquire);
+      out.insert(out.end(), b->events, b->events + n);
+    }
+  }
+
+  // Any thread:  number of zones not recorded because the log was full.
+  std::uint64_t
+  dropped() const   { return dropped_.load(std::memory_order_relaxed); }
+
+  // No zones may be active.
+  void
+  clear()
+  {
+    for (event_block* b = head_->next.load(std::memory_order_relaxed);
+         b != nullptr; )
+    {
+      event_block* next = b->next.load(std::memory_order_relaxed);
+      delete b;
+      b = next;
+    }
+    head_->next.store(nullptr, std::memory_order_relaxed);
+    head_->size.store(0, std::memory_order_release);
+    tail_ = head_;
+    blocks_ = 1;
+    dropped_.store(0, std::memory_order_relaxed);
+  }
+
+  // Any thread:  true if no zone has been published.
+  bool
+  empty() const
+  {
+    return (head_->size.load(std::memory_order_acquire) == 0);
+  }
+
+  // Whether the owner thread is running, has exited, or has exited and
+  // its zones have been read.
+  enum state_type { active, finished, reusable };
+
+  unsigned      id_;
+  std::string   name_;    // guarded by registry mutex
+  state_type    state_;   // guarded by registry mutex
+
+private:
+  unsigned                    depth_;
+  std::atomic<std::uint64_t>  dropped_;   // written by the owner only
+  std::size_t                 blocks_;
+  event_block*  head_;
+  event_block*  tail_;
+};
+
+// Logs of all threads that have recorded a zone.  A log outlives its
+// thread until its zones have been read, then is reused by a new thread.
+class registry
+{
+public:
+
+  static registry&
+  instance()
+  {
+    static registry r;
+    return r;
+  }
+
+  // Returns a log for the calling thread, reusing a released one if any.
+  thread_log*
+  add()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!free_.empty())
+    {
+      thread_log* log = free_.back();
+      free_.pop_back();
+      log->clear();
+      log->name_  = "thread " + std::to_string(log->id_);
+      log->state_ = thread_log::active;
+      return log;
+    }
+    logs_.emplace_back(new thread_log(static_cast<unsigned>(logs_.size())));
+    return logs_.back().get();
+  }
+
+  // Called when the owner of log exits.
+  void
+  release(thread_log* log)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (log->empty()) { make_reusable(log); }
+    else              { log->state_ = thread_log::finished; }
+  }
+
+  void
+  rename(thread_log& log, std::string const& name)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    log.name_ = name;
+  }
+
+  // Calls f(log) for each log, holding the registry lock.  Every caller
+  // reads or clears the logs, so finished logs are reusable afterwards.
+  template<typename F>
+  void
+  for_each(F f)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& log : logs_)
+    {
+      f(*log);
+      if (log->state_ == thread_log::finished) { make_reusable(log.get()); }
+    }
+  }
+
+private:
+
+  void
+  make_reusable(thread_log* log)
+  {
+    log->state_ = thread_log::reusable;
+    free_.push_back(log);
+  }
+
+  std::mutex                                mutex_;
+  std::vector<std::unique_ptr<thread_log>>  logs_;
+  std::vector<thread_log*>                  free_;    // reusable logs
+};
+
+// Releases the calling thread's log when the thread exits.
+struct log_owner
+{
+  log_owner() : log(registry::instance().add()) {}
+  ~log_owner()  { registry::instance().release(log); }
+
+  log_owner(log_owner const&) = delete;
+  log_owner& operator=(log_owner const&) = delete;
+
+  thread_log* log;
+};
+
+inline thread_log&
+local_log()
+{
+  thread_local log_owner owner;
+  return *owner.log;
+}
+
+inline std::int64_t
+now_ns()
+{
+  return utl::chrono::tsc_clock::now().time_since_epoch().count();
+}
+
+// Aggregated statistics of one node of the zone tree.
+struct zone_node
+{
+  std::string                             name;
+  unsigned                                depth;
+  std::uint64_t                           total;
+  utl::quantile_histogram<std::uint64_t>  hist;
+  std::map<std::string, std::size_t>      children;   // name to node index
+  std::vector<std::size_t>                order;      // children by entry
+};
+
+inline void
+append(report_type& r, std::string const& thread, std::uint64_t dropped,
+       std::vector<zone_node> const& nodes, std::size_t i)
+{
+  zone_node const& z = nodes[i];
+  if (i != 0)   // node 0 is the thread root
+  {
+    zone_stats s;
+    s.thread = thread;
+    s.name   = z.name;
+    s.depth  = z.depth;
+    s.count  = static_cast<std::size_t>(z.hist.count());
+    s.total  = nanoseconds(z.total);
+    s.min    = nanoseconds(z.hist.min());
+    s.max    = nanoseconds(z.hist.max());
+    s.p50    = nanoseconds(z.hist.quantile(0.5));
+    s.p99    = nanoseconds(z.hist.quantile(0.99));
+    s.dropped = dropped;
+    r.push_back(s);
+  }
+  for (std::size_t c : z.order) { append(r, thread, dropped, nodes, c); }
+}
+
+inline bool
+begins_before(zone_event const& a, zone_event const& b)
+{
+  return ((a.begin < b.begin) || ((a.begin == b.begin) && (a.depth < b.depth)));
+}
+
+} // detail -----------------------------------------------------------------
+
+
+inline
+scope::scope(char const* name)
+: name_(name)
+{
+  detail::local_log().enter();
+  begin_ = detail::now_ns();
+}
+
+inline
+scope::~scope()
+{
+  std::int64_t const end = detail::now_ns();
+  detail::local_log().leave(name_, begin_, end);
+}
+
+
+inline void
+thread_name(std::string const& name)
+{
+  detail::registry::instance().rename(detail::local_log(), name);
+}
+
+
+inline report_type
+report()
+{
+  report_type r;
+  std::vector<detail::zone_event> events;
+  detail::registry::instance().for_each([&r, &events](detail::thread_log& log)
+  {
+    events.clear();
+    log.copy(events);
+    if (events.empty()) { return; }
+
+    // Parents begin no later than their children, so in order of
+    // beginning each zone follows its ancestors.
+    std::sort(events.begin(), events.end(), detail::begins_before);
+
+    std::vector<detail::zone_node> nodes(1);
+    nodes[0].depth = 0;
+    nodes[0].total = 0;
+    // Node index and end time of the zones enclosing the current one,
+    // by depth + 1.  A zone whose parent has not ended is not in events,
+    // so it is left out, as are its descendants, rather than attached to
+    // an earlier zone at the same depth.
+    struct open_zone { std::size_t node; std::int64_t end; };
+    std::vector<open_zone> path(1, open_zone{ 0, INT64_MAX });
+    for (detail::zone_event const& e : events)
+    {
+      if (path.size() < (e.depth + 1)) { continue; }
+      path.resize(e.depth + 1);
+      if (path.back().end < e.end) { continue; }
+      std::size_t const parent = path.back().node;
+      auto it = nodes[parent].children.find(e.name);
+      std::size_t i;
+      if (it == nodes[parent].children.end())
+      {
+        i = nodes.size();
+        nodes[parent].children[e.name] = i;
+        nodes[parent].order.push_back(i);
+        nodes.push_back(detail::zone_node());
+        nodes[i].name  = e.name;
+        nodes[i].depth = e.depth;
+        nodes[i].total = 0;
+      }
+      else
+      {
+        i = it->second;
+      }
+      std::uint64_t const dt = static_cast<std::uint64_t>(e.end - e.begin);
+      nodes[i].total += dt;
+      nodes[i].hist.add(dt);
+      path.push_back(open_zone{ i, e.end });
+    }
+    detail::append(r, log.name_, log.dropped(), nodes, 0);
+  });
+  return r;
+}
+
+
+inline utl::json::json
+chrome_trace()
+{
+  utl::json::json events = utl::json::json::array();
+  std::vector<detail::zone_event> zones;
+  detail::registry::instance().for_each([&events, &zones](detail::thread_log& log)
+  {
+    events.push_back({ { "name", "thread_name" }, { "ph", "M" },
+                       { "pid", 0 }, { "tid", log.id_ },
+                       { "args", { { "name", log.name_ } } } });
+    zones.clear();
+    log.copy(zones);
+    for (detail::zone_event const& e : zones)
+    {
+      events.push_back({ { "name", e.name }, { "ph", "X" },
+                         { "pid", 0 }, { "tid", log.id_ },
+                         { "ts",  e.begin / 1000.0 },
+                         { "dur", (e.end - e.begin) / 1000.0 } });
+    }
+  });
+  return { { "traceEvents", events }, { "displayTimeUnit", "ns" } };
+}
+
+
+inline void
+clear()
+{
+  detail::registry::instance().for_each([](detail::thread_log& log)
+  {
+    log.clear();
+  });
+}
+
+
+inline std::ostream&
+operator<<(std::ostream& os, report_type const& r)
+{
+  std::string thread;
+  for (zone_stats const& z : r)
+  {
+    if ((&z == &r.front()) || (z.thread != thread))
+    {
+      thread = z.thread;
+      os << thread;
+      if (z.dropped != 0) { os << "  (" << z.dropped << " zones dropped)"; }
+      os << '\n'
+         << std::left << std::setw(32) << "  zone" << std::right
+         << std::setw(10) << "count" << std::setw(14) << "total us"
+         << std::setw(12) << "min us"  << std::setw(12) << "p50 us"
+         << std::setw(12) << "p99 us"  << std::setw(12) << "max us" << '\n';
+    }
+    auto us = [](nanoseconds ns) { return (ns.count() / 1000.0); };
+    os << std::left << std::setw(32)
+       << (std::string(2 * (z.depth + 1), ' ') + z.name) << std::right
+       << std::setw(10) << z.count << std::setw(14) << us(z.total)
+       << std::setw(12) << us(z.min) << std::setw(12) << us(z.p50)
+       << std::setw(12) << us(z.p99) << std::setw(12) << us(z.max) << '\n';
+  }
+  return os;
+}
+
+} } // utl::profile
+
+#endif // UTL_PROFILE_HPP
+//===========================================================================//
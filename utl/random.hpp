@@ -0,0 +1,71 @@
+/*
+Licensed under the MIT License <http://opensource.org/licenses/MIT>
+
+Copyright 2018 Nathan Lucas <nathan.lucas@wayne.edu>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+//===========================================================================//
+/// @file
+/// @brief    Random number utility library.
+/// @details  Header-only library providing fast reproducible
+///           pseudo-random number engines and algorithms.
+/// @author   Nathan Lucas
+/// @date     2018
+//===========================================================================//
+#ifndef UTL_RANDOM_HPP
+#define UTL_RANDOM_HPP
+
+#ifndef __cplusplus
+#error must be compiled as C++
+#endif
+
+/// @defgroup utl_random  random
+/// @brief    Random number utility library.
+/// @details  Header-only library providing fast reproducible
+///           pseudo-random number engines and algorithms.
+
+//---------------------------------------------------------------------------
+/// @namespace  utl::random
+/// @brief  Random number utility library.
+///
+/// Header-only library providing fast reproducible pseudo-random number
+/// engines and algorithms built on C++ standard library `<random>`. @n
+/// Engines are seeded explicitly for reproducible results:
+/// ```
+/// utl::random::xoshiro256ss engine(42);
+/// utl::random::shuffle(vec.begin(), vec.end(), engine);
+/// ```
+/// or from system entropy through the engine of the calling thread:
+/// ```
+/// utl::random::shuffle(vec.begin(), vec.end(), utl::random::thread_engine());
+/// ```
+//---------------------------------------------------------------------------
+
+
+// Modules
+
+#include "random/random_engine.hpp"
+#include "random/random_distribution.hpp"
+#include "random/random_sample.hpp"
+#include "random/random_shuffle.hpp"
+
+
+#endif // UTL_RANDOM_HPP
+//===========================================================================//
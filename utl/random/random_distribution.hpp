@@ -0,0 +1,358 @@
+/*
+Licensed under the MIT License <http://opensource.org/licenses/MIT>
+
+Copyright 2018 Nathan Lucas <nathan.lucas@wayne.edu>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+//===========================================================================//
+/// @file
+/// @brief    Random variates.
+/// @details  Header-only library providing uniform and normal random
+///           variates, singly and in bulk.
+/// @author   Nathan Lucas
+/// @date     2018
+//===========================================================================//
+#ifndef UTL_RANDOM_DISTRIBUTION_HPP
+#define UTL_RANDOM_DISTRIBUTION_HPP
+
+#ifndef __cplusplus
+#error must be compiled as C++
+#endif
+
+#include <utl/random/random_engine.hpp>   // utl::random::uniform_index
+
+#include <cmath>        // std::abs, std::exp, std::log, std::sqrt
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::int64_t, std::uint64_t
+#include <random>       // std::generate_canonical
+#include <type_traits>  // std::decay, std::is_integral, std::make_unsigned
+
+/// @ingroup  utl_random
+/// @defgroup utl_random_distribution   random_distribution
+/// @brief    Random variates.
+/// @details  Header-only library providing uniform and normal random
+///   variates, singly and in bulk.
+///
+/// The bulk `fill_` functions draw raw 64-bit values into a small block,
+/// then convert the whole block in a separate loop that the compiler can
+/// vectorize.  With the engines of this library they avoid the per-value
+/// overhead of the `<random>` distribution objects, and produce the same
+/// values on every platform.
+
+namespace utl { namespace random {
+
+/// @addtogroup utl_random_distribution
+/// @{
+
+//---------------------------------------------------------------------------
+/// @name Single Variate Functions
+/// @{
+
+/// @brief  Returns a uniformly distributed value in `[0, 1)`.
+/// @param  [in,out]  g   Random bit generator.
+template<typename URBG>
+inline double
+uniform01(URBG&& g);
+
+/// @brief  Returns a normally distributed value with
+///         mean `0` and standard deviation `1`.
+/// @param  [in,out]  g   Random bit generator.
+///
+/// Ziggurat method of Marsaglia and Tsang, with 128 layers.
+template<typename URBG>
+inline double
+normal(URBG&& g);
+
+/// @}
+//---------------------------------------------------------------------------
+/// @name Bulk Variate Functions
+/// @{
+
+/// @brief  Fills @a out with @a n values uniformly distributed
+///         in `[lo, hi)`.
+/// @param  [out]     out   Output values.
+/// @param  [in]      n     Number of values.
+/// @param  [in]      lo    Lower bound (inclusive).
+/// @param  [in]      hi    Upper bound (exclusive).
+/// @param  [in,out]  g     Random bit generator.
+template<typename URBG>
+inline void
+fill_uniform(double* out, std::size_t n, double lo, double hi, URBG&& g);
+
+/// @brief  Fills @a out with @a n values uniformly distributed
+///         in `[lo, hi)`.
+template<typename URBG>
+inline void
+fill_uniform(float* out, std::size_t n, float lo, float hi, URBG&& g);
+
+/// @brief  Fills @a out with @a n integers uniformly distributed
+///         in `[lo, hi]`.
+/// @param  [out]     out   Output values.
+/// @param  [in]      n     Number of values.
+/// @param  [in]      lo    Lower bound (inclusive).
+/// @param  [in]      hi    Upper bound (inclusive).
+/// @param  [in,out]  g     Random bit generator.
+template<typename T, typename URBG>
+inline void
+fill_uniform_int(T* out, std::size_t n, T lo, T hi, URBG&& g);
+
+/// @brief  Fills @a out with @a n normally distributed values.
+/// @param  [out]     out     Output values.
+/// @param  [in]      n       Number of values.
+/// @param  [in]      mean    Mean.
+/// @param  [in]      stddev  Standard deviation.
+/// @param  [in,out]  g       Random bit generator.
+template<typename T, typename URBG>
+inline void
+fill_normal(T* out, std::size_t n, T mean, T stddev, URBG&& g);
+
+/// @}
+//---------------------------------------------------------------------------
+
+/// @}
+
+
+//===========================================================================//
+// Implementation
+
+namespace detail {  //-------------------------------------------------------
+
+// Values drawn per block by the bulk functions.
+constexpr std::size_t fill_block = 64;
+
+// 2^-53 and 2^-24
+constexpr double to_unit_d = 1.0 / 9007199254740992.0;
+constexpr float  to_unit_f = 1.0f / 16777216.0f;
+
+template<typename URBG>
+inline double
+uniform01(URBG& g, std::true_type /*full64*/)
+{
+  return ((g() >> 11) * to_unit_d);
+}
+
+template<typename URBG>
+inline double
+uniform01(URBG& g, std::false_type /*full64*/)
+{
+  return std::generate_canonical<double, 53>(g);
+}
+
+template<typename URBG>
+inline std::uint64_t
+bits64(URBG& g, std::true_type /*full64*/)
+{
+  return g();
+}
+
+template<typename URBG>
+inline std::uint64_t
+bits64(URBG& g, std::false_type /*full64*/)
+{
+  return ((static_cast<std::uint64_t>(uniform01(g, std::false_type())
+              * 9007199254740992.0) << 11) |
+          (uniform_index(g, 2048)));
+}
+
+// Returns a uniformly distributed value in [0, 1) from any generator.
+template<typename URBG>
+inline double
+unit(URBG& g)
+{
+  return uniform01(g, is_full64<typename std::decay<URBG>::type>());
+}
+
+// Returns 64 random bits from any generator.
+template<typename URBG>
+inline std::uint64_t
+bits64(URBG& g)
+{
+  return bits64(g, is_full64<typename std::decay<URBG>::type>());
+}
+
+//---------------------------------------------------------------------------
+// Ziggurat tables for the standard normal distribution
+// (Marsaglia and Tsang, 2000; layout of Doornik, 2005).
+
+struct ziggurat
+{
+  static constexpr unsigned layers = 128;
+  static constexpr double   r = 3.442619855899;       // start of the tail
+  static constexpr double   v = 9.91256303526217e-3;  // area of each layer
+
+  double x[layers + 1];   // layer edges
+  double ratio[layers];   // x[i+1] / x[i]
+
+  ziggurat()
+  {
+    double f = std::exp(-0.5 * r * r);
+    x[0] = v / f;
+    x[1] = r;
+    x[layers] = 0;
+    for (unsigned i = 2; i != layers; ++i)
+    {
+      x[i] = std::sqrt(-2 * std::log((v / x[i - 1]) + f));
+      f = std::exp(-0.5 * x[i] * x[i]);
+    }
+    for (unsigned i = 0; i != layers; ++i) { ratio[i] = x[i + 1] / x[i]; }
+  }
+
+  static ziggurat const&
+  table()
+  {
+    static ziggurat const z;
+    return z;
+  }
+};
+
+template<typename URBG>
+inline double
+normal(URBG& g, ziggurat const& z)
+{
+  for (;;)
+  {
+    std::uint64_t bits = bits64(g);
+    unsigned i = static_cast<unsigned>(bits & (ziggurat::layers - 1));
+    double u = (2 * ((bits >> 11) * to_unit_d)) - 1;    // (-1, 1)
+    if (std::abs(u) < z.ratio[i])
+    {
+      return (u * z.x[i]);    // inside the rectangle:  most draws
+    }
+    if (i == 0)
+    {
+      // Base layer:  sample from the tail beyond r.
+      double a, b;
+      do
+      {
+        a = -std::log(1 - unit(g)) / ziggurat::r;
+        b = -std::log(1 - unit(g));
+      } while ((b + b) < (a * a));
+      return ((u > 0) ? (ziggurat::r + a) : -(ziggurat::r + a));
+    }
+    // Wedge between layers.
+    double xx = u * z.x[i];
+    double f0 = std::exp(-0.5 * ((z.x[i] * z.x[i]) - (xx * xx)));
+    double f1 = std::exp(-0.5 * ((z.x[i + 1] * z.x[i + 1]) - (xx * xx)));
+    if ((f1 + (unit(g) * (f0 - f1))) < 1.0)
+    {
+      return xx;
+    }
+  }
+}
+
+} // detail -----------------------------------------------------------------
+
+
+template<typename URBG>
+inline double
+uniform01(URBG&& g)
+{
+  return detail::unit(g);
+}
+
+
+template<typename URBG>
+inline double
+normal(URBG&& g)
+{
+  return detail::normal(g, detail::ziggurat::table());
+}
+
+
+template<typename URBG>
+inline void
+fill_uniform(double* out, std::size_t n, double lo, double hi, URBG&& g)
+{
+  double const scale = (hi - lo) * detail::to_unit_d;
+  std::uint64_t bits[detail::fill_block];
+  while (n != 0)
+  {
+    std::size_t const m = ((n < detail::fill_block) ? n : detail::fill_block);
+    for (std::size_t i = 0; i != m; ++i) { bits[i] = detail::bits64(g); }
+    for (std::size_t i = 0; i != m; ++i)
+    {
+      out[i] = lo + (static_cast<double>(
+                       static_cast<std::int64_t>(bits[i] >> 11)) * scale);
+    }
+    out += m;
+    n -= m;
+  }
+}
+
+
+template<typename URBG>
+inline void
+fill_uniform(float* out, std::size_t n, float lo, float hi, URBG&& g)
+{
+  // Two 24-bit values per 64-bit draw.
+  float const scale = (hi - lo) * detail::to_unit_f;
+  std::uint64_t bits[detail::fill_block];
+  while (n != 0)
+  {
+    std::size_t const m = ((n < (2 * detail::fill_block)) ? n
+                                                          : (2 * detail::fill_block));
+    for (std::size_t i = 0; i < m; i += 2) { bits[i / 2] = detail::bits64(g); }
+    for (std::size_t i = 0; i != m; ++i)
+    {
+      std::uint32_t const u = static_cast<std::uint32_t>(
+          (bits[i / 2] >> ((i & 1) ? 40 : 8)) & 0xFFFFFFu);
+      out[i] = lo + (static_cast<float>(static_cast<std::int32_t>(u)) * scale);
+    }
+    out += m;
+    n -= m;
+  }
+}
+
+
+template<typename T, typename URBG>
+inline void
+fill_uniform_int(T* out, std::size_t n, T lo, T hi, URBG&& g)
+{
+  static_assert(std::is_integral<T>::value, "T must be an integer type");
+  typedef typename std::make_unsigned<T>::type U;
+  // Narrow types promote to int, so bring the difference back to U
+  // before widening.
+  std::uint64_t const range = static_cast<std::uint64_t>(
+      static_cast<U>(static_cast<U>(hi) - static_cast<U>(lo))) + 1;
+  for (std::size_t i = 0; i != n; ++i)
+  {
+    // range is 0 only when every 64-bit value is in range
+    std::uint64_t k = ((range == 0) ? detail::bits64(g)
+                                    : utl::random::uniform_index(g, range));
+    out[i] = static_cast<T>(static_cast<U>(static_cast<U>(lo) + static_cast<U>(k)));
+  }
+}
+
+
+template<typename T, typename URBG>
+inline void
+fill_normal(T* out, std::size_t n, T mean, T stddev, URBG&& g)
+{
+  detail::ziggurat const& z = detail::ziggurat::table();
+  for (std::size_t i = 0; i != n; ++i)
+  {
+    out[i] = static_cast<T>(mean + (stddev * detail::normal(g, z)));
+  }
+}
+
+} } // utl::random
+
+#endif // UTL_RANDOM_DISTRIBUTION_HPP
+//===========================================================================//
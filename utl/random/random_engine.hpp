@@ -0,0 +1,425 @@
+/*
+Licensed under the MIT License <http://opensource.org/licenses/MIT>
+
+Copyright 2018 Nathan Lucas <nathan.lucas@wayne.edu>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+//===========================================================================//
+/// @file
+/// @brief    Pseudo-random number engines.
+/// @details  Header-only library providing fast pseudo-random number
+///           engines compatible with C++ standard library `<random>`.
+/// @author   Nathan Lucas
+/// @date     2018
+//===========================================================================//
+#ifndef UTL_RANDOM_ENGINE_HPP
+#define UTL_RANDOM_ENGINE_HPP
+
+#ifndef __cplusplus
+#error must be compiled as C++
+#endif
+
+#include <atomic>       // std::atomic
+#include <chrono>       // std::chrono::steady_clock
+#include <cstdint>      // std::uint64_t
+#include <functional>   // std::hash
+#include <limits>       // std::numeric_limits
+#include <random>       // std::random_device, std::uniform_int_distribution
+#include <thread>       // std::this_thread::get_id
+#include <type_traits>  // std::integral_constant, std::decay
+
+/// @ingroup  utl_random
+/// @defgroup utl_random_engine   random_engine
+/// @brief    Pseudo-random number engines.
+/// @details  Header-only library providing fast pseudo-random number
+///   engines compatible with C++ standard library `<random>`.
+///
+/// The engines satisfy the standard *UniformRandomBitGenerator*
+/// requirements, so they can be used with `<random>` distributions and
+/// `std::shuffle`.  Each engine produces the same sequence for the same
+/// seed on every platform.
+
+namespace utl { namespace random {
+
+/// @addtogroup utl_random_engine
+/// @{
+
+//---------------------------------------------------------------------------
+/// @brief  SplitMix64 generator.
+///
+/// A fast 64-bit generator with a single word of state.  It is mainly
+/// used to expand one seed value into the state of a larger engine.
+class splitmix64
+{
+public:
+
+  typedef std::uint64_t result_type;
+
+  /// Constructs the generator from @a seed.
+  explicit
+  splitmix64(std::uint64_t seed = 0)
+  : state_(seed)
+  {}
+
+  /// Returns the smallest value the generator produces.
+  static constexpr result_type
+  min()   { return 0; }
+
+  /// Returns the largest value the generator produces.
+  static constexpr result_type
+  max()   { return std::numeric_limits<result_type>::max(); }
+
+  /// Returns the next value.
+  result_type
+  operator()()
+  {
+    std::uint64_t z = (state_ += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return (z ^ (z >> 31));
+  }
+
+private:
+  std::uint64_t state_;
+};
+
+//---------------------------------------------------------------------------
+/// @brief  xoshiro256** generator.
+///
+/// General-purpose 64-bit generator with 256 bits of state and a period
+/// of 2^256 - 1, by David Blackman and Sebastiano Vigna. @n
+/// `jump()` advances the state by 2^128 values, which gives up to 2^128
+/// non-overlapping sequences for parallel use.
+class xoshiro256ss
+{
+public:
+
+  typedef std::uint64_t result_type;
+
+  /// Constructs the engine with its state expanded from @a seed.
+  explicit
+  xoshiro256ss(std::uint64_t seed = 0)    { this->seed(seed); }
+
+  /// Reinitializes the state from @a seed.
+  void
+  seed(std::uint64_t seed)
+  {
+    splitmix64 sm(seed);
+    for (auto& s : s_) { s = sm(); }
+  }
+
+  /// Returns the smallest value the engine produces.
+  static constexpr result_type
+  min()   { return 0; }
+
+  /// Returns the largest value the engine produces.
+  static constexpr result_type
+  max()   { return std::numeric_limits<result_type>::max(); }
+
+  /// Returns the next value.
+  result_type
+  operator()()
+  {
+    std::uint64_t const result = rotl(s_[1] * 5, 7) * 9;
+    std::uint64_t const t = s_[1] << 17;
+    s_[2] ^= s_[0];
+    s_[3] ^= s_[1];
+    s_[1] ^= s_[2];
+    s_[0] ^= s_[3];
+    s_[2] ^= t;
+    s_[3] = rotl(s_[3], 45);
+    return result;
+  }
+
+  /// Advances the state by @a n values.
+  void
+  discard(unsigned long long n)   { while (n--) { (*this)(); } }
+
+  /// Advances the state by 2^128 values.
+  void
+  jump()
+  {
+    static std::uint64_t const j[] = {
+      0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull,
+      0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull };
+    std::uint64_t t[4] = { 0, 0, 0, 0 };
+    for (std::uint64_t w : j)
+    {
+      for (unsigned b = 0; b != 64; ++b)
+      {
+        if (w & (std::uint64_t(1) << b))
+        {
+          for (unsigned i = 0; i != 4; ++i) { t[i] ^= s_[i]; }
+        }
+        (*this)();
+      }
+    }
+    for (unsigned i = 0; i != 4; ++i) { s_[i] = t[i]; }
+  }
+
+  /// Returns `true` if both engines will produce the same sequence.
+  friend bool
+  operator==(xoshiro256ss const& a, xoshiro256ss const& b)
+  {
+    return ((a.s_[0] == b.s_[0]) && (a.s_[1] == b.s_[1]) &&
+            (a.s_[2] == b.s_[2]) && (a.s_[3] == b.s_[3]));
+  }
+
+  /// Returns `true` if the engines will produce different sequences.
+  friend bool
+  operator!=(xoshiro256ss const& a, xoshiro256ss const& b)
+  {
+    return !(a == b);
+  }
+
+private:
+
+  static std::uint64_t
+  rotl(std::uint64_t x, int k)    { return ((x << k) | (x >> (64 - k))); }
+
+  std::uint64_t s_[4];
+};
+
+//---------------------------------------------------------------------------
+
+namespace detail {  //-------------------------------------------------------
+
+// Full 128-bit product of two 64-bit values.
+inline void
+mul128(std::uint64_t a, std::uint64_t b, std::uint64_t& hi, std::uint64_t& lo)
+{
+#if defined(__SIZEOF_INT128__)
+  unsigned __int128 p = static_cast<unsigned __int128>(a) * b;
+  hi = static_cast<std::uint64_t>(p >> 64);
+  lo = static_cast<std::uint64_t>(p);
+#else
+  std::uint64_t const a_lo = (a & 0xFFFFFFFFull), a_hi = (a >> 32);
+  std::uint64_t const b_lo = (b & 0xFFFFFFFFull), b_hi = (b >> 32);
+  std::uint64_t const p0 = a_lo * b_lo;
+  std::uint64_t const p1 = a_lo * b_hi;
+  std::uint64_t const p2 = a_hi * b_lo;
+  std::uint64_t const p3 = a_hi * b_hi;
+  std::uint64_t const mid = (p0 >> 32) + (p1 & 0xFFFFFFFFull) +
+                            (p2 & 0xFFFFFFFFull);
+  lo = (mid << 32) | (p0 & 0xFFFFFFFFull);
+  hi = p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32);
+#endif
+}
+
+} // detail -----------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+/// @brief  PCG64 generator (PCG XSL RR 128/64).
+///
+/// 64-bit generator with 128 bits of state and a period of 2^128,
+/// by Melissa O'Neill.  Engines constructed with different @a stream
+/// values produce independent sequences from the same seed.
+class pcg64
+{
+public:
+
+  typedef std::uint64_t result_type;
+
+  /// Constructs the engine from @a seed and sequence selector @a stream.
+  explicit
+  pcg64(std::uint64_t seed = 0, std::uint64_t stream = 0)
+  {
+    this->seed(seed, stream);
+  }
+
+  /// Reinitializes the state from @a seed and sequence selector @a stream.
+  void
+  seed(std::uint64_t seed, std::uint64_t stream = 0)
+  {
+    splitmix64 sm(seed);
+    splitmix64 ss(stream ^ 0xDA3E39CB94B95BDBull);
+    // Increment must be odd.
+    inc_hi_ = ss();
+    inc_lo_ = (ss() | 1);
+    hi_ = 0;
+    lo_ = 0;
+    step();
+    add(sm(), sm());
+    step();
+  }
+
+  /// Returns the smallest value the engine produces.
+  static constexpr result_type
+  min()   { return 0; }
+
+  /// Returns the largest value the engine produces.
+  static constexpr result_type
+  max()   { return std::numeric_limits<result_type>::max(); }
+
+  /// Returns the next value.
+  result_type
+  operator()()
+  {
+    step();
+    std::uint64_t const x = (hi_ ^ lo_);
+    unsigned const rot = static_cast<unsigned>(hi_ >> 58);
+    return ((x >> rot) | (x << ((64 - rot) & 63)));
+  }
+
+  /// Advances the state by @a n values.
+  void
+  discard(unsigned long long n)   { while (n--) { step(); } }
+
+private:
+
+  // state = state * multiplier + increment  (mod 2^128)
+  void
+  step()
+  {
+    std::uint64_t const m_hi = 0x2360ED051FC65DA4ull;
+    std::uint64_t const m_lo = 0x4385DF649FCCF645ull;
+    std::uint64_t hi, lo;
+    detail::mul128(lo_, m_lo, hi, lo);
+    hi += (lo_ * m_hi) + (hi_ * m_lo);
+    hi_ = hi;
+    lo_ = lo;
+    add(inc_hi_, inc_lo_);
+  }
+
+  void
+  add(std::uint64_t hi, std::uint64_t lo)
+  {
+    lo_ += lo;
+    hi_ += hi + (lo_ < lo);
+  }
+
+  std::uint64_t hi_, lo_;         // state
+  std::uint64_t inc_hi_, inc_lo_; // increment (sequence selector)
+};
+
+//---------------------------------------------------------------------------
+/// @name Engine Functions
+/// @{
+
+/// @brief  Returns a seed value drawn from system entropy.
+///
+/// Combines `std::random_device` with the steady clock, the calling
+/// thread, and a process-wide counter, so that distinct calls return
+/// distinct seeds even where `std::random_device` is deterministic.
+inline std::uint64_t
+entropy_seed()
+{
+  static std::atomic<std::uint64_t> counter{0};
+  std::random_device rd;
+  std::uint64_t s = (static_cast<std::uint64_t>(rd()) << 32) ^ rd();
+  s ^= static_cast<std::uint64_t>(
+          std::chrono::steady_clock::now().time_since_epoch().count());
+  s ^= static_cast<std::uint64_t>(
+          std::hash<std::thread::id>()(std::this_thread::get_id())) << 1;
+  s += counter.fetch_add(0x9E3779B97F4A7C15ull, std::memory_order_relaxed);
+  return splitmix64(s)();
+}
+
+/// @brief  Returns the engine of the calling thread.
+///
+/// Each thread has its own engine, so no locking is needed.  The engine
+/// is seeded from entropy_seed() on first use, unless seed() is called
+/// first.
+inline xoshiro256ss&
+thread_engine()
+{
+  thread_local xoshiro256ss engine(entropy_seed());
+  return engine;
+}
+
+/// @brief  Reseeds the engine of the calling thread.
+///
+/// Seeding each thread with a known value makes subsequent
+/// results reproducible.
+inline void
+seed(std::uint64_t s)
+{
+  thread_engine().seed(s);
+}
+
+/// @brief  Returns a uniformly distributed integer in `[0, n)`.
+/// @param  [in,out]  g   Random bit generator.
+/// @param  [in]      n   Upper bound (exclusive); must be positive.
+///
+/// For engines that produce all 64-bit values (such as those in this
+/// library), uses Lemire's multiply-and-reject method, which usually
+/// needs no division.  Other generators use
+/// `std::uniform_int_distribution`.
+template<typename URBG>
+inline std::uint64_t
+uniform_index(URBG&& g, std::uint64_t n);
+
+/// @}
+//---------------------------------------------------------------------------
+
+/// @}
+
+
+//===========================================================================//
+// Implementation
+
+namespace detail {  //-------------------------------------------------------
+
+template<typename G>
+struct is_full64
+: std::integral_constant<bool,
+    (G::min() == 0) &&
+    (G::max() == std::numeric_limits<std::uint64_t>::max())>
+{};
+
+template<typename URBG>
+inline std::uint64_t
+uniform_index(URBG& g, std::uint64_t n, std::true_type /*full64*/)
+{
+  std::uint64_t hi, lo;
+  detail::mul128(g(), n, hi, lo);
+  if (lo < n)
+  {
+    std::uint64_t const threshold = (0 - n) % n;
+    while (lo < threshold)
+    {
+      detail::mul128(g(), n, hi, lo);
+    }
+  }
+  return hi;
+}
+
+template<typename URBG>
+inline std::uint64_t
+uniform_index(URBG& g, std::uint64_t n, std::false_type /*full64*/)
+{
+  return std::uniform_int_distribution<std::uint64_t>(0, n - 1)(g);
+}
+
+} // detail -----------------------------------------------------------------
+
+
+template<typename URBG>
+inline std::uint64_t
+uniform_index(URBG&& g, std::uint64_t n)
+{
+  typedef typename std::decay<URBG>::type G;
+  return detail::uniform_index(g, n, detail::is_full64<G>());
+}
+
+} } // utl::random
+
+#endif // UTL_RANDOM_ENGINE_HPP
+//===========================================================================//
@@ -0,0 +1,276 @@
+/*
+Licensed under the MIT License <http://opensource.org/licenses/MIT>
+
+Copyright 2018 Nathan Lucas <nathan.lucas@wayne.edu>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+//===========================================================================//
+/// @file
+/// @brief    Random sampling.
+/// @details  Header-only library providing uniform and weighted
+///           random sampling algorithms.
+/// @author   Nathan Lucas
+/// @date     2018
+//===========================================================================//
+#ifndef UTL_RANDOM_SAMPLE_HPP
+#define UTL_RANDOM_SAMPLE_HPP
+
+#ifndef __cplusplus
+#error must be compiled as C++
+#endif
+
+#include <utl/random/random_distribution.hpp>   // utl::random::uniform01
+#include <utl/random/random_engine.hpp>         // utl::random::uniform_index
+
+#include <algorithm>    // std::nth_element, std::sort
+#include <cmath>        // std::exp, std::floor, std::log, std::log1p
+#include <cstddef>      // std::size_t
+#include <iterator>     // std::iterator_traits
+#include <stdexcept>    // std::invalid_argument
+#include <utility>      // std::pair
+#include <vector>       // std::vector
+
+/// @ingroup  utl_random
+/// @defgroup utl_random_sample   random_sample
+/// @brief    Random sampling.
+/// @details  Header-only library providing uniform and weighted
+///           random sampling algorithms.
+
+namespace utl { namespace random {
+
+/// @addtogroup utl_random_sample
+/// @{
+
+//---------------------------------------------------------------------------
+/// @name Sampling Functions
+/// @{
+
+/// @brief  Selects @a k elements uniformly at random, without replacement,
+///         from the range [@a first, @a last).
+/// @param  [in]      first   Beginning of range.
+/// @param  [in]      last    End of range.
+/// @param  [in]      k       Number of elements to select.
+/// @param  [in,out]  g       Random bit generator.
+/// @return Selected elements in no particular order, or every element
+///         if the range has fewer than @a k.
+///
+/// Reservoir sampling in one pass over an input range of unknown length,
+/// using Li's Algorithm L, which skips over elements and needs only
+/// `O(k (1 + log(n / k)))` random values.
+template<typename InputIt, typename URBG>
+inline std::vector<typename std::iterator_traits<InputIt>::value_type>
+sample(InputIt first, InputIt last, std::size_t k, URBG&& g);
+
+/// @brief  Selects @a k indices at random, without replacement, with
+///         probability proportional to @a weights.
+/// @param  [in]      weights   Weight of each index.
+/// @param  [in]      k         Number of indices to select.
+/// @param  [in,out]  g         Random bit generator.
+/// @return Selected indices in order of selection, or every index with
+///         positive weight if there are fewer than @a k.
+/// @throw  std::invalid_argument if @a weights contains a negative value.
+///
+/// Efraimidis-Spirakis method:  each index gets the key `E / w` for an
+/// exponential variate `E`, and the @a k smallest keys are selected.
+template<typename URBG>
+inline std::vector<std::size_t>
+weighted_sample(std::vector<double> const& weights, std::size_t k, URBG&& g);
+
+/// @}
+//---------------------------------------------------------------------------
+/// @brief  Weighted random selection with replacement in constant time.
+///
+/// Vose's alias method:  construction takes `O(n)` time, then each
+/// selection takes one random value and at most one comparison.
+///
+/// Example usage:
+/// ```
+///   utl::random::alias_table table({ 0.5, 0.25, 0.25 });
+///   std::size_t i = table(utl::random::thread_engine());
+/// ```
+class alias_table
+{
+public:
+
+  /// @brief  Constructor.
+  /// @param  [in]  weights   Weight of each index.
+  /// @throw  std::invalid_argument if @a weights is empty, contains a
+  ///         negative value, or sums to zero.
+  explicit
+  alias_table(std::vector<double> const& weights);
+
+  /// Returns the number of indices.
+  std::size_t
+  size() const      { return prob_.size(); }
+
+  /// Returns the probability of selecting index @a i.
+  double
+  probability(std::size_t i) const;
+
+  /// @brief  Returns an index selected with probability
+  ///         proportional to its weight.
+  /// @param  [in,out]  g   Random bit generator.
+  template<typename URBG>
+  std::size_t
+  operator()(URBG&& g) const
+  {
+    std::size_t i = static_cast<std::size_t>(
+        utl::random::uniform_index(g, prob_.size()));
+    return ((utl::random::uniform01(g) < prob_[i]) ? i : alias_[i]);
+  }
+
+private:
+  std::vector<double>       prob_;    // probability of keeping column i
+  std::vector<std::size_t>  alias_;   // alternative to column i
+};
+
+//---------------------------------------------------------------------------
+
+/// @}
+
+
+//===========================================================================//
+// Implementation
+
+
+template<typename InputIt, typename URBG>
+inline std::vector<typename std::iterator_traits<InputIt>::value_type>
+sample(InputIt first, InputIt last, std::size_t k, URBG&& g)
+{
+  std::vector<typename std::iterator_traits<InputIt>::value_type> reservoir;
+  if (k == 0) { return reservoir; }
+  reservoir.reserve(k);
+
+  // Fill the reservoir with the first k elements.
+  for (; (first != last) && (reservoir.size() != k); ++first)
+  {
+    reservoir.push_back(*first);
+  }
+  if (first == last) { return reservoir; }
+
+  // Open interval (0, 1) for logarithms.
+  auto u = [&g]() { return (1 - utl::random::uniform01(g)); };
+
+  double const inv_k = 1.0 / k;
+  double w = std::exp(std::log(u()) * inv_k);
+  for (;;)
+  {
+    // Number of elements to skip before the next replacement.
+    double skip = std::floor(std::log(u()) / std::log1p(-w));
+    for (; (skip > 0) && (first != last); skip -= 1) { ++first; }
+    if (first == last) { break; }
+    reservoir[static_cast<std::size_t>(
+        utl::random::uniform_index(g, k))] = *first;
+    ++first;
+    w *= std::exp(std::log(u()) * inv_k);
+  }
+  return reservoir;
+}
+
+
+template<typename URBG>
+inline std::vector<std::size_t>
+weighted_sample(std::vector<double> const& weights, std::size_t k, URBG&& g)
+{
+  typedef std::pair<double, std::size_t> key_index;
+  std::vector<key_index> keys;
+  keys.reserve(weights.size());
+  for (std::size_t i = 0; i != weights.size(); ++i)
+  {
+    if (weights[i] < 0)
+    {
+      throw std::invalid_argument("weighted_sample: negative weight");
+    }
+    if (weights[i] > 0)
+    {
+      double e = -std::log(1 - utl::random::uniform01(g));  // exponential
+      keys.push_back(key_index(e / weights[i], i));
+    }
+  }
+  if (k < keys.size())
+  {
+    std::nth_element(keys.begin(), keys.begin() + k, keys.end());
+    keys.resize(k);
+  }
+  std::sort(keys.begin(), keys.end());
+
+  std::vector<std::size_t> indices;
+  indices.reserve(keys.size());
+  for (auto const& ki : keys) { indices.push_back(ki.second); }
+  return indices;
+}
+
+//---------------------------------------------------------------------------
+
+inline
+alias_table::alias_table(std::vector<double> const& weights)
+: prob_(weights.size())
+, alias_(weights.size())
+{
+  std::size_t const n = weights.size();
+  double sum = 0;
+  for (double w : weights)
+  {
+    if (w < 0) { throw std::invalid_argument("alias_table: negative weight"); }
+    sum += w;
+  }
+  if ((n == 0) || !(sum > 0))
+  {
+    throw std::invalid_argument("alias_table: no positive weight");
+  }
+
+  // Scale so the average column height is 1, then pair each short
+  // column with a tall column that fills its remainder.
+  std::vector<double>      scaled(n);
+  std::vector<std::size_t> small, large;
+  for (std::size_t i = 0; i != n; ++i)
+  {
+    scaled[i] = (weights[i] * n) / sum;
+    ((scaled[i] < 1) ? small : large).push_back(i);
+  }
+  while (!small.empty() && !large.empty())
+  {
+    std::size_t s = small.back(); small.pop_back();
+    std::size_t l = large.back(); large.pop_back();
+    prob_[s]  = scaled[s];
+    alias_[s] = l;
+    scaled[l] = (scaled[l] + scaled[s]) - 1;
+    ((scaled[l] < 1) ? small : large).push_back(l);
+  }
+  // Remaining columns are full, up to rounding error.
+  for (std::size_t i : large) { prob_[i] = 1; alias_[i] = i; }
+  for (std::size_t i : small) { prob_[i] = 1; alias_[i] = i; }
+}
+
+inline double
+alias_table::probability(std::size_t i) const
+{
+  double p = prob_[i];
+  for (std::size_t j = 0; j != prob_.size(); ++j)
+  {
+    if ((alias_[j] == i) && (j != i)) { p += (1 - prob_[j]); }
+  }
+  return (p / prob_.size());
+}
+
+} } // utl::random
+
+#endif // UTL_RANDOM_SAMPLE_HPP
+//===========================================================================//
@@ -0,0 +1,251 @@
+/*
+Licensed under the MIT License <http://opensource.org/licenses/MIT>
+
+Copyright 2018 Nathan Lucas <nathan.lucas@wayne.edu>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+//===========================================================================//
+/// @file
+/// @brief    Random permutation.
+/// @details  Header-only library providing reproducible sequential
+///           and parallel shuffle algorithms.
+/// @author   Nathan Lucas
+/// @date     2018
+//===========================================================================//
+#ifndef UTL_RANDOM_SHUFFLE_HPP
+#define UTL_RANDOM_SHUFFLE_HPP
+
+#ifndef __cplusplus
+#error must be compiled as C++
+#endif
+
+#include <utl/random/random_engine.hpp>   // utl::random::xoshiro256ss,
+                                          // utl::random::uniform_index
+
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint64_t
+#include <iterator>     // std::distance
+#include <thread>       // std::thread
+#include <utility>      // std::swap
+#include <vector>       // std::vector
+
+/// @ingroup  utl_random
+/// @defgroup utl_random_shuffle  random_shuffle
+/// @brief    Random permutation.
+/// @details  Header-only library providing reproducible sequential
+///   and parallel shuffle algorithms.
+///
+/// Unlike `std::shuffle`, whose results differ between standard library
+/// implementations, these functions produce the same permutation for the
+/// same engine state on every platform.
+
+namespace utl { namespace random {
+
+/// @addtogroup utl_random_shuffle
+/// @{
+
+//---------------------------------------------------------------------------
+/// @name Shuffle Functions
+/// @{
+
+/// @brief  Randomly rearranges elements in the range [@a first, @a last).
+/// @param  [in]      first   Beginning of range.
+/// @param  [in]      last    End of range.
+/// @param  [in,out]  g       Random bit generator.
+///
+/// Fisher-Yates shuffle using utl::random::uniform_index.
+template<typename RandomIt, typename URBG>
+inline void
+shuffle(RandomIt first, RandomIt last, URBG&& g);
+
+/// @brief  Randomly rearranges elements in the range [@a first, @a last)
+///         using multiple threads.
+/// @param  [in]      first     Beginning of range.
+/// @param  [in]      last      End of range.
+/// @param  [in,out]  g         Random bit generator, used only to seed
+///                             one engine per thread.
+/// @param  [in]      threads   Maximum number of threads, or `0` to use
+///                             `std::thread::hardware_concurrency()`.
+///
+/// MergeShuffle algorithm (Bacher, Bodini, Hollender, and Lumbroso, 2015):
+/// the range is split into blocks which are shuffled concurrently, then
+/// adjacent blocks are merged in random order, also concurrently, until
+/// one block remains.  Each block uses its own xoshiro256ss sequence
+/// jumped from a seed drawn from @a g, so the permutation depends only on
+/// @a g and the number of threads.  Ranges too small to benefit from
+/// threads are shuffled sequentially.
+template<typename RandomIt, typename URBG>
+inline void
+parallel_shuffle(RandomIt first, RandomIt last, URBG&& g,
+                 unsigned threads = 0);
+
+/// @}
+//---------------------------------------------------------------------------
+
+/// @}
+
+
+//===========================================================================//
+// Implementation
+
+namespace detail {  //-------------------------------------------------------
+
+// Smallest block worth handing to its own thread.
+constexpr std::size_t parallel_shuffle_min_block = (1 << 15);
+
+// Supplies random bits one at a time.
+template<typename URBG>
+class coin
+{
+public:
+  explicit coin(URBG& g) : g_(g), bits_(0), n_(0) {}
+
+  bool
+  operator()()
+  {
+    if (n_ == 0) { bits_ = g_(); n_ = 64; }
+    bool b = (bits_ & 1);
+    bits_ >>= 1;
+    --n_;
+    return b;
+  }
+
+private:
+  URBG&         g_;
+  std::uint64_t bits_;
+  unsigned      n_;
+};
+
+// Merges shuffled ranges [first, mid) and [mid, last) into one
+// shuffled range.  Elements are drawn from either side by coin flip
+// until one side runs out; the remainder is placed by random insertion.
+template<typename RandomIt, typename URBG>
+inline void
+merge_shuffle(RandomIt first, RandomIt mid, RandomIt last, URBG& g)
+{
+  using std::swap;
+  coin<URBG> flip(g);
+  RandomIt i = first;
+  RandomIt j = mid;
+  for (;;)
+  {
+    if (flip())
+    {
+      if (j == last) { break; }
+      swap(*i, *j);
+      ++j;
+    }
+    else if (i == j)
+    {
+      break;
+    }
+    ++i;
+  }
+  for (; i != last; ++i)
+  {
+    std::uint64_t k = utl::random::uniform_index(g, (i - first) + 1);
+    swap(*i, *(first + k));
+  }
+}
+
+} // detail -----------------------------------------------------------------
+
+
+template<typename RandomIt, typename URBG>
+inline void
+shuffle(RandomIt first, RandomIt last, URBG&& g)
+{
+  using std::swap;
+  auto n = std::distance(first, last);
+  for (auto i = n - 1; i > 0; --i)
+  {
+    std::uint64_t k = utl::random::uniform_index(g, i + 1);
+    swap(*(first + i), *(first + k));
+  }
+}
+
+
+template<typename RandomIt, typename URBG>
+inline void
+parallel_shuffle(RandomIt first, RandomIt last, URBG&& g, unsigned threads)
+{
+  std::size_t const n = static_cast<std::size_t>(std::distance(first, last));
+  if (threads == 0) { threads = std::thread::hardware_concurrency(); }
+
+  // Number of blocks:  a power of two, at most one per thread.
+  std::size_t blocks = 1;
+  while (((blocks * 2) <= threads) &&
+         ((n / (blocks * 2)) >= detail::parallel_shuffle_min_block))
+  {
+    blocks *= 2;
+  }
+
+  // One independent sequence per block.
+  std::vector<utl::random::xoshiro256ss> engines;
+  engines.reserve(blocks);
+  engines.emplace_back(g());
+  for (std::size_t b = 1; b < blocks; ++b)
+  {
+    engines.push_back(engines.back());
+    engines.back().jump();
+  }
+
+  if (blocks == 1)
+  {
+    utl::random::shuffle(first, last, engines[0]);
+    return;
+  }
+
+  auto bound = [first, n, blocks](std::size_t b)
+  {
+    return (first + static_cast<std::ptrdiff_t>((n * b) / blocks));
+  };
+
+  // Shuffle each block.
+  std::vector<std::thread> workers;
+  for (std::size_t b = 0; b != blocks; ++b)
+  {
+    workers.emplace_back([&engines, &bound, b]()
+    {
+      utl::random::shuffle(bound(b), bound(b + 1), engines[b]);
+    });
+  }
+  for (auto& w : workers) { w.join(); }
+
+  // Merge adjacent blocks, doubling the block width each pass.
+  for (std::size_t width = 1; width < blocks; width *= 2)
+  {
+    workers.clear();
+    for (std::size_t b = 0; b < blocks; b += (2 * width))
+    {
+      workers.emplace_back([&engines, &bound, b, width]()
+      {
+        detail::merge_shuffle(bound(b), bound(b + width),
+                              bound(b + (2 * width)), engines[b]);
+      });
+    }
+    for (auto& w : workers) { w.join(); }
+  }
+}
+
+} } // utl::random
+
+#endif // UTL_RANDOM_SHUFFLE_HPP
+//===========================================================================//
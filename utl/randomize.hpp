@@ -25,7 +25,7 @@ SOFTWARE.
 /// @file
 /// @brief    Randomizer.
 /// @author   Nathan Lucas
-/// @date     2016
+/// @date     2016-2018
 //===========================================================================//
 #ifndef UTL_RANDOMIZE_HPP
 #define UTL_RANDOMIZE_HPP
@@ -34,28 +34,40 @@ SOFTWARE.
 #error must be compiled as C++
 #endif
 
-#include <algorithm>      // std::shuffle
-#include <chrono>         // std::chrono::system_clock
-#include <random>         // std::default_random_engine
+#include <utl/random.hpp>   // utl::random::shuffle,
+                           // utl::random::thread_engine
+
+#include <cstdint>        // std::uint64_t
+#include <iterator>       // std::begin, std::end
 #include <vector>         // std::vector
 
 namespace utl {
 
-/// @brief  Randomizes the order of elements in
+/// @brief  Randomizes the order of elements in @a vec.
 /// @tparam T   Type of elements.
 /// @param  vec Vector to randomize.
+///
+/// Uses the engine of the calling thread (utl::random::thread_engine),
+/// which is seeded from system entropy unless utl::random::seed is
+/// called first.
 template<typename T>
-/*inline*/ void
+inline void
 randomize(std::vector<T>& vec)
 {
-  // time-based seed for random number generator
-  unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-
-  // random number generator
-  auto engine = std::default_random_engine(seed);
+  utl::random::shuffle(std::begin(vec), std::end(vec),
+                       utl::random::thread_engine());
+}
 
-  // randomly rearrange elements
-  std::shuffle(std::begin(vec), std::end(vec), engine);
+/// @brief  Randomizes the order of elements in @a vec reproducibly.
+/// @tparam T     Type of elements.
+/// @param  vec   Vector to randomize.
+/// @param  seed  Seed value; the same seed gives the same order.
+template<typename T>
+inline void
+randomize(std::vector<T>& vec, std::uint64_t seed)
+{
+  utl::random::xoshiro256ss engine(seed);
+  utl::random::shuffle(std::begin(vec), std::end(vec), engine);
 }
 
 } // utl
@@ -0,0 +1,564 @@
+/*
+Licensed under the MIT License <http://opensource.org/licenses/MIT>
+
+Copyright 2018 Nathan Lucas <nathan.lucas@wayne.edu>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+//===========================================================================//
+/// @file
+/// @brief    Binary serialization.
+/// @details  Header-only library providing a compact binary encoding of
+///           arithmetic types, strings, vectors, and structs.
+/// @author   Nathan Lucas
+/// @date     2018
+//===========================================================================//
+#ifndef UTL_SERIALIZE_HPP
+#define UTL_SERIALIZE_HPP
+
+#ifndef __cplusplus
+#error must be compiled as C++
+#endif
+
+#include <utl/compile.hpp>  // UTL_FOR_EACH
+
+#include <array>        // std::array
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::int64_t, std::uint32_t, std::uint64_t
+#include <cstring>      // std::memcpy
+#include <limits>       // std::numeric_limits
+#include <string>       // std::string
+#include <type_traits>  // std::enable_if, std::is_enum, std::is_integral,
+                        // std::is_floating_point, std::is_signed,
+                        // std::underlying_type, std::conditional,
+                        // std::is_same
+#include <vector>       // std::vector
+
+/// @defgroup utl_serialize   serialize
+/// @brief    Binary serialization.
+/// @details  Header-only library providing a compact binary encoding of
+///   arithmetic types, strings, vectors, and structs.
+///
+/// The encoding is defined by specializations of utl::serialize:
+///
+/// Type                      | Encoding
+/// ------------------------- | ------------------------------------------
+/// `bool`                    | one byte, `0` or `1`
+/// unsigned integer          | varint:  7 bits per byte, low bits first
+/// signed integer            | zigzag varint, so small magnitudes are short
+/// enumeration               | as its underlying type
+/// `float`, `double`         | IEEE 754, little-endian, 4 or 8 bytes
+/// `std::string`             | varint length, then the characters
+/// `std::vector<T>`          | varint count, then the elements
+/// `std::array<T, N>`        | the elements
+/// struct (UTL_SERIALIZE)    | the listed members in order
+///
+/// There are no tags or field names, so both ends must agree on the type.
+///
+/// Example usage:
+/// ```
+///   struct quote
+///   {
+///     std::string         symbol;
+///     double              price;
+///     std::vector<int>    sizes;
+///   };
+///   UTL_SERIALIZE(quote, symbol, price, sizes)
+///
+///   std::string buf;
+///   utl::encode(buf, quote{ "ABC", 1.25, { 100, 200 } });
+///   quote q;
+///   bool ok = utl::decode(buf.data(), buf.size(), q);
+/// ```
+
+namespace utl {
+
+/// @addtogroup utl_serialize
+/// @{
+
+/// @brief  Binary encoding of type @a T.
+///
+/// A specialization provides:
+/// ```
+///   // Returns the encoded size of v in bytes.
+///   static std::size_t size(T const& v);
+///
+///   // Encodes v at out, which has room for size(v) bytes,
+///   // and returns the end of the encoding.
+///   static char* write(char* out, T const& v);
+///
+///   // Decodes v from [in, end) and returns the end of the encoding,
+///   // or nullptr if the data is truncated or malformed.
+///   static char const* read(char const* in, char const* end, T& v);
+/// ```
+/// Specialize for other types, or use UTL_SERIALIZE for structs.
+template<typename T, typename Enable=void>
+struct serialize;
+
+//---------------------------------------------------------------------------
+/// @name Encoding Functions
+/// @{
+
+/// Returns the encoded size of @a v in bytes.
+template<typename T>
+inline std::size_t
+encoded_size(T const& v)
+{
+  return serialize<T>::size(v);
+}
+
+/// @brief  Encodes @a v at @a out, which must have room for
+///         `encoded_size(v)` bytes.
+/// @return End of the encoding.
+template<typename T>
+inline char*
+encode(char* out, T const& v)
+{
+  return serialize<T>::write(out, v);
+}
+
+/// Appends the encoding of @a v to @a out.
+template<typename T>
+inline void
+encode(std::string& out, T const& v)
+{
+  std::size_t const n = out.size();
+  out.resize(n + serialize<T>::size(v));
+  serialize<T>::write(&out[n], v);
+}
+
+/// @brief  Decodes @a v from exactly @a size bytes at @a data.
+/// @return `false` if the data is truncated, malformed, or longer than
+///         the encoding, in which case @a v may be partly assigned.
+template<typename T>
+inline bool
+decode(char const* data, std::size_t size, T& v)
+{
+  return (serialize<T>::read(data, data + size, v) == (data + size));
+}
+
+/// @}
+//---------------------------------------------------------------------------
+
+/// @}
+
+namespace detail {  //-------------------------------------------------------
+
+inline std::size_t
+varint_size(std::uint64_t v)
+{
+  std::size_t n = 1;
+  while (v >= 0x80)
+  {
+    v >>= 7;
+    ++n;
+  }
+  return n;
+}
+
+inline char*
+write_varint(char* out, std::uint64_t v)
+{
+  while (v >= 0x80)
+  {
+    *out++ = static_cast<char>((v & 0x7F) | 0x80);
+    v >>= 7;
+  }
+  *out++ = static_cast<char>(v);
+  return out;
+}
+
+inline char const*
+read_varint(char const* in, char const* end, std::uint64_t& v)
+{
+  std::uint64_t result = 0;
+  for (unsigned shift = 0; (in != end) && (shift < 64); shift += 7)
+  {
+    std::uint64_t const b = static_cast<unsigned char>(*in++);
+    if ((shift == 63) && (b > 1)) { return nullptr; }   // over 64 bits
+    result |= ((b & 0x7F) << shift);
+    if ((b & 0x80) == 0)
+    {
+      v = result;
+      return in;
+    }
+  }
+  return nullptr;
+}
+
+inline std::uint64_t
+zigzag(std::int64_t v)
+{
+  return ((static_cast<std::uint64_t>(v) << 1) ^
+          static_cast<std::uint64_t>(v >> 63));
+}
+
+inline std::int64_t
+unzigzag(std::uint64_t v)
+{
+  return static_cast<std::int64_t>((v >> 1) ^ (~(v & 1) + 1));
+}
+
+// Unsigned integer of the same size as floating point type T.
+template<typename T>
+using float_bits = typename std::conditional<(sizeof(T) == 4),
+                                             std::uint32_t,
+                                             std::uint64_t>::type;
+
+} // detail -----------------------------------------------------------------
+
+
+/// @addtogroup utl_serialize
+/// @{
+
+//---------------------------------------------------------------------------
+/// @name Specializations
+/// @{
+
+/// One byte, `0` or `1`.
+template<>
+struct serialize<bool>
+{
+  static std::size_t
+  size(bool)                      { return 1; }
+
+  static char*
+  write(char* out, bool v)
+  {
+    *out = (v ? 1 : 0);
+    return (out + 1);
+  }
+
+  static char const*
+  read(char const* in, char const* end, bool& v)
+  {
+    if ((in == end) || (static_cast<unsigned char>(*in) > 1)) { return nullptr; }
+    v = (*in != 0);
+    return (in + 1);
+  }
+};
+
+/// Unsigned integers:  varint.
+template<typename T>
+struct serialize<T, typename std::enable_if<
+    std::is_integral<T>::value && !std::is_signed<T>::value &&
+    !std::is_same<T, bool>::value>::type>
+{
+  static std::size_t
+  size(T v)                       { return detail::varint_size(v); }
+
+  static char*
+  write(char* out, T v)           { return detail::write_varint(out, v); }
+
+  static char const*
+  read(char const* in, char const* end, T& v)
+  {
+    std::uint64_t u;
+    in = detail::read_varint(in, end, u);
+    if (!in || (u > std::numeric_limits<T>::max())) { return nullptr; }
+    v = static_cast<T>(u);
+    return in;
+  }
+};
+
+/// Signed integers:  zigzag varint.
+template<typename T>
+struct serialize<T, typename std::enable_if<
+    std::is_integral<T>::value && std::is_signed<T>::value>::type>
+{
+  static std::size_t
+  size(T v)           { return detail::varint_size(detail::zigzag(v)); }
+
+  static char*
+  write(char* out, T v)
+  {
+    return detail::write_varint(out, detail::zigzag(v));
+  }
+
+  static char const*
+  read(char const* in, char const* end, T& v)
+  {
+    std::uint64_t u;
+    in = detail::read_varint(in, end, u);
+    if (!in) { return nullptr; }
+    std::int64_t const i = detail::unzigzag(u);
+    if ((i < std::numeric_limits<T>::min()) ||
+        (i > std::numeric_limits<T>::max()))
+    {
+      return nullptr;
+    }
+    v = static_cast<T>(i);
+    return in;
+  }
+};
+
+/// Enumerations:  as the underlying type.
+template<typename T>
+struct serialize<T, typename std::enable_if<std::is_enum<T>::value>::type>
+{
+  using underlying = typename std::underlying_type<T>::type;
+
+  static std::size_t
+  size(T v)
+  {
+    return serialize<underlying>::size(static_cast<underlying>(v));
+  }
+
+  static char*
+  write(char* out, T v)
+  {
+    return serialize<underlying>::write(out, static_cast<underlying>(v));
+  }
+
+  static char const*
+  read(char const* in, char const* end, T& v)
+  {
+    underlying u;
+    in = serialize<underlying>::read(in, end, u);
+    if (in) { v = static_cast<T>(u); }
+    return in;
+  }
+};
+
+/// `float` and `double`:  IEEE 754, little-endian.
+template<typename T>
+struct serialize<T, typename std::enable_if<
+    std::is_floating_point<T>::value>::type>
+{
+  static_assert(std::numeric_limits<T>::is_iec559 &&
+                ((sizeof(T) == 4) || (sizeof(T) == 8)),
+                "requires IEEE 754 binary32 or binary64");
+
+  using bits_type = detail::float_bits<T>;
+
+  static std::size_t
+  size(T)                         { return sizeof(T); }
+
+  static char*
+  write(char* out, T v)
+  {
+    bits_type bits;
+    std::memcpy(&bits, &v, sizeof(T));
+    for (std::size_t i = 0; i != sizeof(T); ++i)
+    {
+      out[i] = static_cast<char>((bits >> (8 * i)) & 0xFF);
+    }
+    return (out + sizeof(T));
+  }
+
+  static char const*
+  read(char const* in, char const* end, T& v)
+  {
+    if (static_cast<std::size_t>(end - in) < sizeof(T)) { return nullptr; }
+    bits_type bits = 0;
+    for (std::size_t i = 0; i != sizeof(T); ++i)
+    {
+      bits |= (static_cast<bits_type>(static_cast<unsigned char>(in[i]))
+               << (8 * i));
+    }
+    std::memcpy(&v, &bits, sizeof(T));
+    return (in + sizeof(T));
+  }
+};
+
+/// `std::string`:  varint length, then the characters.
+template<>
+struct serialize<std::string>
+{
+  static std::size_t
+  size(std::string const& v)
+  {
+    return (detail::varint_size(v.size()) + v.size());
+  }
+
+  static char*
+  write(char* out, std::string const& v)
+  {
+    out = detail::write_varint(out, v.size());
+    if (!v.empty()) { std::memcpy(out, v.data(), v.size()); }
+    return (out + v.size());
+  }
+
+  static char const*
+  read(char const* in, char const* end, std::string& v)
+  {
+    std::uint64_t n;
+    in = detail::read_varint(in, end, n);
+    if (!in || (n > static_cast<std::uint64_t>(end - in))) { return nullptr; }
+    v.assign(in, static_cast<std::size_t>(n));
+    return (in + n);
+  }
+};
+
+/// `std::vector<T>`:  varint count, then the elements.
+template<typename T, typename Allocator>
+struct serialize<std::vector<T, Allocator>>
+{
+  static std::size_t
+  size(std::vector<T, Allocator> const& v)
+  {
+    std::size_t n = detail::varint_size(v.size());
+    for (auto const& x : v) { n += serialize<T>::size(x); }
+    return n;
+  }
+
+  static char*
+  write(char* out, std::vector<T, Allocator> const& v)
+  {
+    out = detail::write_varint(out, v.size());
+    for (auto const& x : v) { out = serialize<T>::write(out, x); }
+    return out;
+  }
+
+  static char const*
+  read(char const* in, char const* end, std::vector<T, Allocator>& v)
+  {
+    std::uint64_t n;
+    in = detail::read_varint(in, end, n);
+    // Every element takes at least one byte, which bounds the count
+    // before anything is allocated.
+    if (!in || (n > static_cast<std::uint64_t>(end - in))) { return nullptr; }
+    v.resize(static_cast<std::size_t>(n));
+    for (auto& x : v)
+    {
+      in = serialize<T>::read(in, end, x);
+      if (!in) { return nullptr; }
+    }
+    return in;
+  }
+};
+
+/// `std::vector<bool>`:  varint count, then one byte per element.
+template<typename Allocator>
+struct serialize<std::vector<bool, Allocator>>
+{
+  static std::size_t
+  size(std::vector<bool, Allocator> const& v)
+  {
+    return (detail::varint_size(v.size()) + v.size());
+  }
+
+  static char*
+  write(char* out, std::vector<bool, Allocator> const& v)
+  {
+    out = detail::write_varint(out, v.size());
+    for (bool x : v) { *out++ = (x ? 1 : 0); }
+    return out;
+  }
+
+  static char const*
+  read(char const* in, char const* end, std::vector<bool, Allocator>& v)
+  {
+    std::uint64_t n;
+    in = detail::read_varint(in, end, n);
+    if (!in || (n > static_cast<std::uint64_t>(end - in))) { return nullptr; }
+    v.resize(static_cast<std::size_t>(n));
+    for (std::size_t i = 0; i != v.size(); ++i)
+    {
+      bool x;
+      in = serialize<bool>::read(in, end, x);
+      if (!in) { return nullptr; }
+      v[i] = x;
+    }
+    return in;
+  }
+};
+
+/// `std::array<T, N>`:  the elements.
+template<typename T, std::size_t N>
+struct serialize<std::array<T, N>>
+{
+  static std::size_t
+  size(std::array<T, N> const& v)
+  {
+    std::size_t n = 0;
+    for (auto const& x : v) { n += serialize<T>::size(x); }
+    return n;
+  }
+
+  static char*
+  write(char* out, std::array<T, N> const& v)
+  {
+    for (auto const& x : v) { out = serialize<T>::write(out, x); }
+    return out;
+  }
+
+  static char const*
+  read(char const* in, char const* end, std::array<T, N>& v)
+  {
+    for (auto& x : v)
+    {
+      in = serialize<T>::read(in, end, x);
+      if (!in) { return nullptr; }
+    }
+    return in;
+  }
+};
+
+/// @}
+//---------------------------------------------------------------------------
+
+/// @}
+
+} // utl
+
+//---------------------------------------------------------------------------
+/// @ingroup  utl_serialize
+/// @brief    Defines utl::serialize for struct @a Type as the encodings
+///           of the listed members in order.
+///
+/// Use at global scope, with @a Type fully qualified.  Up to 32 members
+/// may be listed; each must itself be serializable, so structs nest.
+#define UTL_SERIALIZE(Type, ...) \
+  namespace utl { \
+  template<> \
+  struct serialize<Type> \
+  { \
+    static std::size_t \
+    size(Type const& v) \
+    { \
+      return (0 UTL_FOR_EACH(UTL_SERIALIZE_SIZE_, v, __VA_ARGS__)); \
+    } \
+    static char* \
+    write(char* out, Type const& v) \
+    { \
+      UTL_FOR_EACH(UTL_SERIALIZE_WRITE_, v, __VA_ARGS__) \
+      return out; \
+    } \
+    static char const* \
+    read(char const* in, char const* end, Type& v) \
+    { \
+      UTL_FOR_EACH(UTL_SERIALIZE_READ_, v, __VA_ARGS__) \
+      return in; \
+    } \
+  }; \
+  }
+
+/// @cond
+#define UTL_SERIALIZE_SIZE_(v, m) \
+  + ::utl::serialize<decltype(v.m)>::size(v.m)
+#define UTL_SERIALIZE_WRITE_(v, m) \
+  out = ::utl::serialize<decltype(v.m)>::write(out, v.m);
+#define UTL_SERIALIZE_READ_(v, m) \
+  in = ::utl::serialize<decltype(v.m)>::read(in, end, v.m); \
+  if (!in) { return nullptr; }
+/// @endcond
+
+#endif // UTL_SERIALIZE_HPP
+//===========================================================================//
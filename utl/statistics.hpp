@@ -0,0 +1,496 @@
+/*
+Licensed under the MIT License <http://opensource.org/licenses/MIT>
+
+Copyright 2018 Nathan Lucas <nathan.lucas@wayne.edu>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+//===========================================================================//
+/// @file
+/// @brief    Streaming statistics.
+/// @details  Header-only library providing accumulators that compute
+///           summary statistics one value at a time.
+/// @author   Nathan Lucas
+/// @date     2018
+//===========================================================================//
+#ifndef UTL_STATISTICS_HPP
+#define UTL_STATISTICS_HPP
+
+#ifndef __cplusplus
+#error must be compiled as C++
+#endif
+
+#include <array>        // std::array
+#include <cmath>        // std::isnan, std::sqrt
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint64_t
+#include <limits>       // std::numeric_limits
+#include <ostream>      // std::ostream
+#include <stdexcept>    // std::invalid_argument
+#include <string>       // std::string, std::to_string
+#include <type_traits>  // std::is_arithmetic, std::is_integral
+
+/// @ingroup  utl_container
+/// @defgroup utl_statistics  statistics
+/// @brief    Streaming statistics utility library.
+/// @details  Header-only library providing accumulators that compute
+///   summary statistics one value at a time, without storing the values.
+///
+/// Like utl::Summation, each accumulator has an `add()` function and
+/// non-member `operator<<` and `csv()` overloads.  Accumulators other
+/// than utl::exponential_average also have a `merge()` function, so
+/// each thread can accumulate into its own instance and the instances
+/// can be combined afterward.
+
+namespace utl {
+
+/// @addtogroup utl_statistics
+/// @{
+
+//---------------------------------------------------------------------------
+/// @brief  Running count, mean, variance, minimum, and maximum.
+/// @tparam T   Numeric type of values.
+///
+/// Mean and variance are updated with Welford's algorithm, which avoids
+/// the loss of precision of accumulating a sum of squares.  Instances
+/// are combined with the parallel algorithm of Chan et al.
+template<typename T>
+class running_stats
+{
+public:
+
+  static_assert(std::is_arithmetic<T>::value, "T must be numeric");
+
+  /// Adds a value.
+  void
+  add(T val)
+  {
+    double x = static_cast<double>(val);
+    if ((count_ == 0) || (val < min_)) { min_ = val; }
+    if ((count_ == 0) || (val > max_)) { max_ = val; }
+    ++count_;
+    double delta = x - mean_;
+    mean_ += delta / count_;
+    m2_   += delta * (x - mean_);
+  }
+
+  /// Combines values accumulated by @a other into this object.
+  void
+  merge(running_stats const& other)
+  {
+    if (other.count_ == 0) { return; }
+    if (count_ == 0)       { *this = other; return; }
+    double n_a = static_cast<double>(count_);
+    double n_b = static_cast<double>(other.count_);
+    double n   = n_a + n_b;
+    double delta = other.mean_ - mean_;
+    mean_ += delta * (n_b / n);
+    m2_   += other.m2_ + (delta * delta * ((n_a * n_b) / n));
+    count_ += other.count_;
+    if (other.min_ < min_) { min_ = other.min_; }
+    if (other.max_ > max_) { max_ = other.max_; }
+  }
+
+  /// Clears all accumulated values.
+  void
+  clear()     { *this = running_stats(); }
+
+  /// Returns the number of values added.
+  std::uint64_t
+  count() const     { return count_; }
+
+  /// Returns the arithmetic mean, or `0` if no values have been added.
+  double
+  mean() const      { return mean_; }
+
+  /// Returns the population variance, or `0` if no values have been added.
+  double
+  variance() const  { return ((count_ > 0) ? (m2_ / count_) : 0.0); }
+
+  /// Returns the sample variance, or `0` if fewer than two values
+  /// have been added.
+  double
+  sample_variance() const
+  {
+    return ((count_ > 1) ? (m2_ / (count_ - 1)) : 0.0);
+  }
+
+  /// Returns the population standard deviation.
+  double
+  stddev() const    { return std::sqrt(variance()); }
+
+  /// Returns the smallest value added, or `0` if no values have been added.
+  T
+  min() const       { return min_; }
+
+  /// Returns the largest value added, or `0` if no values have been added.
+  T
+  max() const       { return max_; }
+
+private:
+  std::uint64_t count_{0};
+  double        mean_{0};
+  double        m2_{0};     // sum of squared differences from the mean
+  T             min_{0};
+  T             max_{0};
+};
+
+//---------------------------------------------------------------------------
+/// @brief  Exponential moving average.
+/// @tparam T   Numeric type of values.
+///
+/// Each value added moves the average toward that value by the fraction
+/// @a alpha given to the constructor.  The first value initializes the
+/// average.  Unlike the other accumulators, an exponential moving average
+/// depends on the order of its values and cannot be merged.
+template<typename T>
+class exponential_average
+{
+public:
+
+  static_assert(std::is_arithmetic<T>::value, "T must be numeric");
+
+  /// @brief  Constructor.
+  /// @param  [in]  alpha   Smoothing factor in the interval `(0, 1]`.
+  explicit
+  exponential_average(double alpha)
+  : alpha_(alpha)
+  {}
+
+  /// Adds a value.
+  void
+  add(T val)
+  {
+    double x = static_cast<double>(val);
+    value_ = ((count_ == 0) ? x : (value_ + (alpha_ * (x - value_))));
+    ++count_;
+  }
+
+  /// Clears all accumulated values.
+  void
+  clear()     { count_ = 0; value_ = 0; }
+
+  /// Returns the number of values added.
+  std::uint64_t
+  count() const     { return count_; }
+
+  /// Returns the smoothing factor.
+  double
+  alpha() const     { return alpha_; }
+
+  /// Returns the average, or `0` if no values have been added.
+  double
+  value() const     { return value_; }
+
+private:
+  double        alpha_;
+  std::uint64_t count_{0};
+  double        value_{0};
+};
+
+//---------------------------------------------------------------------------
+/// @brief  Fixed-memory histogram for estimating quantiles.
+/// @tparam T         Integral type of values.
+/// @tparam SubBits   Base-2 logarithm of the number of buckets per
+///                   power of two.
+///
+/// Values are counted in log-linear buckets, in the manner of an HDR
+/// histogram:  values below `2^SubBits` each have their own bucket, and
+/// every power-of-two range above that is split into `2^SubBits` equal
+/// buckets, each `2^-SubBits` as wide as its lower bound.  A quantile is
+/// reported as a bucket midpoint, so it is within a relative error of
+/// `2^-(SubBits+1)` (about 1.6% for the default), using a fixed amount
+/// of memory and no allocation.  Negative values are counted as `0`.
+///
+/// Floating-point measurements should be scaled to an integral unit
+/// (e.g., microseconds) before being added.
+template<typename T, unsigned SubBits = 5>
+class quantile_histogram
+{
+public:
+
+  static_assert(std::is_integral<T>::value, "T must be an integer type");
+  static_assert((SubBits > 0) && (SubBits < 16), "SubBits out of range");
+
+  /// Number of buckets.
+  static constexpr std::size_t bucket_count = ((65 - SubBits) << SubBits);
+
+  /// Adds a value.
+  void
+  add(T val)    { add(val, 1); }
+
+  /// Adds @a n occurrences of a value.
+  void
+  add(T val, std::uint64_t n)
+  {
+    std::uint64_t v = ((val > 0) ? static_cast<std::uint64_t>(val) : 0);
+    if ((count_ == 0) || (v < min_)) { min_ = v; }
+    if ((count_ == 0) || (v > max_)) { max_ = v; }
+    counts_[index(v)] += n;
+    count_ += n;
+  }
+
+  /// Combines values accumulated by @a other into this object.
+  void
+  merge(quantile_histogram const& other)
+  {
+    if (other.count_ == 0) { return; }
+    for (std::size_t i = 0; i != bucket_count; ++i)
+    {
+      counts_[i] += other.counts_[i];
+    }
+    if ((count_ == 0) || (other.min_ < min_)) { min_ = other.min_; }
+    if ((count_ == 0) || (other.max_ > max_)) { max_ = other.max_; }
+    count_ += other.count_;
+  }
+
+  /// Clears all accumulated values.
+  void
+  clear()
+  {
+    counts_.fill(0);
+    count_ = 0;
+    min_ = 0;
+    max_ = 0;
+  }
+
+  /// Returns the number of values added.
+  std::uint64_t
+  count() const     { return count_; }
+
+  /// Returns the smallest value added, or `0` if no values have been added.
+  T
+  min() const       { return static_cast<T>(min_); }
+
+  /// Returns the largest value added, or `0` if no values have been added.
+  T
+  max() const       { return static_cast<T>(max_); }
+
+  /// @brief  Estimates a quantile.
+  /// @param  [in]  q   Quantile in the interval `[0, 1]` (e.g., `0.99`).
+  /// @return Midpoint of the bucket containing the quantile, limited to
+  ///         the smallest and largest values added; or `0` if no values
+  ///         have been added.
+  /// @throw  std::invalid_argument if @a q is NaN.
+  ///
+  /// Values of @a q outside `[0, 1]` are clamped.
+  T
+  quantile(double q) const
+  {
+    if (std::isnan(q))
+    {
+      throw std::invalid_argument("utl::quantile_histogram: quantile is NaN");
+    }
+    if (count_ == 0) { return 0; }
+    if (q <= 0) { return min(); }
+    if (q >= 1) { return max(); }
+    // Rank of the requested value, counting from 1.
+    std::uint64_t rank = static_cast<std::uint64_t>(std::ceil(q * count_));
+    if (rank == 0) { rank = 1; }
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i != bucket_count; ++i)
+    {
+      seen += counts_[i];
+      if (seen >= rank)
+      {
+        std::uint64_t lo = lower(i);
+        std::uint64_t v  = lo + ((upper(i) - lo) / 2);
+        if (v < min_) { v = min_; }
+        if (v > max_) { v = max_; }
+        return static_cast<T>(v);
+      }
+    }
+    return max();
+  }
+
+  /// Returns the count in bucket @a i.
+  std::uint64_t
+  bucket(std::size_t i) const   { return counts_[i]; }
+
+  /// Returns the smallest value counted in bucket @a i.
+  static std::uint64_t
+  lower(std::size_t i)
+  {
+    std::size_t const sub = (std::size_t(1) << SubBits);
+    if (i < sub) { return i; }
+    unsigned shift = static_cast<unsigned>((i >> SubBits) - 1);
+    return (static_cast<std::uint64_t>(sub + (i & (sub - 1))) << shift);
+  }
+
+  /// Returns the largest value counted in bucket @a i.
+  static std::uint64_t
+  upper(std::size_t i)
+  {
+    return ((i + 1) < bucket_count) ? (lower(i + 1) - 1)
+                                    : std::numeric_limits<std::uint64_t>::max();
+  }
+
+  /// Returns the index of the bucket in which value @a v is counted.
+  static std::size_t
+  index(std::uint64_t v)
+  {
+    std::uint64_t const sub = (std::uint64_t(1) << SubBits);
+    if (v < sub) { return static_cast<std::size_t>(v); }
+    unsigned shift = msb(v) - SubBits;  // position within power of two
+    return static_cast<std::size_t>(((shift + 1) << SubBits) +
+                                    ((v >> shift) - sub));
+  }
+
+private:
+
+  // Returns the position of the most significant bit set in v > 0.
+  static unsigned
+  msb(std::uint64_t v)
+  {
+#if defined(__GNUC__)
+    return (63 - __builtin_clzll(v));
+#else
+    unsigned n = 0;
+    while (v >>= 1) { ++n; }
+    return n;
+#endif
+  }
+
+  std::array<std::uint64_t, bucket_count> counts_{};
+  std::uint64_t count_{0};
+  std::uint64_t min_{0};
+  std::uint64_t max_{0};
+};
+
+template<typename T, unsigned SubBits>
+constexpr std::size_t quantile_histogram<T, SubBits>::bucket_count;
+
+//---------------------------------------------------------------------------
+
+/// @name     Non-member function overloads
+/// @{
+
+/// @brief    Insert into output stream.
+/// @relates  utl::running_stats
+///
+/// Inserts accumulated values from @a rs into stream @a os in the format:
+///
+///     Mean[N] = M, SD = S, Min = A, Max = B
+///
+/// where `N` is the number of values, `M` is the mean, `S` is the
+/// population standard deviation, and `A` and `B` are the smallest
+/// and largest values.
+template<typename T>
+inline std::ostream&
+operator<<(std::ostream& os, utl::running_stats<T> const& rs)
+{
+  return os << "Mean[" << rs.count() << "] = " << rs.mean()
+            << ", SD = " << rs.stddev()
+            << ", Min = " << rs.min() << ", Max = " << rs.max();
+}
+
+/// @brief    Serialize to string in comma separated value (CSV) format.
+/// @relates  utl::running_stats
+///
+/// Returns a string containing accumulated values from @a rs:
+///
+///     N,M,S,A,B
+///
+/// where `N` is the number of values, `M` is the mean, `S` is the
+/// population standard deviation, and `A` and `B` are the smallest
+/// and largest values.
+template<typename T>
+inline std::string
+csv(utl::running_stats<T> const& rs)
+{
+  return (std::to_string(rs.count()) + "," + std::to_string(rs.mean()) +
+          "," + std::to_string(rs.stddev()) + "," +
+          std::to_string(rs.min()) + "," + std::to_string(rs.max()));
+}
+
+/// @brief    Insert into output stream.
+/// @relates  utl::exponential_average
+///
+/// Inserts the average of @a ea into stream @a os in the format:
+///
+///     EMA[N] = V
+///
+/// where `N` is the number of values and `V` is the average.
+template<typename T>
+inline std::ostream&
+operator<<(std::ostream& os, utl::exponential_average<T> const& ea)
+{
+  return os << "EMA[" << ea.count() << "] = " << ea.value();
+}
+
+/// @brief    Serialize to string in comma separated value (CSV) format.
+/// @relates  utl::exponential_average
+///
+/// Returns a string `N,V`, where `N` is the number
+/// of values and `V` is the average.
+template<typename T>
+inline std::string
+csv(utl::exponential_average<T> const& ea)
+{
+  return (std::to_string(ea.count()) + "," + std::to_string(ea.value()));
+}
+
+/// @brief    Insert into output stream.
+/// @relates  utl::quantile_histogram
+///
+/// Inserts quantiles estimated by @a qh into stream @a os in the format:
+///
+///     Quantile[N] p50 = A, p90 = B, p99 = C, p99.9 = D, max = E
+///
+/// where `N` is the number of values.
+template<typename T, unsigned SubBits>
+inline std::ostream&
+operator<<(std::ostream& os, utl::quantile_histogram<T, SubBits> const& qh)
+{
+  return os << "Quantile[" << qh.count() << "] p50 = " << qh.quantile(0.5)
+            << ", p90 = " << qh.quantile(0.9)
+            << ", p99 = " << qh.quantile(0.99)
+            << ", p99.9 = " << qh.quantile(0.999)
+            << ", max = " << qh.max();
+}
+
+/// @brief    Serialize to string in comma separated value (CSV) format.
+/// @relates  utl::quantile_histogram
+///
+/// Returns a string containing quantiles estimated by @a qh:
+///
+///     N,A,B,C,D,E
+///
+/// where `N` is the number of values, `A`, `B`, `C`, and `D` are the
+/// 50th, 90th, 99th, and 99.9th percentiles, and `E` is the largest value.
+template<typename T, unsigned SubBits>
+inline std::string
+csv(utl::quantile_histogram<T, SubBits> const& qh)
+{
+  return (std::to_string(qh.count()) + "," +
+          std::to_string(qh.quantile(0.5)) + "," +
+          std::to_string(qh.quantile(0.9)) + "," +
+          std::to_string(qh.quantile(0.99)) + "," +
+          std::to_string(qh.quantile(0.999)) + "," +
+          std::to_string(qh.max()));
+}
+
+/// @}
+
+/// @}
+
+//---------------------------------------------------------------------------
+} // utl
+#endif // UTL_STATISTICS_HPP
+//===========================================================================//
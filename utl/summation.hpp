@@ -35,8 +35,12 @@ SOFTWARE.
 #error must be compiled as C++
 #endif
 
+#include <array>      // std::array
+#include <atomic>     // std::atomic
+#include <cstddef>    // std::size_t
 #include <cstdint>    // std::uint_fast32_t, std::uint_fast64_t
 #include <ostream>    // std::ostream
+#include <string>     // std::string, std::to_string
 
 //---------------------------------------------------------------------------
 // Integer capacity for distance
@@ -93,6 +97,15 @@ class Summation
 {
 public:
 
+  /// Constructs an empty running total.
+  Summation() = default;
+
+  /// Constructs a running total from a count and sum total.
+  Summation(std::uint_fast32_t count, std::uint_fast64_t sum)
+  : count_(count)
+  , sum_(sum)
+  {}
+
   /// Adds a value to the sum total and increments the count.
   void
   add(std::uint_fast32_t val)
@@ -114,6 +127,92 @@ private:
   std::uint_fast64_t  sum_{0};
 };
 
+//---------------------------------------------------------------------------
+/// @brief  Running total shared by multiple threads.
+/// @tparam Shards  Number of per-thread slots.
+///
+/// Each thread adds to its own slot, so threads updating the same
+/// running total do not contend for a lock or a cache line.  Slots are
+/// assigned to threads in order of first use; when there are more threads
+/// than @a Shards, threads share slots safely at some cost in contention.
+/// The slots are combined into a utl::Summation by `snapshot()`, which may
+/// be called from any thread at any time.
+///
+/// Example usage:
+/// ```
+///   utl::sharded_summation<> total;    // shared
+///   total.add(val);                    // from any thread
+///   std::cout << total.snapshot();     // Sum[N] = S
+/// ```
+template<std::size_t Shards = 16>
+class sharded_summation
+{
+public:
+
+  static_assert(Shards > 0, "Shards must be positive");
+
+  /// Constructs an empty running total.
+  sharded_summation() = default;
+
+  // Atomics are not copyable, so copies are already forbidden.
+
+  /// @brief  Adds a value to the sum total and increments the count.
+  ///
+  /// Safe to call concurrently from any number of threads.
+  void
+  add(std::uint_fast32_t val)
+  {
+    slot& s = slots_[thread_index() % Shards];
+    s.count.fetch_add(1, std::memory_order_relaxed);
+    s.sum.fetch_add(val, std::memory_order_relaxed);
+  }
+
+  /// @brief  Returns the count and sum total of values added so far.
+  ///
+  /// Values added concurrently with this call may or may not be included.
+  utl::Summation
+  snapshot() const
+  {
+    std::uint_fast64_t count = 0;
+    std::uint_fast64_t sum   = 0;
+    for (slot const& s : slots_)
+    {
+      count += s.count.load(std::memory_order_relaxed);
+      sum   += s.sum.load(std::memory_order_relaxed);
+    }
+    return utl::Summation(static_cast<std::uint_fast32_t>(count), sum);
+  }
+
+  /// Returns the numerical count of values added via `add()`.
+  std::uint_fast32_t
+  count() const       { return snapshot().count(); }
+
+  /// Returns the sum total of values added via `add()`.
+  std::uint_fast64_t
+  sum() const      { return snapshot().sum(); }
+
+private:
+
+  // One slot per cache line to prevent false sharing between threads.
+  struct alignas(64) slot
+  {
+    std::atomic<std::uint_fast64_t> count{0};
+    std::atomic<std::uint_fast64_t> sum{0};
+  };
+
+  // Index assigned to the calling thread on its first call.
+  static std::size_t
+  thread_index()
+  {
+    static std::atomic<std::size_t> next{0};
+    thread_local std::size_t index =
+        next.fetch_add(1, std::memory_order_relaxed);
+    return index;
+  }
+
+  std::array<slot, Shards> slots_{};
+};
+
 //---------------------------------------------------------------------------
 
 /// @name     Non-member function overloads
@@ -148,6 +247,27 @@ csv(utl::Summation const& sm)
   return (std::to_string(sm.count()) + "," + std::to_string(sm.sum()));
 }
 
+/// @brief    Insert into output stream.
+///
+/// Inserts a snapshot of @a sm into stream @a os in
+/// the same format as utl::Summation.
+template<std::size_t Shards>
+inline std::ostream&
+operator<<(std::ostream& os, utl::sharded_summation<Shards> const& sm)
+{
+  return os << sm.snapshot();
+}
+
+/// @brief  Serialize to string in comma separated value (CSV) format.
+///
+/// Returns a snapshot of @a sm in the same format as utl::Summation.
+template<std::size_t Shards>
+inline std::string
+csv(utl::sharded_summation<Shards> const& sm)
+{
+  return utl::csv(sm.snapshot());
+}
+
 /// @}
 
 /// @}